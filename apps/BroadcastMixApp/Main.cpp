@@ -39,7 +39,9 @@ public:
     void initialise(const juce::String&) override {
         coreApp_ = std::make_unique<broadcastmix::core::Application>(
             broadcastmix::core::ApplicationConfig {},
-            broadcastmix::audio::AudioEngineSettings {});
+            broadcastmix::audio::AudioEngineSettings {
+                .workerThreads = static_cast<std::uint32_t>(juce::jlimit(0, 3, juce::SystemStats::getNumPhysicalCpus() - 1)),
+            });
 
         coreApp_->initialize();
         coreApp_->startRealtimeEngine();
@@ -559,8 +559,12 @@ void MainComponent::switchToMicroView(const std::string& nodeId,
     graphComponent_.setNodeDragHandler([this, effectiveNodeId](const std::string& childNode, float normX, float normY) {
         app_.updateMicroNodePosition(effectiveNodeId, childNode, normX, normY);
     });
-    graphComponent_.setMeterProvider([this, effectiveNodeId](const std::string& childNode) {
-        return app_.meterLevelForMicroNode(effectiveNodeId, childNode);
+    graphComponent_.setMeterSource({
+        .handleForNode = [this, effectiveNodeId](const std::string& childNode) {
+            return app_.meterHandleForMicroNode(effectiveNodeId, childNode);
+        },
+        .layoutVersion = [this] { return app_.meterLayoutVersion(); },
+        .readMeters = [this](audio::MeterSnapshot& snapshot) { app_.readMeters(snapshot); },
     });
     graphComponent_.setConnectNodesHandler([this, effectiveNodeId](const std::string& fromId, const std::string& toId) {
         std::cout << "[MainComponent] connect handler node=" << effectiveNodeId << " from=" << fromId << " to=" << toId << std::endl;
@@ -794,8 +798,10 @@ void MainComponent::switchToMacroView() {
     graphComponent_.setNodeDragHandler([this](const std::string& nodeId, float normX, float normY) {
         app_.updateMacroNodePosition(nodeId, normX, normY);
     });
-    graphComponent_.setMeterProvider([this](const std::string& nodeId) {
-        return app_.meterLevelForNode(nodeId);
+    graphComponent_.setMeterSource({
+        .handleForNode = [this](const std::string& nodeId) { return app_.meterHandleForNode(nodeId); },
+        .layoutVersion = [this] { return app_.meterLayoutVersion(); },
+        .readMeters = [this](audio::MeterSnapshot& snapshot) { app_.readMeters(snapshot); },
     });
     graphComponent_.setConnectNodesHandler([this](const std::string& fromId, const std::string& toId) {
         if (app_.connectNodes(fromId, toId)) {
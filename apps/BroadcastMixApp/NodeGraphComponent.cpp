@@ -142,7 +142,15 @@ void NodeGraphComponent::paint(juce::Graphics& g) {
         return bounds.getY() + fraction * bounds.getHeight();
     };
 
-    for (const auto& nodeVisual : view_->nodes()) {
+    const bool showMeters = static_cast<bool>(meterSource_.readMeters);
+    if (showMeters) {
+        refreshMeterHandles();
+        meterSource_.readMeters(meterSnapshot_);
+    }
+
+    const auto& nodeVisuals = view_->nodes();
+    for (std::size_t nodeIndex = 0; nodeIndex < nodeVisuals.size(); ++nodeIndex) {
+        const auto& nodeVisual = nodeVisuals[nodeIndex];
         const auto posIt = cachedPositions_.find(nodeVisual.id);
         if (posIt == cachedPositions_.end()) {
             continue;
@@ -309,9 +317,14 @@ void NodeGraphComponent::paint(juce::Graphics& g) {
             g.drawRoundedRectangle(nodeBounds.expanded(6.0F), kCornerRadius + 6.0F, 2.5F);
         }
 
-        if (meterProvider_ && nodeVisual.enabled) {
-            const auto levels = meterProvider_(nodeVisual.id);
-            const auto level = std::clamp(std::max(levels[0], levels[1]), 0.0F, 1.0F);
+        if (showMeters && nodeVisual.enabled) {
+            const auto handle = nodeIndex < meterHandles_.size() ? meterHandles_[nodeIndex] : audio::kInvalidMeterHandle;
+            float level = 0.0F;
+            if (handle < meterSnapshot_.ranges.size()) {
+                const auto range = meterSnapshot_.ranges[handle];
+                const auto first = meterSnapshot_.levels.begin() + range.firstChannel;
+                level = range.numChannels > 0 ? std::clamp(*std::max_element(first, first + range.numChannels), 0.0F, 1.0F) : 0.0F;
+            }
             const auto meterWidth = 10.0F;
             const auto meterMargin = 6.0F;
             juce::Rectangle<float> meterBounds {
@@ -456,7 +469,7 @@ void NodeGraphComponent::timerCallback() {
         return;
     }
 
-    if (meterProvider_) {
+    if (meterSource_.readMeters) {
         repaint();
     }
 }
@@ -1062,14 +1075,34 @@ void NodeGraphComponent::setNodeDragHandler(std::function<void(const std::string
     onNodeDragged_ = std::move(handler);
 }
 
-void NodeGraphComponent::setMeterProvider(std::function<std::array<float, 2>(const std::string&)> provider) {
-    meterProvider_ = std::move(provider);
+void NodeGraphComponent::setMeterSource(MeterSource source) {
+    meterSource_ = std::move(source);
+    meterHandlesViewVersion_ = std::numeric_limits<std::size_t>::max();
+    meterHandlesStoreVersion_ = std::numeric_limits<std::uint64_t>::max();
+}
+
+void NodeGraphComponent::refreshMeterHandles() {
+    const auto viewVersion = view_->layoutVersion();
+    const auto storeVersion = meterSource_.layoutVersion ? meterSource_.layoutVersion() : 0;
+    if (viewVersion == meterHandlesViewVersion_ && storeVersion == meterHandlesStoreVersion_) {
+        return;
+    }
+
+    meterHandlesViewVersion_ = viewVersion;
+    meterHandlesStoreVersion_ = storeVersion;
+    meterHandles_.clear();
+    meterHandles_.reserve(view_->nodes().size());
+    for (const auto& nodeVisual : view_->nodes()) {
+        meterHandles_.push_back(meterSource_.handleForNode ? meterSource_.handleForNode(nodeVisual.id)
+                                                           : audio::kInvalidMeterHandle);
+    }
 }
 
 void NodeGraphComponent::setGraphView(ui::NodeGraphView* view) {
     commitInlineRename(false);
     view_ = view;
     lastLayoutVersion_ = 0;
+    meterHandlesViewVersion_ = std::numeric_limits<std::size_t>::max();
     draggingNodeId_.reset();
     selectedNodeId_.reset();
     draggingPort_.reset();
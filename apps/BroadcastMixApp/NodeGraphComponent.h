@@ -2,6 +2,7 @@
 
 #include <juce_gui_extra/juce_gui_extra.h>
 
+#include <audio/AudioEngine.h>
 #include <ui/NodeGraphView.h>
 
 #include <cstddef>
@@ -29,6 +30,14 @@ public:
         std::optional<std::pair<std::string, std::string>> insertBetween;
     };
 
+    // Handles are resolved only when either layout changes; each repaint then reads every
+    // meter with one bulk copy.
+    struct MeterSource {
+        std::function<audio::MeterHandle(const std::string&)> handleForNode;
+        std::function<std::uint64_t()> layoutVersion;
+        std::function<void(audio::MeterSnapshot&)> readMeters;
+    };
+
     explicit NodeGraphComponent(ui::NodeGraphView* view);
 
     void paint(juce::Graphics& g) override;
@@ -43,7 +52,7 @@ public:
 
     void setNodeDoubleClickHandler(std::function<void(const std::string&)> handler);
     void setNodeDragHandler(std::function<void(const std::string&, float, float)> handler);
-    void setMeterProvider(std::function<std::array<float, 2>(const std::string&)> provider);
+    void setMeterSource(MeterSource source);
     void setGraphView(ui::NodeGraphView* view);
     void setConnectNodesHandler(std::function<void(const std::string&, const std::string&)> handler);
     void setDisconnectNodesHandler(std::function<void(const std::string&, const std::string&)> handler);
@@ -106,6 +115,7 @@ private:
     [[nodiscard]] juce::Colour toColour(const ui::Color& color) const;
     [[nodiscard]] juce::Colour nodeFillColour(audio::GraphNodeType type) const;
     void refreshCachedPositions(bool force = false);
+    void refreshMeterHandles();
     [[nodiscard]] juce::Rectangle<float> computeLayoutArea() const;
     [[nodiscard]] juce::Rectangle<float> nodeBoundsForPosition(const juce::Point<float>& position) const;
     [[nodiscard]] std::optional<std::string> hitTestNode(const juce::Point<float>& position) const;
@@ -153,7 +163,11 @@ private:
     float zoomLevel_ { 1.0F };
     std::function<void(const std::string&)> onNodeDoubleClicked_;
     std::function<void(const std::string&, float, float)> onNodeDragged_;
-    std::function<std::array<float, 2>(const std::string&)> meterProvider_;
+    MeterSource meterSource_;
+    std::vector<audio::MeterHandle> meterHandles_;
+    audio::MeterSnapshot meterSnapshot_;
+    std::size_t meterHandlesViewVersion_ { std::numeric_limits<std::size_t>::max() };
+    std::uint64_t meterHandlesStoreVersion_ { std::numeric_limits<std::uint64_t>::max() };
     std::function<void(const std::string&, const std::string&)> onConnectNodes_;
     std::function<void(const std::string&, const std::string&)> onDisconnectNodes_;
     std::function<void(const std::optional<std::string>&)> onSelectionChanged_;
@@ -0,0 +1,128 @@
+#include "audio/AudioEngine.h"
+#include "audio/GraphTopology.h"
+#include "audio/RenderPlan.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+namespace {
+
+using namespace broadcastmix::audio;
+
+// 64 mono inputs through channel strips into 8 stereo groups, summed to broadcast and monitor buses.
+GraphTopology createLargeTopology(std::uint32_t inputCount) {
+    GraphTopology topology;
+    constexpr std::uint32_t kGroupCount = 8;
+
+    const auto stereo = [](GraphNode& node) {
+        node.setInputChannelCount(2);
+        node.setOutputChannelCount(2);
+    };
+    const auto connectStereo = [&](const std::string& from, const std::string& to) {
+        for (std::uint32_t channel = 0; channel < 2; ++channel) {
+            topology.connect({ .fromNodeId = from, .fromChannel = channel, .toNodeId = to, .toChannel = channel });
+        }
+    };
+
+    GraphNode input("hardware_input", GraphNodeType::Input);
+    input.setOutputChannelCount(inputCount);
+    topology.addNode(std::move(input));
+
+    for (std::uint32_t group = 0; group < kGroupCount; ++group) {
+        GraphNode node("group_" + std::to_string(group), GraphNodeType::GroupBus);
+        stereo(node);
+        topology.addNode(std::move(node));
+    }
+
+    for (std::uint32_t index = 0; index < inputCount; ++index) {
+        const auto id = "channel_" + std::to_string(index);
+        GraphNode channel(id, GraphNodeType::Channel);
+        channel.setInputChannelCount(1);
+        channel.setOutputChannelCount(2);
+        topology.addNode(std::move(channel));
+        topology.connect({ .fromNodeId = "hardware_input", .fromChannel = index, .toNodeId = id, .toChannel = 0 });
+        connectStereo(id, "group_" + std::to_string(index % kGroupCount));
+    }
+
+    GraphNode broadcastBus("broadcast_bus", GraphNodeType::BroadcastBus);
+    stereo(broadcastBus);
+    topology.addNode(std::move(broadcastBus));
+
+    GraphNode monitorTrim("monitor_trim", GraphNodeType::Utility);
+    monitorTrim.setLabel("Monitor Trim -3 dB");
+    stereo(monitorTrim);
+    topology.addNode(std::move(monitorTrim));
+
+    GraphNode broadcastOutput("broadcast_output", GraphNodeType::Output);
+    broadcastOutput.setInputChannelCount(2);
+    topology.addNode(std::move(broadcastOutput));
+
+    for (std::uint32_t group = 0; group < kGroupCount; ++group) {
+        connectStereo("group_" + std::to_string(group), "broadcast_bus");
+    }
+    connectStereo("broadcast_bus", "monitor_trim");
+    connectStereo("monitor_trim", "broadcast_output");
+    return topology;
+}
+
+double measure(AudioGraphBackend backend,
+               std::uint32_t workerThreads,
+               const GraphTopology& topology,
+               std::uint64_t lengthInSamples) {
+    AudioEngineSettings settings;
+    settings.graphBackend = backend;
+    settings.workerThreads = workerThreads;
+    settings.inputChannels = 64;
+    settings.outputChannels = 2;
+
+    AudioEngine engine(settings);
+    engine.setTopology(std::make_shared<GraphTopology>(topology));
+
+    OfflineRenderRequest request;
+    request.lengthInSamples = lengthInSamples;
+    request.collectOutput = false;
+
+    // First pass warms caches and lets the processors settle; only the second one is reported.
+    (void) engine.renderOffline(request);
+    const auto result = engine.renderOffline(request);
+    if (!result.success) {
+        std::fprintf(stderr, "render failed: %s\n", result.error.c_str());
+        std::exit(EXIT_FAILURE);
+    }
+    return result.realtimeFactor;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::uint32_t inputCount = argc > 1 ? static_cast<std::uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 64;
+    const std::uint64_t seconds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 60;
+    const std::uint32_t workerThreads = argc > 3 ? static_cast<std::uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 3;
+    const auto topology = createLargeTopology(inputCount);
+
+    RenderPlanOptions options;
+    options.hardwareInputs = 64;
+    options.hardwareOutputs = 2;
+    options.isPassThrough = [](const GraphNode& node) {
+        return node.type() != GraphNodeType::Utility;
+    };
+    const auto plan = RenderPlan::compile(topology, options);
+    std::printf("topology: %zu nodes, %zu connections\n", topology.nodes().size(), topology.connections().size());
+    std::printf("plan: %u scratch buffers for %u channels, %u aliased, %zu mix ops\n",
+                plan.bufferCount,
+                plan.totalChannels,
+                plan.aliasedChannels,
+                plan.mixes.size());
+
+    const auto lengthInSamples = seconds * 48000;
+    const auto graphFactor = measure(AudioGraphBackend::ProcessorGraph, 0, topology, lengthInSamples);
+    const auto planFactor = measure(AudioGraphBackend::CompiledPlan, 0, topology, lengthInSamples);
+    const auto parallelFactor = measure(AudioGraphBackend::CompiledPlan, workerThreads, topology, lengthInSamples);
+    std::printf("juce::AudioProcessorGraph: %.1fx realtime\n", graphFactor);
+    std::printf("compiled render plan:      %.1fx realtime\n", planFactor);
+    std::printf("compiled, %u workers:      %.1fx realtime\n", workerThreads, parallelFactor);
+    std::printf("speedup:                   %.2fx\n", graphFactor > 0.0 ? planFactor / graphFactor : 0.0);
+    return 0;
+}
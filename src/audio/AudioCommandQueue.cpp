@@ -0,0 +1,51 @@
+#include "AudioCommandQueue.h"
+
+namespace broadcastmix::audio {
+
+AudioCommandQueue::AudioCommandQueue() = default;
+AudioCommandQueue::~AudioCommandQueue() = default;
+
+bool AudioCommandQueue::push(const AudioCommand& command, std::shared_ptr<const void> lease) {
+    const auto write = writeIndex_.load(std::memory_order_relaxed);
+    if (write - readIndex_.load(std::memory_order_acquire) >= kCapacity) {
+        return false;
+    }
+
+    const auto slot = static_cast<std::size_t>(write & (kCapacity - 1));
+    commands_[slot] = command;
+    leases_[slot] = std::move(lease);
+    writeIndex_.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+std::size_t AudioCommandQueue::drain() noexcept {
+    const auto read = readIndex_.load(std::memory_order_relaxed);
+    const auto write = writeIndex_.load(std::memory_order_acquire);
+    for (auto index = read; index != write; ++index) {
+        apply(commands_[static_cast<std::size_t>(index & (kCapacity - 1))]);
+    }
+    readIndex_.store(write, std::memory_order_release);
+    return static_cast<std::size_t>(write - read);
+}
+
+void AudioCommandQueue::apply(const AudioCommand& command) noexcept {
+    switch (command.kind) {
+    case AudioCommandKind::SetParameter:
+        if (command.parameters != nullptr) {
+            command.parameters->store(command.parameter, command.value);
+        }
+        break;
+    case AudioCommandKind::SetEnabled:
+        if (command.parameters != nullptr) {
+            command.parameters->enabled.store(command.value != 0.0F, std::memory_order_relaxed);
+        }
+        break;
+    case AudioCommandKind::ResetMeters:
+        if (command.meters != nullptr) {
+            command.meters->requestReset();
+        }
+        break;
+    }
+}
+
+} // namespace broadcastmix::audio
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "AudioEngine.h"
+#include "MeterStore.h"
+#include "ParameterStore.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace broadcastmix::audio {
+
+enum class AudioCommandKind : std::uint8_t {
+    SetParameter,
+    SetEnabled,
+    ResetMeters
+};
+
+struct AudioCommand {
+    AudioCommandKind kind { AudioCommandKind::SetParameter };
+    NodeParameter parameter { NodeParameter::Gain };
+    float value { 0.0F };
+    ParameterStore::NodeParameters* parameters { nullptr };
+    MeterStore* meters { nullptr };
+};
+
+// Single-producer/single-consumer channel for changes that leave the graph's wiring
+// alone. The message thread pushes; the audio thread drains everything queued at the
+// start of its next block, so a batch of pushes lands in the same block. Each slot keeps
+// a lease on its target that the producer drops when it reuses the slot, which can only
+// happen once the consumer has moved past it, so the audio thread never releases one.
+class AudioCommandQueue {
+public:
+    static constexpr std::size_t kCapacity = 1024;
+
+    AudioCommandQueue();
+    ~AudioCommandQueue();
+
+    AudioCommandQueue(const AudioCommandQueue&) = delete;
+    AudioCommandQueue& operator=(const AudioCommandQueue&) = delete;
+
+    bool push(const AudioCommand& command, std::shared_ptr<const void> lease);
+    std::size_t drain() noexcept;
+
+    static void apply(const AudioCommand& command) noexcept;
+
+private:
+    static_assert((kCapacity & (kCapacity - 1)) == 0, "capacity must be a power of two");
+
+    std::array<AudioCommand, kCapacity> commands_ {};
+    std::array<std::shared_ptr<const void>, kCapacity> leases_ {};
+    alignas(64) std::atomic<std::uint64_t> writeIndex_ { 0 };
+    alignas(64) std::atomic<std::uint64_t> readIndex_ { 0 };
+};
+
+} // namespace broadcastmix::audio
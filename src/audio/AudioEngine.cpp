@@ -1,14 +1,32 @@
 #include "AudioEngine.h"
 
+#include "AudioCommandQueue.h"
 #include "GraphTopology.h"
+#include "LoudnessMeter.h"
 #include "MeterStore.h"
+#include "NodeTimingStore.h"
+#include "ParameterStore.h"
+#include "RoutingMatrix.h"
+#include "SnapshotRecaller.h"
+#include "XrunJournal.h"
 #include "../core/Logging.h"
 
 #include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 #if BROADCASTMIX_HAS_JUCE
+#include "AudioWorkerPool.h"
+#include "BufferPool.h"
+#include "CompiledGraphBuilder.h"
+#include "CompiledGraphProcessor.h"
+#include "GraphSwapPlayer.h"
 #include "JuceGraphBuilder.h"
+#include "OfflineRenderer.h"
+#include "VirtualAudioDevice.h"
 
 #include <juce_audio_devices/juce_audio_devices.h>
 #include <juce_audio_utils/juce_audio_utils.h>
@@ -16,38 +34,80 @@
 
 namespace broadcastmix::audio {
 
+namespace {
+constexpr const char* kLoudnessSourceNodeId = "broadcast_bus";
+}
+
 struct AudioEngine::Impl {
     explicit Impl(AudioEngineSettings cfg)
         : config(std::move(cfg)) {
 #if BROADCASTMIX_HAS_JUCE
         deviceManager = std::make_unique<juce::AudioDeviceManager>();
 
-        processorGraph = std::make_unique<juce::AudioProcessorGraph>();
-        processorPlayer = std::make_unique<juce::AudioProcessorPlayer>();
-        processorPlayer->setProcessor(processorGraph.get());
-        meterStore = std::make_shared<MeterStore>();
-        builder = std::make_unique<JuceGraphBuilder>(*processorGraph, meterStore);
+        player = std::make_unique<GraphSwapPlayer>();
+        player->setConfiguration(PlaybackConfiguration {
+            .sampleRate = static_cast<double>(config.sampleRate > 0 ? config.sampleRate : 48000),
+            .blockSize = static_cast<int>(config.blockSize > 0 ? config.blockSize : 512),
+            .numInputs = static_cast<int>(config.inputChannels),
+            .numOutputs = static_cast<int>(config.outputChannels),
+        });
+        loudness = std::make_shared<LoudnessMeter>();
+        meterStore = std::make_shared<MeterStore>(loudness);
+        meterStore->setLoudnessSource(kLoudnessSourceNodeId);
+        timingStore = std::make_shared<NodeTimingStore>();
+        parameterStore = std::make_shared<ParameterStore>();
+        if (config.graphBackend == AudioGraphBackend::ProcessorGraph) {
+            builder = std::make_unique<JuceGraphBuilder>(meterStore, timingStore, parameterStore);
+        } else {
+            if (config.workerThreads > 0) {
+                workerPool = std::make_shared<AudioWorkerPool>(config.workerThreads);
+            }
+            builder = std::make_unique<CompiledGraphBuilder>(meterStore, timingStore, parameterStore, workerPool, bufferPool);
+        }
+        offlineRenderer = std::make_unique<OfflineRenderer>();
+        player->setXrunJournal(&xrunJournal);
+        player->setSnapshotRecaller(&snapshotRecaller);
+        player->setCommandQueue(&commands);
+        player->setRoutingMatrix(&routingMatrix);
 #endif
     }
 
     ~Impl() {
 #if BROADCASTMIX_HAS_JUCE
-        if (processorPlayer) {
-            processorPlayer->setProcessor(nullptr);
+        offlineRenderer.reset();
+        if (status.isRunning && deviceManager && player) {
+            deviceManager->removeAudioCallback(player.get());
         }
+        xrunJournal.stop();
+        loudness->stop();
 #endif
     }
 
     AudioEngineSettings config;
     AudioEngineStatus status {};
     std::shared_ptr<GraphTopology> topology;
+    std::uint64_t topologyVersion { 0 };
+    RoutingMatrix routingMatrix;
 #if BROADCASTMIX_HAS_JUCE
+    XrunJournal xrunJournal;
+    SnapshotRecaller snapshotRecaller;
+    AudioCommandQueue commands;
+    std::vector<SnapshotRecaller::Target> recallTargets;
+    // Enabled state most recently handed to the audio thread, per node id.
+    std::unordered_map<std::string, bool> sentEnabled;
     std::unique_ptr<juce::AudioDeviceManager> deviceManager;
-    std::unique_ptr<juce::AudioProcessorGraph> processorGraph;
-    std::unique_ptr<juce::AudioProcessorPlayer> processorPlayer;
-    std::unique_ptr<JuceGraphBuilder> builder;
+    std::unique_ptr<GraphSwapPlayer> player;
+    std::shared_ptr<AudioWorkerPool> workerPool;
+    std::shared_ptr<BufferPool> bufferPool { std::make_shared<BufferPool>() };
+    std::unique_ptr<GraphBuilder> builder;
+    std::shared_ptr<LoudnessMeter> loudness;
     std::shared_ptr<MeterStore> meterStore;
+    std::shared_ptr<NodeTimingStore> timingStore;
+    std::shared_ptr<ParameterStore> parameterStore;
+    std::unique_ptr<OfflineRenderer> offlineRenderer;
+    PlaybackConfiguration builtConfiguration {};
     bool deviceInitialised { false };
+    bool virtualDeviceTypeAdded { false };
 
     void ensureDeviceInitialised() {
         if (deviceInitialised || deviceManager == nullptr) {
@@ -56,13 +116,96 @@ struct AudioEngine::Impl {
 
         const auto requestedInputs = static_cast<int>(config.inputChannels > 0 ? config.inputChannels : 2);
         const auto requestedOutputs = static_cast<int>(config.outputChannels > 0 ? config.outputChannels : 2);
-        const auto result = deviceManager->initialiseWithDefaultDevices(requestedInputs, requestedOutputs);
+        const auto result = config.virtualDevice ? openVirtualDevice(requestedInputs, requestedOutputs)
+                                                 : deviceManager->initialiseWithDefaultDevices(requestedInputs, requestedOutputs);
         if (result.isNotEmpty()) {
             core::log(core::LogCategory::Audio, "Audio device init warning: {}", result.toStdString());
         }
 
         deviceInitialised = true;
     }
+
+    // Registering the virtual type first also keeps the manager from probing the host's
+    // real device types, which is what makes it usable on machines without a sound card.
+    juce::String openVirtualDevice(int numInputs, int numOutputs) {
+        if (!virtualDeviceTypeAdded) {
+            deviceManager->addAudioDeviceType(std::make_unique<VirtualAudioDeviceType>(*config.virtualDevice, numInputs, numOutputs));
+            virtualDeviceTypeAdded = true;
+        }
+        deviceManager->setCurrentAudioDeviceType(VirtualAudioDevice::kTypeName, false);
+
+        auto setup = deviceManager->getAudioDeviceSetup();
+        setup.inputDeviceName = VirtualAudioDevice::kDeviceName;
+        setup.outputDeviceName = VirtualAudioDevice::kDeviceName;
+        setup.sampleRate = static_cast<double>(config.sampleRate > 0 ? config.sampleRate : 48000);
+        setup.bufferSize = static_cast<int>(config.blockSize > 0 ? config.blockSize : 512);
+        setup.useDefaultInputChannels = false;
+        setup.useDefaultOutputChannels = false;
+        setup.inputChannels.clear();
+        setup.inputChannels.setRange(0, numInputs, true);
+        setup.outputChannels.clear();
+        setup.outputChannels.setRange(0, numOutputs, true);
+        return deviceManager->setAudioDeviceSetup(setup, false);
+    }
+
+    // Commands reach the audio thread at its next block; with no device running they are
+    // applied straight away. A full queue rejects the command: applying it here would let
+    // the older commands still queued overwrite it.
+    bool enqueue(const AudioCommand& command, std::shared_ptr<const void> lease) {
+        if (!status.isRunning) {
+            AudioCommandQueue::apply(command);
+            return true;
+        }
+        if (!commands.push(command, std::move(lease))) {
+            core::log(core::LogCategory::Audio, "Audio command queue full; change rejected");
+            return false;
+        }
+        return true;
+    }
+
+    // Diffs against the state last sent rather than the live flag, which lags behind any
+    // SetEnabled still queued; toggling off and on again within a block must send both.
+    void enqueueEnabledChanges() {
+        if (!parameterStore || !topology) {
+            return;
+        }
+        std::unordered_set<std::string> present;
+        present.reserve(topology->nodes().size());
+        for (const auto& node : topology->nodes()) {
+            present.insert(node.id());
+            auto parameters = parameterStore->find(node.id());
+            if (!parameters) {
+                continue;
+            }
+            // A node seen for the first time has fresh parameters, so its live flag is current.
+            const auto sent = sentEnabled.try_emplace(node.id(), parameters->enabled.load(std::memory_order_relaxed)).first;
+            if (sent->second == node.enabled()) {
+                continue;
+            }
+            const AudioCommand command {
+                .kind = AudioCommandKind::SetEnabled,
+                .value = node.enabled() ? 1.0F : 0.0F,
+                .parameters = parameters.get(),
+            };
+            if (enqueue(command, std::move(parameters))) {
+                sent->second = node.enabled();
+            }
+        }
+        std::erase_if(sentEnabled, [&](const auto& entry) { return !present.contains(entry.first); });
+    }
+
+    void rebuildGraph() {
+        if (!builder || !player || !topology) {
+            return;
+        }
+
+        builtConfiguration = player->configuration();
+        auto graph = builder->buildFromTopology(*topology, builtConfiguration);
+        if (!status.isRunning && offlineRenderer) {
+            offlineRenderer->setProcessor(graph.get());
+        }
+        player->submit(std::move(graph));
+    }
 #endif
 };
 
@@ -84,9 +227,25 @@ void AudioEngine::start() {
         setTopology(std::make_shared<GraphTopology>(GraphTopology::createDefaultBroadcastLayout()));
     }
 
-    if (impl_->deviceManager && impl_->processorPlayer) {
+    if (impl_->offlineRenderer) {
+        impl_->offlineRenderer->setProcessor(nullptr);
+    }
+
+    if (impl_->deviceManager && impl_->player) {
+        impl_->player->loadMeter().reset();
+        impl_->xrunJournal.start();
+        impl_->loudness->start();
+        // Attached before the device opens, so a virtual device's first block already reaches the graph.
+        impl_->deviceManager->addAudioCallback(impl_->player.get());
         impl_->ensureDeviceInitialised();
-        impl_->deviceManager->addAudioCallback(impl_->processorPlayer.get());
+
+        // Hardware I/O nodes are wired per channel, so a device with a different layout needs a fresh graph.
+        const auto deviceConfiguration = impl_->player->configuration();
+        if (deviceConfiguration.numInputs != impl_->builtConfiguration.numInputs
+            || deviceConfiguration.numOutputs != impl_->builtConfiguration.numOutputs) {
+            impl_->status.isRunning = true;
+            impl_->rebuildGraph();
+        }
     }
 #endif
 
@@ -101,15 +260,56 @@ void AudioEngine::stop() {
 
     impl_->status.isRunning = false;
 #if BROADCASTMIX_HAS_JUCE
-    if (impl_->deviceManager && impl_->processorPlayer) {
-        impl_->deviceManager->removeAudioCallback(impl_->processorPlayer.get());
+    if (impl_->deviceManager && impl_->player) {
+        impl_->deviceManager->removeAudioCallback(impl_->player.get());
+        // The audio thread is detached, so whatever it left queued lands now rather than on the next start.
+        impl_->commands.drain();
+        if (impl_->config.virtualDevice) {
+            // A virtual run ends with the engine; the next start replays it from the top.
+            impl_->deviceManager->closeAudioDevice();
+            impl_->deviceInitialised = false;
+        }
+        impl_->player->collectGarbage();
+        impl_->xrunJournal.stop();
+        impl_->loudness->stop();
+        if (impl_->offlineRenderer) {
+            impl_->offlineRenderer->setProcessor(impl_->player->current());
+        }
     }
 #endif
     core::log(core::LogCategory::Audio, "Audio engine stopped");
 }
 
 AudioEngineStatus AudioEngine::status() const {
-    return impl_->status;
+    auto status = impl_->status;
+#if BROADCASTMIX_HAS_JUCE
+    if (status.isRunning && impl_->player) {
+        impl_->player->loadMeter().fill(status);
+    }
+    if (impl_->player) {
+        // The processor graph backend compensates internally and reports the result as its own latency.
+        if (const auto* compiled = dynamic_cast<const CompiledGraphProcessor*>(impl_->player->current())) {
+            status.graphLatencySamples = compiled->compensatedLatency();
+        } else if (const auto* current = impl_->player->current()) {
+            status.graphLatencySamples = static_cast<std::uint32_t>(std::max(0, current->getLatencySamples()));
+        }
+    }
+    status.scratchBytes = impl_->bufferPool->reservedBytes();
+    if (impl_->deviceManager) {
+        if (const auto* device = dynamic_cast<const VirtualAudioDevice*>(impl_->deviceManager->getCurrentAudioDevice())) {
+            status.deviceFinished = device->isFinished();
+        }
+    }
+#endif
+    return status;
+}
+
+void AudioEngine::resetCpuLoadStatistics() {
+#if BROADCASTMIX_HAS_JUCE
+    if (impl_->player) {
+        impl_->player->loadMeter().reset();
+    }
+#endif
 }
 
 AudioEngineSettings AudioEngine::settings() const {
@@ -121,35 +321,346 @@ void AudioEngine::setTopology(std::shared_ptr<GraphTopology> topology) {
         topology = std::make_shared<GraphTopology>(GraphTopology::createDefaultBroadcastLayout());
     }
 
+#if BROADCASTMIX_HAS_JUCE
+    // Edits that keep every processor and connection (enable toggles, renames, person
+    // details) reach the running graph through the command queue instead of a rebuild.
+    const auto sameRouting = impl_->topology && impl_->builder && topology->hasSameRouting(*impl_->topology);
+#endif
     impl_->topology = std::move(topology);
+    ++impl_->topologyVersion;
 #if BROADCASTMIX_HAS_JUCE
+    if (impl_->player) {
+        impl_->player->setTopologyVersion(impl_->topologyVersion);
+    }
+    if (sameRouting) {
+        impl_->enqueueEnabledChanges();
+        core::log(core::LogCategory::Audio, "Topology v{} applied without rebuilding the graph", impl_->topologyVersion);
+        return;
+    }
     if (impl_->builder && impl_->topology) {
         if (impl_->meterStore) {
             impl_->meterStore->syncWithTopology(*impl_->topology);
         }
-        impl_->builder->rebuildFromTopology(*impl_->topology);
+        if (impl_->timingStore) {
+            impl_->timingStore->syncWithTopology(*impl_->topology);
+        }
+        if (impl_->parameterStore) {
+            impl_->parameterStore->syncWithTopology(*impl_->topology);
+            impl_->enqueueEnabledChanges();
+        }
+        // Edits are patched into the live graph so untouched processors keep their state;
+        // only wholesale changes fall back to a crossfaded rebuild.
+        if (!impl_->builder->applyTopology(*impl_->topology, impl_->player->configuration())) {
+            impl_->rebuildGraph();
+        }
     }
 #endif
-    core::log(core::LogCategory::Audio, "Topology assigned to audio engine");
+    core::log(core::LogCategory::Audio, "Topology v{} assigned to audio engine", impl_->topologyVersion);
 }
 
 std::shared_ptr<const GraphTopology> AudioEngine::topology() const {
     return impl_->topology;
 }
 
-std::array<float, 2> AudioEngine::meterLevelsForNode(const std::string& nodeId) const {
+std::uint64_t AudioEngine::topologyVersion() const {
+    return impl_->topologyVersion;
+}
+
+void AudioEngine::setDiagnosticsDirectory(const std::string& directory) {
+#if BROADCASTMIX_HAS_JUCE
+    impl_->xrunJournal.setLogDirectory(directory);
+#else
+    (void) directory;
+#endif
+}
+
+std::vector<float> AudioEngine::meterLevelsForNode(const std::string& nodeId, MeterMode mode) const {
+#if BROADCASTMIX_HAS_JUCE
+    if (impl_->meterStore) {
+        return impl_->meterStore->levelsFor(nodeId, mode);
+    }
+#else
+    (void) nodeId;
+    (void) mode;
+#endif
+    return {};
+}
+
+MeterHandle AudioEngine::meterHandleForNode(const std::string& nodeId) const {
 #if BROADCASTMIX_HAS_JUCE
     if (impl_->meterStore) {
-        return impl_->meterStore->levelsFor(nodeId);
+        return impl_->meterStore->handleFor(nodeId);
+    }
+#else
+    (void) nodeId;
+#endif
+    return kInvalidMeterHandle;
+}
+
+std::uint64_t AudioEngine::meterLayoutVersion() const {
+#if BROADCASTMIX_HAS_JUCE
+    if (impl_->meterStore) {
+        return impl_->meterStore->layoutVersion();
+    }
+#endif
+    return 0;
+}
+
+void AudioEngine::readMeters(MeterSnapshot& snapshot, MeterMode mode) const {
+#if BROADCASTMIX_HAS_JUCE
+    if (impl_->meterStore) {
+        impl_->meterStore->readSnapshot(snapshot, mode);
+        return;
+    }
+#else
+    (void) mode;
+#endif
+    snapshot.levels.clear();
+    snapshot.ranges.clear();
+}
+
+void AudioEngine::resetMeters() {
+#if BROADCASTMIX_HAS_JUCE
+    if (impl_->meterStore) {
+        const AudioCommand command {
+            .kind = AudioCommandKind::ResetMeters,
+            .meters = impl_->meterStore.get(),
+        };
+        impl_->enqueue(command, impl_->meterStore);
+    }
+#endif
+}
+
+LoudnessStats AudioEngine::loudness() const {
+#if BROADCASTMIX_HAS_JUCE
+    if (impl_->loudness) {
+        return impl_->loudness->stats();
+    }
+#endif
+    return {};
+}
+
+void AudioEngine::resetLoudness() {
+#if BROADCASTMIX_HAS_JUCE
+    if (impl_->loudness) {
+        impl_->loudness->reset();
+    }
+#endif
+}
+
+bool AudioEngine::setNodeParameter(const std::string& nodeId, NodeParameter parameter, float value) {
+#if BROADCASTMIX_HAS_JUCE
+    if (!impl_->parameterStore || !std::isfinite(value)) {
+        return false;
+    }
+    auto parameters = impl_->parameterStore->find(nodeId);
+    if (!parameters) {
+        return false;
+    }
+    const AudioCommand command {
+        .kind = AudioCommandKind::SetParameter,
+        .parameter = parameter,
+        .value = value,
+        .parameters = parameters.get(),
+    };
+    return impl_->enqueue(command, std::move(parameters));
+#else
+    (void) nodeId;
+    (void) parameter;
+    (void) value;
+    return false;
+#endif
+}
+
+std::optional<float> AudioEngine::nodeParameter(const std::string& nodeId, NodeParameter parameter) const {
+#if BROADCASTMIX_HAS_JUCE
+    if (impl_->parameterStore) {
+        return impl_->parameterStore->parameter(nodeId, parameter);
+    }
+#else
+    (void) nodeId;
+    (void) parameter;
+#endif
+    return std::nullopt;
+}
+
+SnapshotState AudioEngine::captureSnapshot(const std::string& name) const {
+    SnapshotState snapshot;
+    snapshot.name = name;
+#if BROADCASTMIX_HAS_JUCE
+    if (impl_->parameterStore) {
+        snapshot.parameters = impl_->parameterStore->capture();
+    }
+#endif
+    return snapshot;
+}
+
+bool AudioEngine::recallSnapshot(const SnapshotState& snapshot, SnapshotGlide glide) {
+#if BROADCASTMIX_HAS_JUCE
+    if (!impl_->parameterStore) {
+        return false;
+    }
+
+    auto& targets = impl_->recallTargets;
+    targets.clear();
+    for (const auto& parameter : snapshot.parameters) {
+        if (auto slot = impl_->parameterStore->find(parameter.nodeId); slot && std::isfinite(parameter.value)) {
+            targets.push_back({ std::move(slot), parameter.parameter, parameter.value });
+        }
+    }
+
+    // Without a running device nothing would advance the glide, so idle recalls land at once.
+    if (!impl_->status.isRunning) {
+        for (const auto& target : targets) {
+            if (!target.parameters->recallSafe.load(std::memory_order_relaxed)) {
+                target.parameters->store(target.parameter, target.value);
+            }
+        }
+    } else {
+        impl_->snapshotRecaller.submit(targets, SnapshotRecaller::glideSeconds(glide));
+    }
+    core::log(core::LogCategory::Audio, "Recalling snapshot {} ({} parameters)", snapshot.name, targets.size());
+    targets.clear();
+    return true;
+#else
+    (void) snapshot;
+    (void) glide;
+    return false;
+#endif
+}
+
+bool AudioEngine::snapshotRecallActive() const {
+#if BROADCASTMIX_HAS_JUCE
+    return impl_->snapshotRecaller.isGliding();
+#else
+    return false;
+#endif
+}
+
+bool AudioEngine::setNodeRecallSafe(const std::string& nodeId, bool safe) {
+#if BROADCASTMIX_HAS_JUCE
+    if (impl_->parameterStore) {
+        return impl_->parameterStore->setRecallSafe(nodeId, safe);
     }
 #else
     (void) nodeId;
+    (void) safe;
 #endif
-    return { 0.0F, 0.0F };
+    return false;
+}
+
+bool AudioEngine::setHardwarePatch(PatchSide side, const std::vector<HardwarePatch>& patches) {
+    return impl_->routingMatrix.setPatches(side, patches);
+}
+
+void AudioEngine::resetHardwarePatch(PatchSide side) {
+    impl_->routingMatrix.resetPatches(side);
+}
+
+std::vector<HardwarePatch> AudioEngine::hardwarePatch(PatchSide side) const {
+    return impl_->routingMatrix.patches(side);
 }
 
-void AudioEngine::processBlock() {
-    // Offline processing not yet implemented; runtime uses JUCE audio callbacks.
+void AudioEngine::setNodeProfilingEnabled(bool enabled) {
+#if BROADCASTMIX_HAS_JUCE
+    if (impl_->timingStore) {
+        impl_->timingStore->setEnabled(enabled);
+    }
+#else
+    (void) enabled;
+#endif
+}
+
+bool AudioEngine::nodeProfilingEnabled() const {
+#if BROADCASTMIX_HAS_JUCE
+    return impl_->timingStore && impl_->timingStore->isEnabled();
+#else
+    return false;
+#endif
+}
+
+void AudioEngine::resetNodeTimings() {
+#if BROADCASTMIX_HAS_JUCE
+    if (impl_->timingStore) {
+        impl_->timingStore->reset();
+    }
+#endif
+}
+
+NodeTimingStats AudioEngine::nodeTimingForNode(const std::string& nodeId) const {
+#if BROADCASTMIX_HAS_JUCE
+    if (impl_->timingStore) {
+        return impl_->timingStore->statsFor(nodeId);
+    }
+#else
+    (void) nodeId;
+#endif
+    return {};
+}
+
+std::vector<std::pair<std::string, NodeTimingStats>> AudioEngine::nodeTimings() const {
+#if BROADCASTMIX_HAS_JUCE
+    if (impl_->timingStore) {
+        return impl_->timingStore->snapshot();
+    }
+#endif
+    return {};
+}
+
+OfflineRenderResult AudioEngine::renderOffline(const OfflineRenderRequest& request) {
+#if BROADCASTMIX_HAS_JUCE
+    if (impl_->status.isRunning) {
+        OfflineRenderResult result;
+        result.error = "Offline render unavailable while the engine runs on a live device";
+        return result;
+    }
+
+    if (!impl_->topology) {
+        setTopology(std::make_shared<GraphTopology>(GraphTopology::createDefaultBroadcastLayout()));
+    }
+
+    auto result = impl_->offlineRenderer->render(request, impl_->config);
+    if (!result.success) {
+        core::log(core::LogCategory::Audio, "Offline render failed: {}", result.error);
+    }
+    return result;
+#else
+    (void) request;
+    OfflineRenderResult result;
+    result.error = "Offline render requires JUCE";
+    return result;
+#endif
+}
+
+void AudioEngine::processBlock(const float* const* inputs,
+                               std::uint32_t numInputs,
+                               float* const* outputs,
+                               std::uint32_t numOutputs,
+                               std::uint32_t numSamples) {
+#if BROADCASTMIX_HAS_JUCE
+    // Device-free rendering; the live path is driven by the JUCE device callback instead.
+    if (impl_->status.isRunning || !impl_->offlineRenderer) {
+        return;
+    }
+
+    if (!impl_->topology) {
+        setTopology(std::make_shared<GraphTopology>(GraphTopology::createDefaultBroadcastLayout()));
+    }
+
+    if (!impl_->offlineRenderer->isPrepared()) {
+        impl_->offlineRenderer->prepare(impl_->config);
+    }
+    impl_->offlineRenderer->processBlock(inputs, numInputs, outputs, numOutputs, numSamples);
+#else
+    (void) inputs;
+    (void) numInputs;
+    (void) numSamples;
+    for (std::uint32_t channel = 0; channel < numOutputs; ++channel) {
+        if (outputs != nullptr && outputs[channel] != nullptr) {
+            std::fill(outputs[channel], outputs[channel] + numSamples, 0.0F);
+        }
+    }
+#endif
 }
 
 } // namespace broadcastmix::audio
@@ -1,28 +1,189 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
-#include <array>
 
 namespace broadcastmix::audio {
 
 class GraphTopology;
 class GraphNode;
 
+enum class AudioGraphBackend {
+    CompiledPlan,
+    ProcessorGraph
+};
+
+// Runs the engine against files instead of hardware. Inputs are read from a multichannel
+// WAV (silence without one) and outputs written to a 32-bit float WAV, one device block
+// at a time, either paced by a simulated realtime clock or as fast as the engine renders.
+struct VirtualDeviceSettings {
+    std::string inputFile;
+    std::string outputFile;
+    bool realtimeClock { true };
+    // Samples to run for; 0 runs to the end of the input file, or until stopped without one.
+    std::uint64_t lengthInSamples { 0 };
+};
+
 struct AudioEngineSettings {
     std::uint32_t sampleRate { 48000 };
     std::uint32_t blockSize { 512 };
     std::uint32_t inputChannels { 32 };
     std::uint32_t outputChannels { 32 };
+    AudioGraphBackend graphBackend { AudioGraphBackend::CompiledPlan };
+    std::uint32_t workerThreads { 0 };
+    // Replaces the default hardware device when set.
+    std::optional<VirtualDeviceSettings> virtualDevice;
 };
 
 struct AudioEngineStatus {
     bool isRunning { false };
     double cpuLoad { 0.0 };
+    double cpuLoadAverage { 0.0 };
+    double cpuLoadPeak { 0.0 };
+    std::array<std::uint64_t, 11> cpuLoadHistogram {};
+    // Processing latency of the slowest compensated path to the outputs.
+    std::uint32_t graphLatencySamples { 0 };
+    // Render scratch memory held by the engine, including blocks kept for reuse.
+    std::size_t scratchBytes { 0 };
+    // Set once a virtual device has run its full length.
+    bool deviceFinished { false };
+};
+
+using MeterHandle = std::uint32_t;
+inline constexpr MeterHandle kInvalidMeterHandle = 0xFFFFFFFFU;
+
+enum class MeterMode {
+    Peak,
+    PeakHold,
+    Rms,
+    TruePeak
+};
+
+struct MeterRange {
+    std::uint32_t firstChannel { 0 };
+    std::uint32_t numChannels { 0 };
+};
+
+// Every metered channel of the graph as linear amplitude; ranges is indexed by MeterHandle.
+struct MeterSnapshot {
+    std::vector<float> levels;
+    std::vector<MeterRange> ranges;
+};
+
+// EBU R128 loudness in LUFS; -inf until enough programme has been measured.
+struct LoudnessStats {
+    double momentaryLufs { -std::numeric_limits<double>::infinity() };
+    double shortTermLufs { -std::numeric_limits<double>::infinity() };
+    double integratedLufs { -std::numeric_limits<double>::infinity() };
+    double loudnessRangeLu { 0.0 };
+    std::uint64_t droppedFrames { 0 };
+};
+
+// Realtime node parameters, in the units the processor applies them (Gain is linear,
+// Mute is 0 or 1, Signal a GeneratorSignal index, Frequency in Hz). The channel strip
+// parameters use Hz, dB, milliseconds and a ratio; each EQ band is Frequency, Gain, Q.
+enum class NodeParameter : std::uint32_t {
+    Gain,
+    Mute,
+    Signal,
+    Frequency,
+    HighPassFrequency,
+    EqLowFrequency,
+    EqLowGain,
+    EqLowQ,
+    EqLowMidFrequency,
+    EqLowMidGain,
+    EqLowMidQ,
+    EqHighMidFrequency,
+    EqHighMidGain,
+    EqHighMidQ,
+    EqHighFrequency,
+    EqHighGain,
+    EqHighQ,
+    GateThreshold,
+    CompressorThreshold,
+    CompressorRatio,
+    CompressorAttack,
+    CompressorRelease,
+    CompressorMakeup
+};
+
+inline constexpr std::size_t kNodeParameterCount = 23;
+
+enum class GeneratorSignal : std::uint32_t {
+    Sine,
+    WhiteNoise,
+    PinkNoise,
+    LogSweep,
+    ChannelIdent
+};
+
+inline constexpr std::size_t kGeneratorSignalCount = 5;
+
+enum class SnapshotGlide {
+    Short,
+    Medium,
+    Long
+};
+
+struct SnapshotParameter {
+    std::string nodeId;
+    NodeParameter parameter { NodeParameter::Gain };
+    float value { 0.0F };
+};
+
+struct SnapshotState {
+    std::string name;
+    std::vector<SnapshotParameter> parameters;
+};
+
+enum class PatchSide {
+    Input,
+    Output
+};
+
+// One crosspoint of the hardware routing matrix. On the input side the source is a device
+// input and the destination a graph input channel; on the output side the source is a
+// graph output channel and the destination a device output.
+struct HardwarePatch {
+    std::uint32_t source { 0 };
+    std::uint32_t destination { 0 };
+    float gain { 1.0F };
+
+    bool operator==(const HardwarePatch&) const = default;
+};
+
+struct NodeTimingStats {
+    std::uint64_t blocks { 0 };
+    std::uint64_t totalNanoseconds { 0 };
+    std::uint64_t lastNanoseconds { 0 };
+    std::uint64_t maxNanoseconds { 0 };
+};
+
+struct OfflineRenderRequest {
+    std::vector<std::vector<float>> inputBuffers;
+    std::string inputFile;
+    std::string outputFile;
+    std::uint64_t lengthInSamples { 0 };
+    bool collectOutput { true };
+};
+
+struct OfflineRenderResult {
+    bool success { false };
+    std::string error;
+    std::vector<std::vector<float>> outputBuffers;
+    std::uint64_t samplesRendered { 0 };
+    double audioSeconds { 0.0 };
+    double wallSeconds { 0.0 };
+    double realtimeFactor { 0.0 };
 };
 
 class AudioEngine {
@@ -39,14 +200,46 @@ public:
     void stop();
 
     [[nodiscard]] AudioEngineStatus status() const;
+    void resetCpuLoadStatistics();
     [[nodiscard]] AudioEngineSettings settings() const;
 
     void setTopology(std::shared_ptr<GraphTopology> topology);
     [[nodiscard]] std::shared_ptr<const GraphTopology> topology() const;
+    [[nodiscard]] std::uint64_t topologyVersion() const;
+
+    void setDiagnosticsDirectory(const std::string& directory);
+
+    [[nodiscard]] std::vector<float> meterLevelsForNode(const std::string& nodeId, MeterMode mode = MeterMode::Peak) const;
+    [[nodiscard]] MeterHandle meterHandleForNode(const std::string& nodeId) const;
+    [[nodiscard]] std::uint64_t meterLayoutVersion() const;
+    void readMeters(MeterSnapshot& snapshot, MeterMode mode = MeterMode::Peak) const;
+    void resetMeters();
+    [[nodiscard]] LoudnessStats loudness() const;
+    void resetLoudness();
+
+    bool setNodeParameter(const std::string& nodeId, NodeParameter parameter, float value);
+    [[nodiscard]] std::optional<float> nodeParameter(const std::string& nodeId, NodeParameter parameter) const;
+    [[nodiscard]] SnapshotState captureSnapshot(const std::string& name) const;
+    bool recallSnapshot(const SnapshotState& snapshot, SnapshotGlide glide = SnapshotGlide::Medium);
+    [[nodiscard]] bool snapshotRecallActive() const;
+    bool setNodeRecallSafe(const std::string& nodeId, bool safe);
+
+    bool setHardwarePatch(PatchSide side, const std::vector<HardwarePatch>& patches);
+    void resetHardwarePatch(PatchSide side);
+    [[nodiscard]] std::vector<HardwarePatch> hardwarePatch(PatchSide side) const;
 
-    [[nodiscard]] std::array<float, 2> meterLevelsForNode(const std::string& nodeId) const;
+    void setNodeProfilingEnabled(bool enabled);
+    [[nodiscard]] bool nodeProfilingEnabled() const;
+    void resetNodeTimings();
+    [[nodiscard]] NodeTimingStats nodeTimingForNode(const std::string& nodeId) const;
+    [[nodiscard]] std::vector<std::pair<std::string, NodeTimingStats>> nodeTimings() const;
 
-    void processBlock();
+    [[nodiscard]] OfflineRenderResult renderOffline(const OfflineRenderRequest& request);
+    void processBlock(const float* const* inputs,
+                      std::uint32_t numInputs,
+                      float* const* outputs,
+                      std::uint32_t numOutputs,
+                      std::uint32_t numSamples);
 
 private:
     struct Impl;
@@ -0,0 +1,201 @@
+#include "AudioWorkerPool.h"
+
+#include "RealtimeScope.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace broadcastmix::audio {
+
+namespace {
+
+constexpr int kSpinsBeforeSleep = 4096;
+
+inline void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+void raiseToRealtimePriority([[maybe_unused]] std::thread& thread) {
+#if !defined(_WIN32)
+    // Best effort: without the privilege the workers stay at normal priority and the
+    // callback thread simply picks up more of the work itself.
+    sched_param parameters {};
+    parameters.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+    pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &parameters);
+#endif
+}
+
+} // namespace
+
+AudioWorkerPool::TaskDeque::TaskDeque()
+    : tasks_(std::make_unique<std::atomic<std::uint32_t>[]>(kMaxTasks)) {}
+
+void AudioWorkerPool::TaskDeque::push(std::uint32_t task) noexcept {
+    const auto bottom = bottom_.load(std::memory_order_relaxed);
+    tasks_[static_cast<std::size_t>(bottom) & (kMaxTasks - 1)].store(task, std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_release);
+}
+
+bool AudioWorkerPool::TaskDeque::pop(std::uint32_t& task) noexcept {
+    const auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = top_.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    task = tasks_[static_cast<std::size_t>(bottom) & (kMaxTasks - 1)].load(std::memory_order_relaxed);
+    if (top < bottom) {
+        return true;
+    }
+
+    // Last item: race any thief for it.
+    const bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return won;
+}
+
+bool AudioWorkerPool::TaskDeque::steal(std::uint32_t& task) noexcept {
+    auto top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return false;
+    }
+
+    task = tasks_[static_cast<std::size_t>(top) & (kMaxTasks - 1)].load(std::memory_order_relaxed);
+    return top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+AudioWorkerPool::AudioWorkerPool(std::uint32_t workerCount) {
+    deques_.reserve(workerCount + 1);
+    for (std::uint32_t participant = 0; participant <= workerCount; ++participant) {
+        deques_.push_back(std::make_unique<TaskDeque>());
+    }
+
+    workers_.reserve(workerCount);
+    for (std::uint32_t participant = 1; participant <= workerCount; ++participant) {
+        workers_.emplace_back([this, participant] { workerLoop(participant); });
+        raiseToRealtimePriority(workers_.back());
+    }
+}
+
+AudioWorkerPool::~AudioWorkerPool() {
+    quit_.store(true, std::memory_order_release);
+    epoch_.fetch_add(1, std::memory_order_release);
+    epoch_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::uint32_t AudioWorkerPool::workerCount() const noexcept {
+    return static_cast<std::uint32_t>(workers_.size());
+}
+
+void AudioWorkerPool::run(const AudioTaskGraph& graph, TaskFunction function, void* context) noexcept {
+    if (graph.taskCount == 0) {
+        return;
+    }
+
+    if (workers_.empty() || graph.taskCount > kMaxTasks) {
+        // Tasks are numbered in a valid serial order, so running them in sequence is always correct.
+        for (std::uint32_t task = 0; task < graph.taskCount; ++task) {
+            function(context, task);
+        }
+        return;
+    }
+
+    graph_ = graph;
+    function_ = function;
+    context_ = context;
+    for (std::uint32_t task = 0; task < graph.taskCount; ++task) {
+        graph.pending[task].store(graph.dependencyCounts[task], std::memory_order_relaxed);
+    }
+    remaining_.store(graph.taskCount, std::memory_order_relaxed);
+
+    for (std::uint32_t task = graph.taskCount; task-- > 0;) {
+        if (graph.dependencyCounts[task] == 0) {
+            deques_[0]->push(task);
+        }
+    }
+
+    epoch_.fetch_add(1, std::memory_order_release);
+    epoch_.notify_all();
+
+    participate(0);
+}
+
+void AudioWorkerPool::workerLoop(std::uint32_t participant) {
+    auto seen = epoch_.load(std::memory_order_acquire);
+    while (true) {
+        auto spins = 0;
+        auto current = epoch_.load(std::memory_order_acquire);
+        while (current == seen) {
+            if (++spins < kSpinsBeforeSleep) {
+                cpuRelax();
+            } else {
+                epoch_.wait(seen, std::memory_order_acquire);
+            }
+            current = epoch_.load(std::memory_order_acquire);
+        }
+        seen = current;
+
+        if (quit_.load(std::memory_order_acquire)) {
+            return;
+        }
+        const RealtimeScope realtime;
+        participate(participant);
+    }
+}
+
+void AudioWorkerPool::participate(std::uint32_t participant) noexcept {
+    std::uint32_t task = 0;
+    while (remaining_.load(std::memory_order_acquire) > 0) {
+        if (deques_[participant]->pop(task) || steal(participant, task)) {
+            execute(participant, task);
+        } else {
+            cpuRelax();
+        }
+    }
+}
+
+bool AudioWorkerPool::steal(std::uint32_t thief, std::uint32_t& task) noexcept {
+    const auto participants = static_cast<std::uint32_t>(deques_.size());
+    for (std::uint32_t offset = 1; offset < participants; ++offset) {
+        if (deques_[(thief + offset) % participants]->steal(task)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AudioWorkerPool::execute(std::uint32_t participant, std::uint32_t task) noexcept {
+    function_(context_, task);
+
+    const auto first = graph_.dependentOffsets[task];
+    const auto last = graph_.dependentOffsets[task + 1];
+    for (auto index = first; index < last; ++index) {
+        const auto dependent = graph_.dependents[index];
+        if (graph_.pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            deques_[participant]->push(dependent);
+        }
+    }
+
+    remaining_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+} // namespace broadcastmix::audio
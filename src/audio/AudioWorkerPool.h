@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace broadcastmix::audio {
+
+// Dependency graph for one parallel run. Arrays are owned by the caller and must
+// outlive the run; `pending` is scratch space the pool rewrites on every run.
+struct AudioTaskGraph {
+    std::uint32_t taskCount { 0 };
+    const std::uint32_t* dependencyCounts { nullptr };
+    const std::uint32_t* dependentOffsets { nullptr };
+    const std::uint32_t* dependents { nullptr };
+    std::atomic<std::uint32_t>* pending { nullptr };
+};
+
+// Realtime worker pool for rendering independent graph branches inside one
+// device callback. The calling thread always takes part in the run, so a block
+// finishes even if every worker is descheduled; workers only add throughput.
+// run() never allocates or locks.
+class AudioWorkerPool {
+public:
+    using TaskFunction = void (*)(void* context, std::uint32_t task);
+
+    static constexpr std::uint32_t kMaxTasks = 4096;
+
+    explicit AudioWorkerPool(std::uint32_t workerCount);
+    ~AudioWorkerPool();
+
+    AudioWorkerPool(const AudioWorkerPool&) = delete;
+    AudioWorkerPool& operator=(const AudioWorkerPool&) = delete;
+
+    [[nodiscard]] std::uint32_t workerCount() const noexcept;
+
+    // Must not be called concurrently with itself.
+    void run(const AudioTaskGraph& graph, TaskFunction function, void* context) noexcept;
+
+private:
+    class TaskDeque {
+    public:
+        TaskDeque();
+
+        void push(std::uint32_t task) noexcept;
+        bool pop(std::uint32_t& task) noexcept;
+        bool steal(std::uint32_t& task) noexcept;
+
+    private:
+        alignas(64) std::atomic<std::int64_t> top_ { 0 };
+        alignas(64) std::atomic<std::int64_t> bottom_ { 0 };
+        std::unique_ptr<std::atomic<std::uint32_t>[]> tasks_;
+    };
+
+    void workerLoop(std::uint32_t participant);
+    void participate(std::uint32_t participant) noexcept;
+    bool steal(std::uint32_t thief, std::uint32_t& task) noexcept;
+    void execute(std::uint32_t participant, std::uint32_t task) noexcept;
+
+    std::vector<std::unique_ptr<TaskDeque>> deques_;
+    std::vector<std::thread> workers_;
+
+    AudioTaskGraph graph_ {};
+    TaskFunction function_ { nullptr };
+    void* context_ { nullptr };
+
+    alignas(64) std::atomic<std::uint32_t> remaining_ { 0 };
+    alignas(64) std::atomic<std::uint64_t> epoch_ { 0 };
+    std::atomic<bool> quit_ { false };
+};
+
+} // namespace broadcastmix::audio
@@ -0,0 +1,164 @@
+#include "BufferPool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace broadcastmix::audio {
+
+namespace {
+constexpr std::size_t kAlignmentSamples = BufferPool::kAlignment / sizeof(float);
+
+std::size_t channelStride(std::size_t numSamples) noexcept {
+    return (numSamples + kAlignmentSamples - 1) / kAlignmentSamples * kAlignmentSamples;
+}
+} // namespace
+
+BufferPool::Lease::~Lease() {
+    reset();
+}
+
+BufferPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr))
+    , block_(other.block_)
+    , channels_(std::exchange(other.channels_, nullptr))
+    , numChannels_(std::exchange(other.numChannels_, 0))
+    , numSamples_(std::exchange(other.numSamples_, 0)) {}
+
+BufferPool::Lease& BufferPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        reset();
+        pool_ = std::exchange(other.pool_, nullptr);
+        block_ = other.block_;
+        channels_ = std::exchange(other.channels_, nullptr);
+        numChannels_ = std::exchange(other.numChannels_, 0);
+        numSamples_ = std::exchange(other.numSamples_, 0);
+    }
+    return *this;
+}
+
+float* const* BufferPool::Lease::channels() const noexcept {
+    return channels_;
+}
+
+float* BufferPool::Lease::channel(std::size_t index) const noexcept {
+    return index < numChannels_ ? channels_[index] : nullptr;
+}
+
+void BufferPool::Lease::clear() noexcept {
+    for (std::size_t index = 0; index < numChannels_; ++index) {
+        std::memset(channels_[index], 0, numSamples_ * sizeof(float));
+    }
+}
+
+void BufferPool::Lease::reset() {
+    if (pool_ != nullptr) {
+        pool_->release(block_);
+    }
+    pool_ = nullptr;
+    channels_ = nullptr;
+    numChannels_ = 0;
+    numSamples_ = 0;
+}
+
+void BufferPool::AlignedDelete::operator()(float* data) const noexcept {
+    ::operator delete(data, std::align_val_t { kAlignment });
+}
+
+BufferPool::~BufferPool() = default;
+
+BufferPool::Lease BufferPool::lease(std::size_t numChannels, std::size_t numSamples) {
+    Lease lease;
+    if (numChannels == 0 || numSamples == 0) {
+        return lease;
+    }
+
+    const auto stride = channelStride(numSamples);
+    const auto required = stride * numChannels;
+
+    std::lock_guard lock(mutex_);
+    // Best fit among free blocks; failing that, regrow the largest free one rather than adding a block.
+    auto chosen = blocks_.size();
+    for (std::size_t index = 0; index < blocks_.size(); ++index) {
+        const auto& block = blocks_[index];
+        if (block.leased) {
+            continue;
+        }
+        if (chosen == blocks_.size()) {
+            chosen = index;
+            continue;
+        }
+        const auto& best = blocks_[chosen];
+        const bool fits = block.capacity >= required;
+        const bool bestFits = best.capacity >= required;
+        if (fits ? !bestFits || block.capacity < best.capacity : !bestFits && block.capacity > best.capacity) {
+            chosen = index;
+        }
+    }
+    if (chosen == blocks_.size()) {
+        blocks_.emplace_back();
+    }
+
+    auto& block = blocks_[chosen];
+    if (block.capacity < required) {
+        block.data.reset();
+        block.data.reset(static_cast<float*>(::operator new(required * sizeof(float), std::align_val_t { kAlignment })));
+        block.capacity = required;
+        // Touch every page now so the audio thread never faults them in.
+        std::memset(block.data.get(), 0, required * sizeof(float));
+    }
+    block.channels.resize(numChannels);
+    for (std::size_t index = 0; index < numChannels; ++index) {
+        block.channels[index] = block.data.get() + index * stride;
+    }
+    block.leased = true;
+
+    lease.pool_ = this;
+    lease.block_ = chosen;
+    lease.channels_ = block.channels.data();
+    lease.numChannels_ = numChannels;
+    lease.numSamples_ = numSamples;
+    lease.clear();
+    return lease;
+}
+
+std::size_t BufferPool::reservedBytes() const {
+    std::lock_guard lock(mutex_);
+    std::size_t bytes = 0;
+    for (const auto& block : blocks_) {
+        bytes += block.capacity * sizeof(float);
+    }
+    return bytes;
+}
+
+std::size_t BufferPool::leasedBytes() const {
+    std::lock_guard lock(mutex_);
+    std::size_t bytes = 0;
+    for (const auto& block : blocks_) {
+        if (block.leased) {
+            bytes += block.capacity * sizeof(float);
+        }
+    }
+    return bytes;
+}
+
+void BufferPool::trim() {
+    std::lock_guard lock(mutex_);
+    // Entries stay in place: leases refer to their block by index.
+    for (auto& block : blocks_) {
+        if (!block.leased) {
+            block.data.reset();
+            block.capacity = 0;
+            block.channels.clear();
+            block.channels.shrink_to_fit();
+        }
+    }
+}
+
+void BufferPool::release(std::size_t block) noexcept {
+    std::lock_guard lock(mutex_);
+    blocks_[block].leased = false;
+}
+
+} // namespace broadcastmix::audio
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace broadcastmix::audio {
+
+// Engine-owned scratch memory for the render path. Processors lease multichannel blocks
+// while they are prepared and hand them back when released; a lease's channels start on
+// kAlignment boundaries and every page was written when the block was allocated, so the
+// first block rendered into it takes no page faults. Released blocks are reused by the
+// next lease that fits (typically the graph replacing the one that released them), so
+// the footprint settles at the peak of two coexisting graphs during a crossfade instead
+// of growing with every rebuild. Leasing and releasing lock and may allocate; neither
+// happens on the audio thread. The pool must outlive its leases.
+class BufferPool {
+public:
+    static constexpr std::size_t kAlignment = 64;
+
+    class Lease {
+    public:
+        Lease() = default;
+        ~Lease();
+
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        [[nodiscard]] float* const* channels() const noexcept;
+        [[nodiscard]] float* channel(std::size_t index) const noexcept;
+        [[nodiscard]] std::size_t numChannels() const noexcept { return numChannels_; }
+        [[nodiscard]] std::size_t numSamples() const noexcept { return numSamples_; }
+        void clear() noexcept;
+        void reset();
+
+    private:
+        friend class BufferPool;
+
+        BufferPool* pool_ { nullptr };
+        std::size_t block_ { 0 };
+        float* const* channels_ { nullptr };
+        std::size_t numChannels_ { 0 };
+        std::size_t numSamples_ { 0 };
+    };
+
+    BufferPool() = default;
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // Returns zeroed channels; an empty request returns an empty lease.
+    [[nodiscard]] Lease lease(std::size_t numChannels, std::size_t numSamples);
+
+    [[nodiscard]] std::size_t reservedBytes() const;
+    [[nodiscard]] std::size_t leasedBytes() const;
+    // Frees every block that is not leased.
+    void trim();
+
+private:
+    struct AlignedDelete {
+        void operator()(float* data) const noexcept;
+    };
+
+    struct Block {
+        std::unique_ptr<float[], AlignedDelete> data;
+        std::size_t capacity { 0 };
+        std::vector<float*> channels;
+        bool leased { false };
+    };
+
+    void release(std::size_t block) noexcept;
+
+    mutable std::mutex mutex_;
+    std::vector<Block> blocks_;
+};
+
+} // namespace broadcastmix::audio
@@ -0,0 +1,130 @@
+#include "CompiledGraphBuilder.h"
+
+#if BROADCASTMIX_HAS_JUCE
+
+#include "CompiledGraphProcessor.h"
+#include "processors/PassThroughProcessor.h"
+
+#include "../core/Logging.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace broadcastmix::audio {
+
+CompiledGraphBuilder::CompiledGraphBuilder(std::shared_ptr<MeterStore> meterStore,
+                                           std::shared_ptr<NodeTimingStore> timingStore,
+                                           std::shared_ptr<ParameterStore> parameterStore,
+                                           std::shared_ptr<AudioWorkerPool> workerPool,
+                                           std::shared_ptr<BufferPool> bufferPool)
+    : processorFactory_(std::move(meterStore), std::move(timingStore), std::move(parameterStore))
+    , workerPool_(std::move(workerPool))
+    , bufferPool_(std::move(bufferPool)) {}
+
+std::unique_ptr<juce::AudioProcessor> CompiledGraphBuilder::buildFromTopology(const GraphTopology& topology,
+                                                                              const PlaybackConfiguration& configuration) {
+    const auto& nodes = topology.nodes();
+    std::vector<std::unique_ptr<juce::AudioProcessor>> processors;
+    std::vector<juce::AudioProcessor*> instances;
+    processors.reserve(nodes.size());
+    instances.reserve(nodes.size());
+    nodeMap_.clear();
+    for (const auto& node : nodes) {
+        processors.push_back(createProcessor(node));
+        instances.push_back(processors.back().get());
+        bindNode(node, instances.back());
+    }
+
+    auto graph = std::make_unique<CompiledGraphProcessor>(compilePlan(topology, configuration, instances),
+                                                          std::move(processors),
+                                                          configuration,
+                                                          workerPool_,
+                                                          bufferPool_);
+    processor_ = graph.get();
+    configuration_ = configuration;
+    return graph;
+}
+
+bool CompiledGraphBuilder::applyTopology(const GraphTopology& topology, const PlaybackConfiguration& configuration) {
+    if (processor_ == nullptr || !(configuration == configuration_)) {
+        return false;
+    }
+
+    const auto diff = diffTopology(nodeMap_, topology);
+    if (diff.prefersRebuild(nodeMap_.size())) {
+        return false;
+    }
+
+    const auto& nodes = topology.nodes();
+    std::vector<juce::AudioProcessor*> instances(nodes.size(), nullptr);
+    for (std::size_t index = 0; index < nodes.size(); ++index) {
+        if (const auto it = nodeMap_.find(nodes[index].id()); it != nodeMap_.end()) {
+            instances[index] = it->second.processor;
+        }
+    }
+    std::vector<std::unique_ptr<juce::AudioProcessor>> added;
+    added.reserve(diff.additions.size());
+    for (const auto index : diff.additions) {
+        added.push_back(createProcessor(nodes[index]));
+        instances[index] = added.back().get();
+    }
+    nodeMap_.clear();
+    for (std::size_t index = 0; index < nodes.size(); ++index) {
+        bindNode(nodes[index], instances[index]);
+    }
+
+    // Recompiling is pure bookkeeping over the flat plan; only the processors are expensive, and those are kept.
+    auto plan = compilePlan(topology, configuration, instances);
+    const auto steps = plan.steps.size();
+    processor_->patch(std::move(plan), std::move(instances), std::move(added));
+
+    core::log(core::LogCategory::Audio,
+              "Patched render plan: {} nodes added, {} removed, {} steps",
+              diff.additions.size(),
+              diff.removals.size(),
+              steps);
+    return true;
+}
+
+std::unique_ptr<juce::AudioProcessor> CompiledGraphBuilder::createProcessor(const GraphNode& node) {
+    auto processor = processorFactory_.createProcessorForNode(node);
+    if (!processor) {
+        core::log(core::LogCategory::Audio, "Failed to create processor for node {}", node.id());
+        processor = std::make_unique<processors::PassThroughProcessor>("Node", nullptr);
+    }
+    return processor;
+}
+
+RenderPlan CompiledGraphBuilder::compilePlan(const GraphTopology& topology,
+                                             const PlaybackConfiguration& configuration,
+                                             const std::vector<juce::AudioProcessor*>& processors) const {
+    const auto& nodes = topology.nodes();
+    RenderPlanOptions options;
+    options.hardwareInputs = static_cast<std::uint32_t>(std::max(configuration.numInputs, 0));
+    options.hardwareOutputs = static_cast<std::uint32_t>(std::max(configuration.numOutputs, 0));
+    options.isPassThrough = [&](const GraphNode& node) {
+        const auto index = static_cast<std::size_t>(&node - nodes.data());
+        return ProcessorFactory::isPassThrough(*processors[index]);
+    };
+    options.concurrentSteps = workerPool_ && workerPool_->workerCount() > 0;
+
+    auto plan = RenderPlan::compile(topology, options);
+    core::log(core::LogCategory::Audio,
+              "Compiled render plan: {} steps, {} scratch buffers for {} channels ({} aliased)",
+              plan.steps.size(),
+              plan.bufferCount,
+              plan.totalChannels,
+              plan.aliasedChannels);
+    if (plan.unorderedNodes > 0) {
+        core::log(core::LogCategory::Audio, "Render plan contains {} nodes in feedback loops", plan.unorderedNodes);
+    }
+    return plan;
+}
+
+void CompiledGraphBuilder::bindNode(const GraphNode& node, juce::AudioProcessor* processor) {
+    nodeMap_.insert_or_assign(node.id(), NodeBinding { .processor = processor, .signature = NodeSignature::of(node) });
+}
+
+} // namespace broadcastmix::audio
+
+#endif // BROADCASTMIX_HAS_JUCE
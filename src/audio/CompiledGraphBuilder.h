@@ -0,0 +1,56 @@
+#pragma once
+
+#include "AudioWorkerPool.h"
+#include "BufferPool.h"
+#include "GraphBuilder.h"
+#include "GraphTopology.h"
+#include "MeterStore.h"
+#include "NodeTimingStore.h"
+#include "ParameterStore.h"
+#include "ProcessorFactory.h"
+#include "RenderPlan.h"
+
+#if BROADCASTMIX_HAS_JUCE
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <unordered_map>
+#include <vector>
+
+namespace broadcastmix::audio {
+
+class CompiledGraphProcessor;
+
+class CompiledGraphBuilder : public GraphBuilder {
+public:
+    CompiledGraphBuilder(std::shared_ptr<MeterStore> meterStore,
+                         std::shared_ptr<NodeTimingStore> timingStore = nullptr,
+                         std::shared_ptr<ParameterStore> parameterStore = nullptr,
+                         std::shared_ptr<AudioWorkerPool> workerPool = nullptr,
+                         std::shared_ptr<BufferPool> bufferPool = nullptr);
+
+    [[nodiscard]] std::unique_ptr<juce::AudioProcessor> buildFromTopology(const GraphTopology& topology,
+                                                                          const PlaybackConfiguration& configuration) override;
+    bool applyTopology(const GraphTopology& topology, const PlaybackConfiguration& configuration) override;
+
+private:
+    struct NodeBinding {
+        juce::AudioProcessor* processor { nullptr };
+        NodeSignature signature;
+    };
+
+    CompiledGraphProcessor* processor_ { nullptr };
+    PlaybackConfiguration configuration_ {};
+    ProcessorFactory processorFactory_;
+    std::shared_ptr<AudioWorkerPool> workerPool_;
+    std::shared_ptr<BufferPool> bufferPool_;
+    std::unordered_map<std::string, NodeBinding> nodeMap_;
+
+    [[nodiscard]] std::unique_ptr<juce::AudioProcessor> createProcessor(const GraphNode& node);
+    [[nodiscard]] RenderPlan compilePlan(const GraphTopology& topology,
+                                         const PlaybackConfiguration& configuration,
+                                         const std::vector<juce::AudioProcessor*>& processors) const;
+    void bindNode(const GraphNode& node, juce::AudioProcessor* processor);
+};
+
+} // namespace broadcastmix::audio
+
+#endif // BROADCASTMIX_HAS_JUCE
@@ -0,0 +1,516 @@
+#include "CompiledGraphProcessor.h"
+
+#if BROADCASTMIX_HAS_JUCE
+
+#include "dsp/MixKernel.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace broadcastmix::audio {
+
+CompiledGraphProcessor::CompiledGraphProcessor(RenderPlan plan,
+                                               std::vector<std::unique_ptr<juce::AudioProcessor>> processors,
+                                               const PlaybackConfiguration& configuration,
+                                               std::shared_ptr<AudioWorkerPool> workerPool,
+                                               std::shared_ptr<BufferPool> bufferPool)
+    : workerPool_(std::move(workerPool))
+    , bufferPool_(bufferPool ? std::move(bufferPool) : std::make_shared<BufferPool>())
+    , owned_(std::move(processors)) {
+    setPlayConfigDetails(configuration.numInputs, configuration.numOutputs, configuration.sampleRate, configuration.blockSize);
+
+    std::vector<juce::AudioProcessor*> instances;
+    instances.reserve(owned_.size());
+    for (const auto& processor : owned_) {
+        instances.push_back(processor.get());
+    }
+    programs_.push_back(makeProgram(std::move(plan), std::move(instances)));
+    latest_ = programs_.back().get();
+    program_ = latest_;
+}
+
+std::unique_ptr<CompiledGraphProcessor::Program> CompiledGraphProcessor::makeProgram(RenderPlan plan,
+                                                                                     std::vector<juce::AudioProcessor*> processors) {
+    auto program = std::make_unique<Program>();
+    program->plan = std::move(plan);
+    program->processors = std::move(processors);
+    const auto& compiled = program->plan;
+
+    const auto stepCount = compiled.steps.size();
+    program->dependencyCounts.reserve(stepCount);
+    program->dependentOffsets.reserve(stepCount + 1);
+    for (const auto& step : compiled.steps) {
+        program->dependencyCounts.push_back(step.dependencies);
+        program->dependentOffsets.push_back(step.firstDependent);
+    }
+    program->dependentOffsets.push_back(static_cast<std::uint32_t>(compiled.dependents.size()));
+    program->pendingDependencies = std::make_unique<std::atomic<std::uint32_t>[]>(stepCount);
+
+    program->mixGains.reserve(compiled.mixInputs.size());
+    for (const auto& input : compiled.mixInputs) {
+        program->mixGains.push_back(input.gain);
+    }
+    program->stepLatencies.assign(stepCount, 0);
+    program->outputLatencies.assign(stepCount, 0);
+    program->inputDelays.assign(compiled.mixInputs.size(), 0);
+    program->delayedMixes.assign(compiled.mixes.size(), false);
+    program->delayLines.resize(compiled.delayLineCount);
+
+    program->taskGraph.taskCount = static_cast<std::uint32_t>(stepCount);
+    program->taskGraph.dependencyCounts = program->dependencyCounts.data();
+    program->taskGraph.dependentOffsets = program->dependentOffsets.data();
+    program->taskGraph.dependents = compiled.dependents.data();
+    program->taskGraph.pending = program->pendingDependencies.get();
+    return program;
+}
+
+void CompiledGraphProcessor::patch(RenderPlan plan,
+                                   std::vector<juce::AudioProcessor*> processors,
+                                   std::vector<std::unique_ptr<juce::AudioProcessor>> added) {
+    collectGarbage();
+
+    // New processors are prepared here while the audio thread keeps rendering the current plan.
+    for (auto& processor : added) {
+        if (preparedBlockSize_ > 0) {
+            processor->setRateAndBufferSizeDetails(preparedSampleRate_, preparedBlockSize_);
+            processor->prepareToPlay(preparedSampleRate_, preparedBlockSize_);
+        }
+        owned_.push_back(std::move(processor));
+    }
+
+    auto program = makeProgram(std::move(plan), std::move(processors));
+    if (preparedBlockSize_ > 0) {
+        prepareProgram(*program, preparedBlockSize_);
+    }
+    latest_ = program.get();
+    programs_.push_back(std::move(program));
+
+    // A plan that was still pending was never seen by the audio thread and can go straight away.
+    if (auto* superseded = pending_.exchange(latest_, std::memory_order_acq_rel)) {
+        destroy(superseded);
+        releaseUnusedProcessors();
+    }
+}
+
+void CompiledGraphProcessor::collectGarbage() {
+    bool released = false;
+    for (auto& slot : retired_) {
+        if (auto* program = slot.exchange(nullptr, std::memory_order_acq_rel)) {
+            destroy(program);
+            released = true;
+        }
+    }
+    if (released) {
+        releaseUnusedProcessors();
+    }
+}
+
+bool CompiledGraphProcessor::hasRetireSlot() const noexcept {
+    return std::any_of(retired_.begin(), retired_.end(), [](const auto& slot) {
+        return slot.load(std::memory_order_acquire) == nullptr;
+    });
+}
+
+void CompiledGraphProcessor::retire(Program* program) noexcept {
+    for (auto& slot : retired_) {
+        Program* expected = nullptr;
+        if (slot.compare_exchange_strong(expected, program, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+    jassertfalse; // callers check hasRetireSlot() before handing over a plan
+}
+
+void CompiledGraphProcessor::destroy(Program* program) {
+    const auto it = std::find_if(programs_.begin(), programs_.end(), [program](const auto& owned) {
+        return owned.get() == program;
+    });
+    if (it != programs_.end()) {
+        programs_.erase(it);
+    }
+}
+
+void CompiledGraphProcessor::releaseUnusedProcessors() {
+    std::unordered_set<const juce::AudioProcessor*> used;
+    for (const auto& program : programs_) {
+        used.insert(program->processors.begin(), program->processors.end());
+    }
+    for (auto it = owned_.begin(); it != owned_.end();) {
+        if (used.contains(it->get())) {
+            ++it;
+        } else {
+            (*it)->releaseResources();
+            it = owned_.erase(it);
+        }
+    }
+}
+
+const RenderPlan& CompiledGraphProcessor::plan() const noexcept {
+    return latest_->plan;
+}
+
+std::uint32_t CompiledGraphProcessor::compensatedLatency() const noexcept {
+    return latest_->compensatedLatency.load(std::memory_order_relaxed);
+}
+
+const juce::String CompiledGraphProcessor::getName() const {
+    return "Compiled Render Plan";
+}
+
+void CompiledGraphProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
+    // Nothing is rendering while the processor is prepared, so a pending plan is adopted directly.
+    collectGarbage();
+    if (auto* next = pending_.exchange(nullptr, std::memory_order_acq_rel)) {
+        destroy(program_);
+        program_ = next;
+        releaseUnusedProcessors();
+    }
+
+    preparedSampleRate_ = sampleRate;
+    preparedBlockSize_ = std::max(1, samplesPerBlock);
+    prepareProgram(*program_, preparedBlockSize_);
+    for (const auto& step : program_->plan.steps) {
+        auto& processor = *program_->processors[step.node];
+        processor.setRateAndBufferSizeDetails(preparedSampleRate_, preparedBlockSize_);
+        processor.prepareToPlay(preparedSampleRate_, preparedBlockSize_);
+    }
+    // Processors report their latency once prepared.
+    updateCompensation(*program_, true);
+}
+
+void CompiledGraphProcessor::prepareProgram(Program& program, int blockSize) const {
+    const auto& plan = program.plan;
+    // Leased before the old leases go back, so a re-prepare never hands out the block it is still using.
+    auto slots = bufferPool_->lease(std::max<std::uint32_t>(plan.bufferCount, 1), static_cast<std::size_t>(blockSize));
+    auto delayed = bufferPool_->lease(plan.delayLineCount, static_cast<std::size_t>(blockSize));
+    auto delayStorage = bufferPool_->lease(plan.delayLineCount,
+                                           dsp::DelayLine::storageSize(kMaxCompensationSamples, static_cast<std::size_t>(blockSize)));
+    program.slots = std::move(slots);
+    program.delayed = std::move(delayed);
+    program.delayStorage = std::move(delayStorage);
+
+    program.slotPointers.assign(program.slots.channels(), program.slots.channels() + program.slots.numChannels());
+
+    program.mixSources.resize(plan.mixInputs.size());
+    for (std::size_t index = 0; index < plan.mixInputs.size(); ++index) {
+        program.mixSources[index] = program.slotPointers[plan.mixInputs[index].source];
+    }
+
+    program.channelPointers.resize(plan.channelBuffers.size());
+    for (std::size_t index = 0; index < plan.channelBuffers.size(); ++index) {
+        program.channelPointers[index] = program.slotPointers[plan.channelBuffers[index]];
+    }
+
+    program.stepViews.clear();
+    program.stepViews.reserve(plan.steps.size());
+    program.stagingBuffers.clear();
+    program.stagingBuffers.reserve(plan.steps.size());
+    for (const auto& step : plan.steps) {
+        program.stepViews.emplace_back(program.channelPointers.data() + step.firstChannel, static_cast<int>(step.numChannels), blockSize);
+        if (step.numChannels >= kInlineChannelPointers) {
+            program.stagingBuffers.emplace_back(static_cast<int>(step.numChannels), blockSize);
+        } else {
+            program.stagingBuffers.emplace_back();
+        }
+    }
+
+    program.midiBuffers.resize(plan.steps.size());
+    for (auto& midi : program.midiBuffers) {
+        midi.ensureSize(256);
+    }
+
+    program.delayPointers.resize(plan.delayLineCount);
+    for (std::uint32_t line = 0; line < plan.delayLineCount; ++line) {
+        program.delayLines[line].prepare(program.delayStorage.channel(line), kMaxCompensationSamples, static_cast<std::size_t>(blockSize));
+        program.delayPointers[line] = program.delayed.channel(line);
+    }
+    // Kept processors already report their latency; a patched plan starts out compensated.
+    updateCompensation(program, true);
+}
+
+void CompiledGraphProcessor::releaseProgram(Program& program) {
+    program.stepViews.clear();
+    program.stagingBuffers.clear();
+    program.channelPointers.clear();
+    program.mixSources.clear();
+    program.delayPointers.clear();
+    program.delayed.reset();
+    // Lines must not keep pointing into storage that went back to the pool.
+    for (auto& line : program.delayLines) {
+        line = dsp::DelayLine {};
+    }
+    program.delayStorage.reset();
+    program.slotPointers.clear();
+    program.slots.reset();
+}
+
+void CompiledGraphProcessor::releaseResources() {
+    for (auto& processor : owned_) {
+        processor->releaseResources();
+    }
+    for (auto& program : programs_) {
+        releaseProgram(*program);
+    }
+    preparedBlockSize_ = 0;
+}
+
+void CompiledGraphProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+    midiMessages.clear();
+    if (hasRetireSlot()) {
+        if (auto* next = pending_.exchange(nullptr, std::memory_order_acq_rel)) {
+            retire(program_);
+            program_ = next;
+        }
+    }
+
+    auto& program = *program_;
+    const auto capacity = static_cast<int>(program.slots.numSamples());
+    if (capacity == 0) {
+        buffer.clear();
+        return;
+    }
+
+    updateCompensation(program, false);
+    for (int start = 0; start < buffer.getNumSamples(); start += capacity) {
+        renderChunk(program, buffer, start, std::min(capacity, buffer.getNumSamples() - start));
+    }
+}
+
+void CompiledGraphProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages) {
+    midiMessages.clear();
+    buffer.clear();
+}
+
+void CompiledGraphProcessor::renderChunk(Program& program, juce::AudioBuffer<float>& buffer, int startSample, int numSamples) {
+    const auto& plan = program.plan;
+    const auto hostChannels = buffer.getNumChannels();
+
+    // Inputs and outputs share host channels, so every hardware input is captured before any output is written.
+    for (std::size_t channel = 0; channel < plan.hardwareInputBuffers.size(); ++channel) {
+        const auto slot = plan.hardwareInputBuffers[channel];
+        if (slot == RenderPlan::kNoBuffer) {
+            continue;
+        }
+        auto* destination = program.slotPointers[slot];
+        if (static_cast<int>(channel) < hostChannels) {
+            juce::FloatVectorOperations::copy(destination, buffer.getReadPointer(static_cast<int>(channel), startSample), numSamples);
+        } else {
+            juce::FloatVectorOperations::clear(destination, numSamples);
+        }
+    }
+
+    if (workerPool_ && plan.concurrent) {
+        chunkSamples_ = numSamples;
+        workerPool_->run(program.taskGraph, &CompiledGraphProcessor::renderStepTask, this);
+        for (const auto& step : plan.steps) {
+            writeOutputs(program, step, buffer, startSample, numSamples);
+        }
+    } else {
+        for (std::uint32_t stepIndex = 0; stepIndex < plan.steps.size(); ++stepIndex) {
+            renderStep(program, stepIndex, numSamples);
+            writeOutputs(program, plan.steps[stepIndex], buffer, startSample, numSamples);
+        }
+    }
+
+    for (const auto channel : plan.silentHardwareOutputs) {
+        if (static_cast<int>(channel) < hostChannels) {
+            buffer.clear(static_cast<int>(channel), startSample, numSamples);
+        }
+    }
+    for (auto channel = getTotalNumOutputChannels(); channel < hostChannels; ++channel) {
+        buffer.clear(channel, startSample, numSamples);
+    }
+}
+
+void CompiledGraphProcessor::renderStepTask(void* context, std::uint32_t step) {
+    auto& processor = *static_cast<CompiledGraphProcessor*>(context);
+    processor.renderStep(*processor.program_, step, processor.chunkSamples_);
+}
+
+void CompiledGraphProcessor::renderStep(Program& program, std::uint32_t stepIndex, int numSamples) {
+    const auto& plan = program.plan;
+    const auto& step = plan.steps[stepIndex];
+
+    for (std::uint32_t index = step.firstMix; index < step.firstMix + step.numMixes; ++index) {
+        const auto& mix = plan.mixes[index];
+        auto* destination = program.slotPointers[mix.destination];
+        switch (mix.kind) {
+        case RenderPlan::MixKind::Clear:
+            juce::FloatVectorOperations::clear(destination, numSamples);
+            break;
+        case RenderPlan::MixKind::Copy: {
+            if (program.delayedMixes[index]) {
+                delayInputs(program, mix, numSamples);
+            }
+            const auto* source = mix.numInputs > 0 ? program.mixSources[mix.firstInput] : program.slotPointers[mix.source];
+            if (source != destination) {
+                juce::FloatVectorOperations::copy(destination, source, numSamples);
+            }
+            break;
+        }
+        case RenderPlan::MixKind::Sum:
+            if (program.delayedMixes[index]) {
+                delayInputs(program, mix, numSamples);
+            }
+            dsp::sumInto(destination,
+                         program.mixSources.data() + mix.firstInput,
+                         program.mixGains.data() + mix.firstInput,
+                         mix.numInputs,
+                         static_cast<std::size_t>(numSamples));
+            break;
+        }
+    }
+
+    auto& midi = program.midiBuffers[stepIndex];
+    auto& processor = *program.processors[step.node];
+    auto* const* channels = program.channelPointers.data() + step.firstChannel;
+    const auto numChannels = static_cast<int>(step.numChannels);
+    if (static_cast<std::size_t>(numSamples) == program.slots.numSamples()) {
+        processor.processBlock(program.stepViews[stepIndex], midi);
+    } else if (step.numChannels < kInlineChannelPointers) {
+        juce::AudioBuffer<float> view(channels, numChannels, numSamples);
+        processor.processBlock(view, midi);
+    } else {
+        // A view this wide would allocate its pointer table, so the short chunk goes through
+        // storage sized when the plan was prepared; shrinking it in place never reallocates.
+        auto& staging = program.stagingBuffers[stepIndex];
+        staging.setSize(numChannels, numSamples, false, false, true);
+        for (int channel = 0; channel < numChannels; ++channel) {
+            juce::FloatVectorOperations::copy(staging.getWritePointer(channel), channels[channel], numSamples);
+        }
+        processor.processBlock(staging, midi);
+        for (int channel = 0; channel < numChannels; ++channel) {
+            juce::FloatVectorOperations::copy(channels[channel], staging.getReadPointer(channel), numSamples);
+        }
+    }
+    midi.clear();
+}
+
+void CompiledGraphProcessor::updateCompensation(Program& program, bool force) noexcept {
+    const auto& plan = program.plan;
+    bool changed = force;
+    for (std::uint32_t stepIndex = 0; stepIndex < plan.steps.size(); ++stepIndex) {
+        const auto latency = static_cast<std::uint32_t>(std::max(0, program.processors[plan.steps[stepIndex].node]->getLatencySamples()));
+        if (latency != program.stepLatencies[stepIndex]) {
+            program.stepLatencies[stepIndex] = latency;
+            changed = true;
+        }
+    }
+    if (!changed || program.mixSources.size() != plan.mixInputs.size()) {
+        return;
+    }
+
+    plan.computeCompensation(program.stepLatencies.data(), program.outputLatencies.data(), program.inputDelays.data());
+
+    for (std::uint32_t mixIndex = 0; mixIndex < plan.mixes.size(); ++mixIndex) {
+        const auto& mix = plan.mixes[mixIndex];
+        bool delayed = false;
+        for (std::uint32_t index = mix.firstInput; index < mix.firstInput + mix.numInputs; ++index) {
+            const auto& input = plan.mixInputs[index];
+            program.inputDelays[index] = input.delayLine == RenderPlan::kNoDelayLine
+                ? 0
+                : std::min(program.inputDelays[index], kMaxCompensationSamples);
+            if (program.inputDelays[index] == 0) {
+                program.mixSources[index] = program.slotPointers[input.source];
+                continue;
+            }
+            // A line that was idle holds audio from whenever it last ran; start it from silence.
+            auto* line = program.delayPointers[input.delayLine];
+            if (program.mixSources[index] != line) {
+                program.delayLines[input.delayLine].reset();
+                program.mixSources[index] = line;
+            }
+            delayed = true;
+        }
+        program.delayedMixes[mixIndex] = delayed;
+    }
+
+    std::uint32_t latency = 0;
+    for (std::uint32_t stepIndex = 0; stepIndex < plan.steps.size(); ++stepIndex) {
+        if (plan.steps[stepIndex].numOutputs > 0) {
+            latency = std::max(latency, program.outputLatencies[stepIndex]);
+        }
+    }
+    program.compensatedLatency.store(latency, std::memory_order_relaxed);
+}
+
+void CompiledGraphProcessor::delayInputs(Program& program, const RenderPlan::MixOp& mix, int numSamples) noexcept {
+    for (std::uint32_t index = mix.firstInput; index < mix.firstInput + mix.numInputs; ++index) {
+        if (program.inputDelays[index] == 0) {
+            continue;
+        }
+        const auto& input = program.plan.mixInputs[index];
+        program.delayLines[input.delayLine].process(program.slotPointers[input.source],
+                                                    program.delayPointers[input.delayLine],
+                                                    static_cast<std::size_t>(numSamples),
+                                                    program.inputDelays[index]);
+    }
+}
+
+void CompiledGraphProcessor::writeOutputs(const Program& program,
+                                          const RenderPlan::Step& step,
+                                          juce::AudioBuffer<float>& buffer,
+                                          int startSample,
+                                          int numSamples) {
+    for (std::uint32_t index = step.firstOutput; index < step.firstOutput + step.numOutputs; ++index) {
+        const auto& output = program.plan.outputs[index];
+        if (static_cast<int>(output.hardwareChannel) >= buffer.getNumChannels()) {
+            continue;
+        }
+        const auto* source = program.slotPointers[output.source];
+        auto* destination = buffer.getWritePointer(static_cast<int>(output.hardwareChannel), startSample);
+        if (output.accumulate) {
+            juce::FloatVectorOperations::add(destination, source, numSamples);
+        } else {
+            juce::FloatVectorOperations::copy(destination, source, numSamples);
+        }
+    }
+}
+
+bool CompiledGraphProcessor::acceptsMidi() const {
+    return false;
+}
+
+bool CompiledGraphProcessor::producesMidi() const {
+    return false;
+}
+
+bool CompiledGraphProcessor::isMidiEffect() const {
+    return false;
+}
+
+double CompiledGraphProcessor::getTailLengthSeconds() const {
+    return 0.0;
+}
+
+bool CompiledGraphProcessor::hasEditor() const {
+    return false;
+}
+
+juce::AudioProcessorEditor* CompiledGraphProcessor::createEditor() {
+    return nullptr;
+}
+
+int CompiledGraphProcessor::getNumPrograms() {
+    return 1;
+}
+
+int CompiledGraphProcessor::getCurrentProgram() {
+    return 0;
+}
+
+void CompiledGraphProcessor::setCurrentProgram(int) {}
+
+const juce::String CompiledGraphProcessor::getProgramName(int) {
+    return "Default";
+}
+
+void CompiledGraphProcessor::changeProgramName(int, const juce::String&) {}
+
+void CompiledGraphProcessor::getStateInformation(juce::MemoryBlock&) {}
+
+void CompiledGraphProcessor::setStateInformation(const void*, int) {}
+
+} // namespace broadcastmix::audio
+
+#endif // BROADCASTMIX_HAS_JUCE
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "AudioWorkerPool.h"
+#include "BufferPool.h"
+#include "GraphSwapPlayer.h"
+#include "RenderPlan.h"
+#include "dsp/DelayLine.h"
+
+#if BROADCASTMIX_HAS_JUCE
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace broadcastmix::audio {
+
+// Executes a RenderPlan: one set of scratch slots, leased from the engine's BufferPool,
+// shared by every node. Steps run in plan order, or across the worker pool when the
+// plan was compiled for concurrency.
+// Processor latencies are polled at the start of every block; when one changes, the
+// compensation delays are recomputed in place, so a plugin reporting new latency is
+// realigned without rebuilding the graph.
+// Topology edits are patched in: the message thread prepares a plan recompiled around
+// the existing processor instances and the audio thread adopts it at a block boundary,
+// so processors that survive the edit keep their DSP state.
+class CompiledGraphProcessor : public juce::AudioProcessor {
+public:
+    static constexpr std::uint32_t kMaxCompensationSamples = 8192;
+
+    CompiledGraphProcessor(RenderPlan plan,
+                           std::vector<std::unique_ptr<juce::AudioProcessor>> processors,
+                           const PlaybackConfiguration& configuration,
+                           std::shared_ptr<AudioWorkerPool> workerPool = nullptr,
+                           std::shared_ptr<BufferPool> bufferPool = nullptr);
+
+    // Replaces the plan without touching processors it keeps. processors holds one entry
+    // per plan node, either an instance this processor already owns or one of added.
+    // Message thread only.
+    void patch(RenderPlan plan,
+               std::vector<juce::AudioProcessor*> processors,
+               std::vector<std::unique_ptr<juce::AudioProcessor>> added);
+    // Frees plans the audio thread has moved past, and processors no remaining plan uses.
+    void collectGarbage();
+
+    // The most recently compiled or patched plan.
+    [[nodiscard]] const RenderPlan& plan() const noexcept;
+    // Latency of the slowest path to any output, in samples.
+    [[nodiscard]] std::uint32_t compensatedLatency() const noexcept;
+
+    const juce::String getName() const override;
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+    bool hasEditor() const override;
+    juce::AudioProcessorEditor* createEditor() override;
+
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram(int index) override;
+    const juce::String getProgramName(int index) override;
+    void changeProgramName(int index, const juce::String& newName) override;
+
+    void getStateInformation(juce::MemoryBlock& destData) override;
+    void setStateInformation(const void* data, int sizeInBytes) override;
+
+private:
+    static constexpr std::size_t kRetireSlots = 8;
+    // juce::AudioBuffer stores fewer channel pointers than this inline and allocates for the rest.
+    static constexpr std::uint32_t kInlineChannelPointers = 32;
+
+    // One compiled plan and everything sized from it.
+    struct Program {
+        RenderPlan plan;
+        std::vector<juce::AudioProcessor*> processors;
+        std::vector<std::uint32_t> dependencyCounts;
+        std::vector<std::uint32_t> dependentOffsets;
+        std::unique_ptr<std::atomic<std::uint32_t>[]> pendingDependencies;
+        AudioTaskGraph taskGraph {};
+
+        BufferPool::Lease slots;
+        std::vector<float*> slotPointers;
+        std::vector<const float*> mixSources;
+        std::vector<float> mixGains;
+        std::vector<std::uint32_t> stepLatencies;
+        std::vector<std::uint32_t> outputLatencies;
+        std::vector<std::uint32_t> inputDelays;
+        std::vector<bool> delayedMixes;
+        std::vector<dsp::DelayLine> delayLines;
+        // One channel of history per delay line, and one block of delayed output per line.
+        BufferPool::Lease delayStorage;
+        BufferPool::Lease delayed;
+        std::vector<float*> delayPointers;
+        std::atomic<std::uint32_t> compensatedLatency { 0 };
+        std::vector<float*> channelPointers;
+        std::vector<juce::AudioBuffer<float>> stepViews;
+        // Owned storage for steps too wide for a stack view, used when a chunk is shorter than a block.
+        // The only render memory outside the pool: a juce::AudioBuffer this wide can only shrink
+        // without reallocating when it owns its samples.
+        std::vector<juce::AudioBuffer<float>> stagingBuffers;
+        std::vector<juce::MidiBuffer> midiBuffers;
+    };
+
+    static void renderStepTask(void* context, std::uint32_t step);
+
+    [[nodiscard]] static std::unique_ptr<Program> makeProgram(RenderPlan plan, std::vector<juce::AudioProcessor*> processors);
+    void prepareProgram(Program& program, int blockSize) const;
+    static void releaseProgram(Program& program);
+    [[nodiscard]] bool hasRetireSlot() const noexcept;
+    void retire(Program* program) noexcept;
+    void destroy(Program* program);
+    void releaseUnusedProcessors();
+
+    void renderChunk(Program& program, juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void renderStep(Program& program, std::uint32_t stepIndex, int numSamples);
+    static void updateCompensation(Program& program, bool force) noexcept;
+    static void delayInputs(Program& program, const RenderPlan::MixOp& mix, int numSamples) noexcept;
+    static void writeOutputs(const Program& program,
+                             const RenderPlan::Step& step,
+                             juce::AudioBuffer<float>& buffer,
+                             int startSample,
+                             int numSamples);
+
+    std::shared_ptr<AudioWorkerPool> workerPool_;
+    std::shared_ptr<BufferPool> bufferPool_;
+
+    // Message thread: every processor and plan still alive, and the rate they were last prepared at.
+    std::vector<std::unique_ptr<juce::AudioProcessor>> owned_;
+    std::vector<std::unique_ptr<Program>> programs_;
+    Program* latest_ { nullptr };
+    double preparedSampleRate_ { 0.0 };
+    int preparedBlockSize_ { 0 };
+
+    std::atomic<Program*> pending_ { nullptr };
+    std::array<std::atomic<Program*>, kRetireSlots> retired_ {};
+
+    // Audio thread.
+    Program* program_ { nullptr };
+    int chunkSamples_ { 0 };
+};
+
+} // namespace broadcastmix::audio
+
+#endif // BROADCASTMIX_HAS_JUCE
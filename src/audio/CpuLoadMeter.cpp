@@ -0,0 +1,57 @@
+#include "CpuLoadMeter.h"
+
+#include <algorithm>
+
+namespace broadcastmix::audio {
+
+CpuLoadMeter::CpuLoadMeter() {
+    for (auto& bin : histogram_) {
+        bin.store(0, std::memory_order_relaxed);
+    }
+}
+
+void CpuLoadMeter::record(double callbackSeconds, double blockSeconds) noexcept {
+    if (blockSeconds <= 0.0) {
+        return;
+    }
+
+    // Reset is applied here so the audio thread stays the only writer of the statistics.
+    if (resetRequested_.exchange(false, std::memory_order_acq_rel)) {
+        average_ = 0.0;
+        peak_ = 0.0;
+        for (auto& bin : histogram_) {
+            bin.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    const auto load = callbackSeconds / blockSeconds;
+    const auto smoothing = std::min(1.0, blockSeconds / kAveragingSeconds);
+    average_ += (load - average_) * smoothing;
+    peak_ = std::max(peak_, load);
+
+    // Ten 10% bins; the last bin collects every callback that overran its block.
+    const auto bin = std::min(static_cast<std::size_t>(std::max(load, 0.0) * 10.0), kHistogramBins - 1);
+    histogram_[bin].store(histogram_[bin].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    current_.store(load, std::memory_order_relaxed);
+    publishedAverage_.store(average_, std::memory_order_relaxed);
+    publishedPeak_.store(peak_, std::memory_order_relaxed);
+}
+
+void CpuLoadMeter::reset() noexcept {
+    current_.store(0.0, std::memory_order_relaxed);
+    publishedAverage_.store(0.0, std::memory_order_relaxed);
+    publishedPeak_.store(0.0, std::memory_order_relaxed);
+    resetRequested_.store(true, std::memory_order_release);
+}
+
+void CpuLoadMeter::fill(AudioEngineStatus& status) const noexcept {
+    status.cpuLoad = current_.load(std::memory_order_relaxed);
+    status.cpuLoadAverage = publishedAverage_.load(std::memory_order_relaxed);
+    status.cpuLoadPeak = publishedPeak_.load(std::memory_order_relaxed);
+    for (std::size_t bin = 0; bin < kHistogramBins; ++bin) {
+        status.cpuLoadHistogram[bin] = histogram_[bin].load(std::memory_order_relaxed);
+    }
+}
+
+} // namespace broadcastmix::audio
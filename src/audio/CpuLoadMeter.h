@@ -0,0 +1,36 @@
+#pragma once
+
+#include "AudioEngine.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <tuple>
+
+namespace broadcastmix::audio {
+
+// Callback time as a fraction of the block period. record() is called by the audio
+// thread only and never allocates or locks; readers see the last published values.
+class CpuLoadMeter {
+public:
+    static constexpr std::size_t kHistogramBins = std::tuple_size_v<decltype(AudioEngineStatus::cpuLoadHistogram)>;
+    static constexpr double kAveragingSeconds = 1.0;
+
+    CpuLoadMeter();
+
+    void record(double callbackSeconds, double blockSeconds) noexcept;
+    void reset() noexcept;
+    void fill(AudioEngineStatus& status) const noexcept;
+
+private:
+    double average_ { 0.0 };
+    double peak_ { 0.0 };
+
+    std::atomic<double> current_ { 0.0 };
+    std::atomic<double> publishedAverage_ { 0.0 };
+    std::atomic<double> publishedPeak_ { 0.0 };
+    std::array<std::atomic<std::uint64_t>, kHistogramBins> histogram_ {};
+    std::atomic<bool> resetRequested_ { false };
+};
+
+} // namespace broadcastmix::audio
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "GraphSwapPlayer.h"
+#include "GraphTopology.h"
+
+#if BROADCASTMIX_HAS_JUCE
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace broadcastmix::audio {
+
+// The parts of a node its processor is built from; a node whose signature still matches keeps its instance.
+struct NodeSignature {
+    GraphNodeType type { GraphNodeType::Channel };
+    std::uint32_t inputChannels { 0 };
+    std::uint32_t outputChannels { 0 };
+    std::string label;
+
+    [[nodiscard]] static NodeSignature of(const GraphNode& node) {
+        return { .type = node.type(),
+                 .inputChannels = node.inputChannelCount(),
+                 .outputChannels = node.outputChannelCount(),
+                 .label = node.label() };
+    }
+
+    [[nodiscard]] bool matches(const GraphNode& node) const {
+        if (type != node.type() || inputChannels != node.inputChannelCount() || outputChannels != node.outputChannelCount()) {
+            return false;
+        }
+        // Utility labels select the processor kind (e.g. the monitor trim gain stage); other labels are cosmetic.
+        return type != GraphNodeType::Utility || label == node.label();
+    }
+};
+
+// Node-level changes between the processors a builder holds and a new topology.
+struct TopologyDiff {
+    // Indices into the topology's nodes that need a new processor.
+    std::vector<std::size_t> additions;
+    // Bound node ids whose processor is dropped, including those being replaced.
+    std::vector<std::string> removals;
+
+    // Replacing most of the graph in place gains nothing over building a fresh one and swapping it in.
+    [[nodiscard]] bool prefersRebuild(std::size_t boundNodes) const noexcept {
+        return boundNodes != 0 && (additions.size() + removals.size()) > boundNodes;
+    }
+};
+
+// Bindings are keyed by node id and carry the NodeSignature their processor was built from.
+template <typename Binding>
+[[nodiscard]] TopologyDiff diffTopology(const std::unordered_map<std::string, Binding>& bindings, const GraphTopology& topology) {
+    const auto& nodes = topology.nodes();
+    TopologyDiff diff;
+    std::unordered_set<std::string> wanted;
+    wanted.reserve(nodes.size());
+    for (std::size_t index = 0; index < nodes.size(); ++index) {
+        const auto& node = nodes[index];
+        wanted.insert(node.id());
+        const auto it = bindings.find(node.id());
+        if (it == bindings.end()) {
+            diff.additions.push_back(index);
+        } else if (!it->second.signature.matches(node)) {
+            diff.removals.push_back(node.id());
+            diff.additions.push_back(index);
+        }
+    }
+    for (const auto& [id, binding] : bindings) {
+        if (!wanted.contains(id)) {
+            diff.removals.push_back(id);
+        }
+    }
+    return diff;
+}
+
+class GraphBuilder {
+public:
+    virtual ~GraphBuilder() = default;
+
+    [[nodiscard]] virtual std::unique_ptr<juce::AudioProcessor> buildFromTopology(const GraphTopology& topology,
+                                                                                  const PlaybackConfiguration& configuration) = 0;
+    virtual bool applyTopology(const GraphTopology& topology, const PlaybackConfiguration& configuration) = 0;
+};
+
+} // namespace broadcastmix::audio
+
+#endif // BROADCASTMIX_HAS_JUCE
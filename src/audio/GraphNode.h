@@ -25,6 +25,11 @@ struct GraphConnection {
     std::uint32_t fromChannel { 0 };
     std::string toNodeId;
     std::uint32_t toChannel { 0 };
+    // Linear crosspoint gain applied where this connection is summed into its destination.
+    float gain { 1.0F };
+    // Spread a mono source across every channel of the destination, or fold every source
+    // channel into a mono destination. Otherwise only fromChannel feeds toChannel.
+    bool fanOut { false };
 };
 
 class GraphNode {
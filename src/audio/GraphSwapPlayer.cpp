@@ -0,0 +1,336 @@
+#include "GraphSwapPlayer.h"
+
+#if BROADCASTMIX_HAS_JUCE
+
+#include "RealtimeScope.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace broadcastmix::audio {
+
+GraphSwapPlayer::GraphSwapPlayer() = default;
+
+GraphSwapPlayer::~GraphSwapPlayer() {
+    for (auto& processor : owned_) {
+        processor->releaseResources();
+    }
+}
+
+void GraphSwapPlayer::setConfiguration(const PlaybackConfiguration& configuration) {
+    configuration_ = configuration;
+}
+
+PlaybackConfiguration GraphSwapPlayer::configuration() const noexcept {
+    return configuration_;
+}
+
+void GraphSwapPlayer::setCrossfadeMilliseconds(double milliseconds) noexcept {
+    crossfadeMilliseconds_.store(std::max(0.0, milliseconds), std::memory_order_relaxed);
+}
+
+void GraphSwapPlayer::submit(std::unique_ptr<juce::AudioProcessor> processor) {
+    collectGarbage();
+    if (!processor) {
+        return;
+    }
+
+    prepareProcessor(*processor);
+    latest_ = processor.get();
+    owned_.push_back(std::move(processor));
+
+    // A processor that was still pending was never seen by the audio thread and can go straight away.
+    if (auto* superseded = pending_.exchange(latest_, std::memory_order_acq_rel)) {
+        destroy(superseded);
+    }
+}
+
+juce::AudioProcessor* GraphSwapPlayer::current() const noexcept {
+    return latest_;
+}
+
+void GraphSwapPlayer::collectGarbage() {
+    for (auto& slot : retired_) {
+        if (auto* processor = slot.exchange(nullptr, std::memory_order_acq_rel)) {
+            destroy(processor);
+        }
+    }
+}
+
+CpuLoadMeter& GraphSwapPlayer::loadMeter() noexcept {
+    return loadMeter_;
+}
+
+const CpuLoadMeter& GraphSwapPlayer::loadMeter() const noexcept {
+    return loadMeter_;
+}
+
+void GraphSwapPlayer::setXrunJournal(XrunJournal* journal) noexcept {
+    xrunJournal_.store(journal, std::memory_order_release);
+}
+
+void GraphSwapPlayer::setSnapshotRecaller(SnapshotRecaller* recaller) noexcept {
+    snapshotRecaller_.store(recaller, std::memory_order_release);
+}
+
+void GraphSwapPlayer::setCommandQueue(AudioCommandQueue* commands) noexcept {
+    commandQueue_.store(commands, std::memory_order_release);
+}
+
+void GraphSwapPlayer::setRoutingMatrix(RoutingMatrix* matrix) noexcept {
+    routingMatrix_.store(matrix, std::memory_order_release);
+}
+
+void GraphSwapPlayer::setTopologyVersion(std::uint64_t version) noexcept {
+    topologyVersion_.store(version, std::memory_order_relaxed);
+}
+
+void GraphSwapPlayer::destroy(juce::AudioProcessor* processor) {
+    const auto it = std::find_if(owned_.begin(), owned_.end(), [processor](const auto& owned) {
+        return owned.get() == processor;
+    });
+    if (it != owned_.end()) {
+        (*it)->releaseResources();
+        owned_.erase(it);
+    }
+}
+
+void GraphSwapPlayer::prepareProcessor(juce::AudioProcessor& processor) const {
+    processor.releaseResources();
+    processor.setPlayConfigDetails(configuration_.numInputs,
+                                   configuration_.numOutputs,
+                                   configuration_.sampleRate,
+                                   configuration_.blockSize);
+    processor.prepareToPlay(configuration_.sampleRate, configuration_.blockSize);
+}
+
+bool GraphSwapPlayer::hasRetireSlot() const noexcept {
+    return std::any_of(retired_.begin(), retired_.end(), [](const auto& slot) {
+        return slot.load(std::memory_order_acquire) == nullptr;
+    });
+}
+
+void GraphSwapPlayer::retire(juce::AudioProcessor* processor) noexcept {
+    for (auto& slot : retired_) {
+        juce::AudioProcessor* expected = nullptr;
+        if (slot.compare_exchange_strong(expected, processor, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+    jassertfalse; // callers check hasRetireSlot() before handing over a processor
+}
+
+void GraphSwapPlayer::audioDeviceAboutToStart(juce::AudioIODevice* device) {
+    device_ = device;
+    deviceXruns_ = device != nullptr ? std::max(0, device->getXRunCount()) : 0;
+    if (device != nullptr) {
+        configuration_.sampleRate = device->getCurrentSampleRate();
+        configuration_.blockSize = device->getCurrentBufferSizeSamples();
+        configuration_.numInputs = device->getActiveInputChannels().countNumberOfSetBits();
+        configuration_.numOutputs = device->getActiveOutputChannels().countNumberOfSetBits();
+    }
+
+    const auto channels = std::max({ configuration_.numInputs, configuration_.numOutputs, 1 });
+    chunkCapacity_ = std::max(1, configuration_.blockSize);
+    mainBuffer_.setSize(channels, chunkCapacity_, false, true, false);
+    fadeBuffer_.setSize(channels, chunkCapacity_, false, true, false);
+    midi_.ensureSize(256);
+    if (device != nullptr) {
+        chunkInputs_.assign(static_cast<std::size_t>(device->getInputChannelNames().size()), nullptr);
+        chunkOutputs_.assign(static_cast<std::size_t>(device->getOutputChannelNames().size()), nullptr);
+    }
+
+    if (fadingOut_ != nullptr) {
+        retire(fadingOut_);
+        fadingOut_ = nullptr;
+    }
+    if (auto* next = pending_.exchange(nullptr, std::memory_order_acq_rel)) {
+        if (active_ != nullptr) {
+            retire(active_);
+        }
+        active_ = next;
+    }
+
+    if (active_ != nullptr) {
+        prepareProcessor(*active_);
+    }
+    collectGarbage();
+}
+
+void GraphSwapPlayer::audioDeviceStopped() {
+    device_ = nullptr;
+    if (fadingOut_ != nullptr) {
+        retire(fadingOut_);
+        fadingOut_ = nullptr;
+    }
+    if (active_ != nullptr) {
+        active_->releaseResources();
+    }
+}
+
+void GraphSwapPlayer::audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
+                                                       int numInputChannels,
+                                                       float* const* outputChannelData,
+                                                       int numOutputChannels,
+                                                       int numSamples,
+                                                       const juce::AudioIODeviceCallbackContext&) {
+    const RealtimeScope realtime;
+    const auto callbackStart = std::chrono::steady_clock::now();
+
+    if (fadingOut_ == nullptr && hasRetireSlot()) {
+        if (auto* next = pending_.exchange(nullptr, std::memory_order_acq_rel)) {
+            if (active_ == nullptr) {
+                active_ = next;
+            } else {
+                fadingOut_ = active_;
+                active_ = next;
+                fadePosition_ = 0;
+                fadeLength_ = std::max(1, juce::roundToInt(crossfadeMilliseconds_.load(std::memory_order_relaxed)
+                                                          * configuration_.sampleRate / 1000.0));
+            }
+        }
+    }
+
+    if (auto* commands = commandQueue_.load(std::memory_order_acquire)) {
+        commands->drain();
+    }
+    if (auto* recaller = snapshotRecaller_.load(std::memory_order_acquire)) {
+        recaller->advance(static_cast<std::size_t>(numSamples), configuration_.sampleRate);
+    }
+    matrix_ = routingMatrix_.load(std::memory_order_acquire);
+    if (matrix_ != nullptr && (static_cast<std::size_t>(numInputChannels) > chunkInputs_.size()
+                               || static_cast<std::size_t>(numOutputChannels) > chunkOutputs_.size())) {
+        matrix_ = nullptr; // more channels than were announced; fall back to the direct patch
+    }
+    if (matrix_ != nullptr) {
+        matrix_->update();
+    }
+
+    for (int offset = 0; offset < numSamples; offset += chunkCapacity_) {
+        renderChunk(inputChannelData, numInputChannels, outputChannelData, numOutputChannels,
+                    offset, std::min(chunkCapacity_, numSamples - offset));
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - callbackStart;
+    const auto blockSeconds = static_cast<double>(numSamples) / configuration_.sampleRate;
+    loadMeter_.record(std::chrono::duration<double>(elapsed).count(), blockSeconds);
+    recordXruns(elapsed, blockSeconds);
+}
+
+void GraphSwapPlayer::recordXruns(std::chrono::steady_clock::duration elapsed, double blockSeconds) noexcept {
+    auto* journal = xrunJournal_.load(std::memory_order_acquire);
+    if (journal == nullptr) {
+        return;
+    }
+
+    XrunEvent event;
+    event.callbackNanoseconds = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    event.deadlineNanoseconds = static_cast<std::uint64_t>(blockSeconds * 1.0e9);
+    event.topologyVersion = topologyVersion_.load(std::memory_order_relaxed);
+
+    const auto deviceXruns = device_ != nullptr ? device_->getXRunCount() : -1;
+    if (deviceXruns > deviceXruns_) {
+        event.kind = XrunKind::DeviceXrun;
+        event.deviceXruns = static_cast<std::uint32_t>(deviceXruns - deviceXruns_);
+        event.timestampMicroseconds = XrunJournal::nowMicroseconds();
+        journal->push(event);
+        deviceXruns_ = deviceXruns;
+    }
+
+    if (event.callbackNanoseconds > event.deadlineNanoseconds) {
+        event.kind = XrunKind::DeadlineMiss;
+        event.deviceXruns = 0;
+        event.timestampMicroseconds = XrunJournal::nowMicroseconds();
+        journal->push(event);
+    }
+}
+
+void GraphSwapPlayer::renderChunk(const float* const* inputs,
+                                  int numInputs,
+                                  float* const* outputs,
+                                  int numOutputs,
+                                  int offset,
+                                  int numSamples) {
+    const auto writableOutputs = std::min(numOutputs, mainBuffer_.getNumChannels());
+    for (int channel = 0; channel < numOutputs; ++channel) {
+        if (outputs[channel] != nullptr && (active_ == nullptr || channel >= writableOutputs)) {
+            juce::FloatVectorOperations::clear(outputs[channel] + offset, numSamples);
+        }
+    }
+    if (active_ == nullptr) {
+        return;
+    }
+
+    renderInto(*active_, mainBuffer_, inputs, numInputs, offset, numSamples);
+
+    if (fadingOut_ != nullptr) {
+        renderInto(*fadingOut_, fadeBuffer_, inputs, numInputs, offset, numSamples);
+
+        const auto startGain = static_cast<float>(fadePosition_) / static_cast<float>(fadeLength_);
+        const auto fadeSamples = std::min(numSamples, fadeLength_ - fadePosition_);
+        const auto endGain = static_cast<float>(fadePosition_ + fadeSamples) / static_cast<float>(fadeLength_);
+
+        for (int channel = 0; channel < writableOutputs; ++channel) {
+            mainBuffer_.applyGainRamp(channel, 0, fadeSamples, startGain, endGain);
+            fadeBuffer_.applyGainRamp(channel, 0, fadeSamples, 1.0F - startGain, 1.0F - endGain);
+            mainBuffer_.addFrom(channel, 0, fadeBuffer_, channel, 0, fadeSamples);
+        }
+
+        fadePosition_ += fadeSamples;
+        if (fadePosition_ >= fadeLength_) {
+            retire(fadingOut_);
+            fadingOut_ = nullptr;
+        }
+    }
+
+    if (matrix_ != nullptr) {
+        for (int channel = 0; channel < numOutputs; ++channel) {
+            chunkOutputs_[static_cast<std::size_t>(channel)] = outputs[channel] != nullptr ? outputs[channel] + offset : nullptr;
+        }
+        matrix_->apply(PatchSide::Output, mainBuffer_.getArrayOfReadPointers(), static_cast<std::size_t>(writableOutputs),
+                       chunkOutputs_.data(), static_cast<std::size_t>(numOutputs), static_cast<std::size_t>(numSamples));
+        return;
+    }
+
+    for (int channel = 0; channel < writableOutputs; ++channel) {
+        if (outputs[channel] != nullptr) {
+            juce::FloatVectorOperations::copy(outputs[channel] + offset, mainBuffer_.getReadPointer(channel), numSamples);
+        }
+    }
+}
+
+void GraphSwapPlayer::renderInto(juce::AudioProcessor& processor,
+                                 juce::AudioBuffer<float>& buffer,
+                                 const float* const* inputs,
+                                 int numInputs,
+                                 int offset,
+                                 int numSamples) {
+    // Shrinking an owned buffer within its prepared size re-lays the channels in the same
+    // storage; a view over more than 32 channels would allocate its pointer array instead.
+    buffer.setSize(buffer.getNumChannels(), numSamples, false, false, true);
+
+    if (matrix_ != nullptr) {
+        for (int channel = 0; channel < numInputs; ++channel) {
+            chunkInputs_[static_cast<std::size_t>(channel)] = inputs[channel] != nullptr ? inputs[channel] + offset : nullptr;
+        }
+        matrix_->apply(PatchSide::Input, chunkInputs_.data(), static_cast<std::size_t>(numInputs),
+                       buffer.getArrayOfWritePointers(), static_cast<std::size_t>(buffer.getNumChannels()),
+                       static_cast<std::size_t>(numSamples));
+    } else {
+        const auto copyInputs = std::min(numInputs, buffer.getNumChannels());
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+            if (channel < copyInputs && inputs[channel] != nullptr) {
+                juce::FloatVectorOperations::copy(buffer.getWritePointer(channel), inputs[channel] + offset, numSamples);
+            } else {
+                juce::FloatVectorOperations::clear(buffer.getWritePointer(channel), numSamples);
+            }
+        }
+    }
+
+    midi_.clear();
+    processor.processBlock(buffer, midi_);
+}
+
+} // namespace broadcastmix::audio
+
+#endif // BROADCASTMIX_HAS_JUCE
@@ -0,0 +1,112 @@
+#pragma once
+
+#if BROADCASTMIX_HAS_JUCE
+
+#include "AudioCommandQueue.h"
+#include "CpuLoadMeter.h"
+#include "RoutingMatrix.h"
+#include "SnapshotRecaller.h"
+#include "XrunJournal.h"
+
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace broadcastmix::audio {
+
+struct PlaybackConfiguration {
+    double sampleRate { 48000.0 };
+    int blockSize { 512 };
+    int numInputs { 2 };
+    int numOutputs { 2 };
+
+    bool operator==(const PlaybackConfiguration&) const = default;
+};
+
+// Device callback that hosts a root processor and replaces it without stalling
+// the audio thread: new processors are prepared on the message thread, picked
+// up at the next block boundary and crossfaded against the outgoing one.
+class GraphSwapPlayer : public juce::AudioIODeviceCallback {
+public:
+    GraphSwapPlayer();
+    ~GraphSwapPlayer() override;
+
+    GraphSwapPlayer(const GraphSwapPlayer&) = delete;
+    GraphSwapPlayer& operator=(const GraphSwapPlayer&) = delete;
+
+    void setConfiguration(const PlaybackConfiguration& configuration);
+    [[nodiscard]] PlaybackConfiguration configuration() const noexcept;
+    void setCrossfadeMilliseconds(double milliseconds) noexcept;
+
+    void submit(std::unique_ptr<juce::AudioProcessor> processor);
+    [[nodiscard]] juce::AudioProcessor* current() const noexcept;
+    void collectGarbage();
+
+    [[nodiscard]] CpuLoadMeter& loadMeter() noexcept;
+    [[nodiscard]] const CpuLoadMeter& loadMeter() const noexcept;
+    void setXrunJournal(XrunJournal* journal) noexcept;
+    void setSnapshotRecaller(SnapshotRecaller* recaller) noexcept;
+    void setCommandQueue(AudioCommandQueue* commands) noexcept;
+    void setRoutingMatrix(RoutingMatrix* matrix) noexcept;
+    void setTopologyVersion(std::uint64_t version) noexcept;
+
+    void audioDeviceIOCallbackWithContext(const float* const* inputChannelData,
+                                          int numInputChannels,
+                                          float* const* outputChannelData,
+                                          int numOutputChannels,
+                                          int numSamples,
+                                          const juce::AudioIODeviceCallbackContext& context) override;
+    void audioDeviceAboutToStart(juce::AudioIODevice* device) override;
+    void audioDeviceStopped() override;
+
+private:
+    static constexpr std::size_t kRetireSlots = 8;
+
+    void prepareProcessor(juce::AudioProcessor& processor) const;
+    void destroy(juce::AudioProcessor* processor);
+    void renderChunk(const float* const* inputs, int numInputs, float* const* outputs, int numOutputs, int offset, int numSamples);
+    void renderInto(juce::AudioProcessor& processor, juce::AudioBuffer<float>& buffer,
+                    const float* const* inputs, int numInputs, int offset, int numSamples);
+    [[nodiscard]] bool hasRetireSlot() const noexcept;
+    void retire(juce::AudioProcessor* processor) noexcept;
+    void recordXruns(std::chrono::steady_clock::duration elapsed, double blockSeconds) noexcept;
+
+    PlaybackConfiguration configuration_ {};
+    std::vector<std::unique_ptr<juce::AudioProcessor>> owned_;
+    juce::AudioProcessor* latest_ { nullptr };
+
+    std::atomic<juce::AudioProcessor*> pending_ { nullptr };
+    std::array<std::atomic<juce::AudioProcessor*>, kRetireSlots> retired_ {};
+    std::atomic<double> crossfadeMilliseconds_ { 20.0 };
+    CpuLoadMeter loadMeter_;
+    std::atomic<XrunJournal*> xrunJournal_ { nullptr };
+    std::atomic<SnapshotRecaller*> snapshotRecaller_ { nullptr };
+    std::atomic<AudioCommandQueue*> commandQueue_ { nullptr };
+    std::atomic<RoutingMatrix*> routingMatrix_ { nullptr };
+    RoutingMatrix* matrix_ { nullptr };
+    std::atomic<std::uint64_t> topologyVersion_ { 0 };
+    juce::AudioIODevice* device_ { nullptr };
+    int deviceXruns_ { 0 };
+
+    juce::AudioProcessor* active_ { nullptr };
+    juce::AudioProcessor* fadingOut_ { nullptr };
+    int fadePosition_ { 0 };
+    int fadeLength_ { 0 };
+    // Resized to each chunk, never beyond chunkCapacity_, so the callback never reallocates them.
+    int chunkCapacity_ { 1 };
+    juce::AudioBuffer<float> mainBuffer_;
+    juce::AudioBuffer<float> fadeBuffer_;
+    juce::MidiBuffer midi_;
+    // Device channel pointers advanced to the chunk being rendered, for the routing matrix.
+    std::vector<const float*> chunkInputs_;
+    std::vector<float*> chunkOutputs_;
+};
+
+} // namespace broadcastmix::audio
+
+#endif // BROADCASTMIX_HAS_JUCE
@@ -156,6 +156,37 @@ bool GraphTopology::connectionExists(const std::string& fromId,
     });
 }
 
+bool GraphTopology::hasSameRouting(const GraphTopology& other) const {
+    if (nodes_.size() != other.nodes_.size() || connections_.size() != other.connections_.size()) {
+        return false;
+    }
+
+    for (std::size_t index = 0; index < nodes_.size(); ++index) {
+        const auto& node = nodes_[index];
+        const auto& otherNode = other.nodes_[index];
+        if (node.id() != otherNode.id()
+            || node.type() != otherNode.type()
+            || node.inputChannelCount() != otherNode.inputChannelCount()
+            || node.outputChannelCount() != otherNode.outputChannelCount()) {
+            return false;
+        }
+        // Utility labels select the processor kind (e.g. the monitor trim gain stage).
+        if (node.type() == GraphNodeType::Utility && node.label() != otherNode.label()) {
+            return false;
+        }
+    }
+
+    // connect() rejects duplicates, so equal sizes plus containment means equal sets. Crosspoint
+    // gains and fan-out are compiled into the graph, so they count as routing.
+    return std::all_of(connections_.begin(), connections_.end(), [&](const GraphConnection& connection) {
+        return std::any_of(other.connections_.begin(), other.connections_.end(), [&](const GraphConnection& candidate) {
+            return candidate.fromNodeId == connection.fromNodeId && candidate.toNodeId == connection.toNodeId
+                && candidate.fromChannel == connection.fromChannel && candidate.toChannel == connection.toChannel
+                && candidate.gain == connection.gain && candidate.fanOut == connection.fanOut;
+        });
+    });
+}
+
 void GraphTopology::pruneConnectionsForNode(const std::string& id, std::uint32_t inputChannels, std::uint32_t outputChannels) {
     connections_.erase(
         std::remove_if(connections_.begin(), connections_.end(), [&](const GraphConnection& connection) {
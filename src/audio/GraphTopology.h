@@ -2,6 +2,7 @@
 
 #include "GraphNode.h"
 
+#include <algorithm>
 #include <optional>
 #include <string_view>
 #include <unordered_map>
@@ -35,6 +36,30 @@ public:
                                         const std::string& toId,
                                         std::uint32_t fromChannel,
                                         std::uint32_t toChannel) const;
+    // True when both topologies build the same processors and wiring, so they differ at
+    // most in state that can be changed on a live graph (enabled flags, cosmetic labels).
+    [[nodiscard]] bool hasSameRouting(const GraphTopology& other) const;
+
+    // Channel pairs a connection carries, given the processing width of each end (nodes that
+    // declare no channels run as stereo). Only fan-out connections reach past fromChannel and
+    // toChannel: a mono end then spreads to, or folds down from, every channel of the other.
+    template <typename Visitor>
+    static void forEachChannelPair(const GraphConnection& connection,
+                                   std::uint32_t fromChannels,
+                                   std::uint32_t toChannels,
+                                   Visitor&& visit) {
+        if (connection.fanOut && fromChannels == 1 && toChannels > 1) {
+            for (std::uint32_t channel = 0; channel < toChannels; ++channel) {
+                visit(connection.fromChannel, channel);
+            }
+        } else if (connection.fanOut && fromChannels > 1 && toChannels == 1) {
+            for (std::uint32_t channel = 0; channel < fromChannels; ++channel) {
+                visit(channel, connection.toChannel);
+            }
+        } else {
+            visit(connection.fromChannel, connection.toChannel);
+        }
+    }
 
     static GraphTopology createDefaultBroadcastLayout();
     static GraphTopology createGroupMicroLayout(std::string_view groupId);
@@ -2,91 +2,210 @@
 
 #if BROADCASTMIX_HAS_JUCE
 
+#include "RenderPlan.h"
 #include "processors/GainProcessor.h"
-#include "processors/PassThroughProcessor.h"
-#include "processors/SignalGeneratorProcessor.h"
 
 #include "../core/Logging.h"
 
+#include <algorithm>
+#include <unordered_set>
+
 namespace broadcastmix::audio {
 
 namespace {
-juce::AudioChannelSet channelSetForNode(const GraphNode& node) {
-    const auto channels = static_cast<int>(std::max(node.inputChannelCount(), node.outputChannelCount()));
-    if (channels <= 0) {
-        return juce::AudioChannelSet::stereo();
-    }
-    if (channels == 1) {
-        return juce::AudioChannelSet::mono();
-    }
-    if (channels == 2) {
-        return juce::AudioChannelSet::stereo();
-    }
-    return juce::AudioChannelSet::discreteChannels(channels);
+constexpr auto kDeferred = juce::AudioProcessorGraph::UpdateKind::none;
+
+void logFailedConnection(const juce::AudioProcessorGraph::Connection& connection) {
+    core::log(core::LogCategory::Audio,
+              "Failed to connect {}:{} -> {}:{}",
+              connection.source.nodeID.uid,
+              connection.source.channelIndex,
+              connection.destination.nodeID.uid,
+              connection.destination.channelIndex);
 }
+
 } // namespace
 
-JuceGraphBuilder::JuceGraphBuilder(juce::AudioProcessorGraph& graph, std::shared_ptr<MeterStore> meterStore)
-    : graph_(graph)
-    , meterStore_(std::move(meterStore)) {}
+JuceGraphBuilder::JuceGraphBuilder(std::shared_ptr<MeterStore> meterStore,
+                                   std::shared_ptr<NodeTimingStore> timingStore,
+                                   std::shared_ptr<ParameterStore> parameterStore)
+    : processorFactory_(std::move(meterStore), std::move(timingStore), std::move(parameterStore)) {}
 
-void JuceGraphBuilder::rebuildFromTopology(const GraphTopology& topology) {
-    graph_.clear();
+std::unique_ptr<juce::AudioProcessor> JuceGraphBuilder::buildFromTopology(const GraphTopology& topology,
+                                                                          const PlaybackConfiguration& configuration) {
+    // The graph is assembled detached from the device callback; nothing renders until it is prepared and swapped in.
+    auto graph = std::make_unique<juce::AudioProcessorGraph>();
+    graph->setPlayConfigDetails(configuration.numInputs,
+                                configuration.numOutputs,
+                                configuration.sampleRate,
+                                configuration.blockSize);
+    graph_ = graph.get();
+    configuration_ = configuration;
     nodeMap_.clear();
+    crosspoints_.clear();
     hardwareInputNodeId_.reset();
     hardwareOutputNodeId_.reset();
 
     using IOProcessor = juce::AudioProcessorGraph::AudioGraphIOProcessor;
 
-    if (auto outputNode = graph_.addNode(std::make_unique<IOProcessor>(IOProcessor::audioOutputNode))) {
+    if (auto outputNode = graph_->addNode(std::make_unique<IOProcessor>(IOProcessor::audioOutputNode), std::nullopt, kDeferred)) {
         hardwareOutputNodeId_ = outputNode->nodeID;
     }
-    if (auto inputNode = graph_.addNode(std::make_unique<IOProcessor>(IOProcessor::audioInputNode))) {
+    if (auto inputNode = graph_->addNode(std::make_unique<IOProcessor>(IOProcessor::audioInputNode), std::nullopt, kDeferred)) {
         hardwareInputNodeId_ = inputNode->nodeID;
     }
 
-    struct OutputBinding {
-        juce::AudioProcessorGraph::NodeID nodeId;
-        std::uint32_t channels;
-    };
+    for (const auto& node : topology.nodes()) {
+        addNodeForTopology(node);
+    }
+    syncCrosspoints(topology);
+
+    for (const auto& connection : connectionsForTopology(topology)) {
+        if (!graph_->addConnection(connection, kDeferred)) {
+            logFailedConnection(connection);
+        }
+    }
 
-    struct InputBinding {
-        juce::AudioProcessorGraph::NodeID nodeId;
-        std::uint32_t channels;
-    };
+    return graph;
+}
 
-    std::vector<OutputBinding> outputBindings;
-    std::vector<InputBinding> inputBindings;
+bool JuceGraphBuilder::applyTopology(const GraphTopology& topology, const PlaybackConfiguration& configuration) {
+    if (graph_ == nullptr || !(configuration == configuration_)) {
+        return false;
+    }
 
+    const auto diff = diffTopology(nodeMap_, topology);
+    if (diff.prefersRebuild(nodeMap_.size())) {
+        return false;
+    }
+
+    for (const auto& id : diff.removals) {
+        if (const auto it = nodeMap_.find(id); it != nodeMap_.end()) {
+            graph_->removeNode(it->second.nodeId, kDeferred);
+            nodeMap_.erase(it);
+        }
+    }
+    for (const auto index : diff.additions) {
+        addNodeForTopology(topology.nodes()[index]);
+    }
     for (const auto& node : topology.nodes()) {
-        auto processor = createProcessorForNode(node);
-        if (!processor) {
-            core::log(core::LogCategory::Audio, "Failed to create processor for node {}", node.id());
-            continue;
+        if (const auto it = nodeMap_.find(node.id()); it != nodeMap_.end()) {
+            it->second.signature.label = node.label();
         }
+    }
+    const auto changedCrosspoints = syncCrosspoints(topology);
 
-        auto nodePtr = graph_.addNode(std::move(processor));
-        if (nodePtr == nullptr) {
-            core::log(core::LogCategory::Audio, "Failed to add node {}", node.id());
-            continue;
+    auto desired = connectionsForTopology(topology);
+    std::sort(desired.begin(), desired.end());
+    auto existing = graph_->getConnections();
+    std::sort(existing.begin(), existing.end());
+
+    std::size_t changedConnections = 0;
+    for (const auto& connection : existing) {
+        if (!std::binary_search(desired.begin(), desired.end(), connection)) {
+            graph_->removeConnection(connection, kDeferred);
+            ++changedConnections;
         }
+    }
+    for (const auto& connection : desired) {
+        if (!std::binary_search(existing.begin(), existing.end(), connection)) {
+            if (!graph_->addConnection(connection, kDeferred)) {
+                logFailedConnection(connection);
+            }
+            ++changedConnections;
+        }
+    }
 
-        nodeMap_.emplace(node.id(), nodePtr->nodeID);
+    if (!diff.additions.empty() || !diff.removals.empty() || changedCrosspoints > 0 || changedConnections > 0) {
+        graph_->rebuild();
+    }
 
-        const auto channelCount = std::max<std::uint32_t>(1U,
-            std::max(node.inputChannelCount(), node.outputChannelCount()));
+    core::log(core::LogCategory::Audio,
+              "Applied topology diff: {} nodes added, {} removed, {} connections changed",
+              diff.additions.size(),
+              diff.removals.size(),
+              changedConnections);
+    return true;
+}
+
+bool JuceGraphBuilder::addNodeForTopology(const GraphNode& node) {
+    auto processor = processorFactory_.createProcessorForNode(node);
+    if (!processor) {
+        core::log(core::LogCategory::Audio, "Failed to create processor for node {}", node.id());
+        return false;
+    }
+
+    auto nodePtr = graph_->addNode(std::move(processor), std::nullopt, kDeferred);
+    if (nodePtr == nullptr) {
+        core::log(core::LogCategory::Audio, "Failed to add node {}", node.id());
+        return false;
+    }
+
+    nodeMap_.insert_or_assign(node.id(), NodeBinding {
+        .nodeId = nodePtr->nodeID,
+        .signature = NodeSignature::of(node),
+        .channels = RenderPlan::processingChannelCount(node),
+    });
+    return true;
+}
 
-        switch (node.type()) {
-        case GraphNodeType::Output:
-            outputBindings.push_back(OutputBinding { nodePtr->nodeID, channelCount });
-            break;
-        case GraphNodeType::Input:
-            inputBindings.push_back(InputBinding { nodePtr->nodeID, channelCount });
-            break;
-        default:
-            break;
+std::size_t JuceGraphBuilder::syncCrosspoints(const GraphTopology& topology) {
+    std::unordered_set<std::string> wanted;
+    std::size_t changed = 0;
+    for (const auto& connection : topology.connections()) {
+        const auto fromIt = nodeMap_.find(connection.fromNodeId);
+        const auto toIt = nodeMap_.find(connection.toNodeId);
+        if (connection.gain == 1.0F || fromIt == nodeMap_.end() || toIt == nodeMap_.end()) {
+            continue;
         }
+        const auto& from = fromIt->second;
+        const auto& to = toIt->second;
+        GraphTopology::forEachChannelPair(connection, from.channels, to.channels, [&](std::uint32_t fromChannel, std::uint32_t toChannel) {
+            if (fromChannel >= from.channels || toChannel >= to.channels) {
+                return;
+            }
+            auto key = crosspointKey(connection, fromChannel);
+            if (!wanted.insert(key).second) {
+                return;
+            }
+            if (const auto existing = crosspoints_.find(key); existing != crosspoints_.end()) {
+                existing->second.parameters->store(NodeParameter::Gain, connection.gain);
+                return;
+            }
+            auto parameters = std::make_shared<ParameterStore::NodeParameters>();
+            parameters->store(NodeParameter::Gain, connection.gain);
+            auto gain = std::make_unique<processors::GainProcessor>(connection.gain,
+                                                                     parameters,
+                                                                     "Crosspoint",
+                                                                     nullptr,
+                                                                     juce::AudioChannelSet::mono());
+            if (auto node = graph_->addNode(std::move(gain), std::nullopt, kDeferred)) {
+                crosspoints_.emplace(std::move(key), Crosspoint { .nodeId = node->nodeID, .parameters = std::move(parameters) });
+                ++changed;
+            }
+        });
     }
+    for (auto it = crosspoints_.begin(); it != crosspoints_.end();) {
+        if (wanted.contains(it->first)) {
+            ++it;
+            continue;
+        }
+        graph_->removeNode(it->second.nodeId, kDeferred);
+        it = crosspoints_.erase(it);
+        ++changed;
+    }
+    return changed;
+}
+
+std::string JuceGraphBuilder::crosspointKey(const GraphConnection& connection, std::uint32_t sourceChannel) {
+    // Only the routing identifies a crosspoint; its gain is retuned in place.
+    return connection.fromNodeId + ':' + std::to_string(connection.fromChannel) + '>' + connection.toNodeId + ':'
+        + std::to_string(connection.toChannel) + '#' + std::to_string(sourceChannel);
+}
+
+std::vector<juce::AudioProcessorGraph::Connection> JuceGraphBuilder::connectionsForTopology(const GraphTopology& topology) const {
+    std::vector<juce::AudioProcessorGraph::Connection> connections;
+    connections.reserve(topology.connections().size() + nodeMap_.size() * 2);
 
     for (const auto& connection : topology.connections()) {
         const auto fromIt = nodeMap_.find(connection.fromNodeId);
@@ -99,113 +218,63 @@ void JuceGraphBuilder::rebuildFromTopology(const GraphTopology& topology) {
             continue;
         }
 
-        const auto result = graph_.addConnection({
-            { fromIt->second, static_cast<int>(connection.fromChannel) },
-            { toIt->second, static_cast<int>(connection.toChannel) },
+        const auto& from = fromIt->second;
+        const auto& to = toIt->second;
+        GraphTopology::forEachChannelPair(connection, from.channels, to.channels, [&](std::uint32_t fromChannel, std::uint32_t toChannel) {
+            if (fromChannel >= from.channels || toChannel >= to.channels) {
+                return;
+            }
+            const juce::AudioProcessorGraph::NodeAndChannel source { from.nodeId, static_cast<int>(fromChannel) };
+            const juce::AudioProcessorGraph::NodeAndChannel destination { to.nodeId, static_cast<int>(toChannel) };
+            if (connection.gain == 1.0F) {
+                connections.push_back({ source, destination });
+                return;
+            }
+            const auto crosspoint = crosspoints_.find(crosspointKey(connection, fromChannel));
+            if (crosspoint != crosspoints_.end()) {
+                connections.push_back({ source, { crosspoint->second.nodeId, 0 } });
+                connections.push_back({ { crosspoint->second.nodeId, 0 }, destination });
+            }
         });
-
-        if (!result) {
-            core::log(core::LogCategory::Audio,
-                      "Failed to connect {}:{} -> {}:{}",
-                      connection.fromNodeId,
-                      connection.fromChannel,
-                      connection.toNodeId,
-                      connection.toChannel);
-        }
     }
 
     int hardwareOutputChannels = 0;
     if (hardwareOutputNodeId_) {
-        if (auto* outputNode = graph_.getNodeForId(*hardwareOutputNodeId_)) {
+        if (auto* outputNode = graph_->getNodeForId(*hardwareOutputNodeId_)) {
             hardwareOutputChannels = outputNode->getProcessor() ? outputNode->getProcessor()->getTotalNumInputChannels() : 0;
         }
+    }
 
-        for (const auto& binding : outputBindings) {
-            const auto channels = static_cast<int>(binding.channels);
-            if (channels <= 0) {
-                continue;
-            }
+    for (const auto& node : topology.nodes()) {
+        const auto it = nodeMap_.find(node.id());
+        if (it == nodeMap_.end()) {
+            continue;
+        }
+
+        const auto channels = static_cast<int>(std::max<std::uint32_t>(1U,
+            std::max(node.inputChannelCount(), node.outputChannelCount())));
 
+        if (node.type() == GraphNodeType::Output && hardwareOutputNodeId_) {
             for (int channel = 0; channel < channels; ++channel) {
-                graph_.addConnection({
-                    { binding.nodeId, channel },
-                    { *hardwareOutputNodeId_, channel }
-                });
+                connections.push_back({ { it->second.nodeId, channel }, { *hardwareOutputNodeId_, channel } });
             }
 
             if (channels == 1 && hardwareOutputChannels > 1) {
                 for (int extra = 1; extra < hardwareOutputChannels; ++extra) {
-                    graph_.addConnection({
-                        { binding.nodeId, 0 },
-                        { *hardwareOutputNodeId_, extra }
-                    });
+                    connections.push_back({ { it->second.nodeId, 0 }, { *hardwareOutputNodeId_, extra } });
                 }
             }
-        }
-    }
-
-    if (hardwareInputNodeId_) {
-        for (const auto& binding : inputBindings) {
-            const auto channels = static_cast<int>(binding.channels);
+        } else if (node.type() == GraphNodeType::Input && hardwareInputNodeId_) {
             for (int channel = 0; channel < channels; ++channel) {
-                graph_.addConnection({
-                    { *hardwareInputNodeId_, channel },
-                    { binding.nodeId, channel }
-                });
+                connections.push_back({ { *hardwareInputNodeId_, channel }, { it->second.nodeId, channel } });
             }
         }
     }
-}
 
-std::unique_ptr<juce::AudioProcessor> JuceGraphBuilder::createProcessorForNode(const GraphNode& node) {
-    switch (node.type()) {
-    case GraphNodeType::Input:
-        return std::make_unique<processors::PassThroughProcessor>(node.label().empty() ? "Input" : node.label(),
-                                                                  meterStore_ ? meterStore_->meterFor(node.id()) : nullptr,
-                                                                  channelSetForNode(node));
-    case GraphNodeType::Output:
-        return std::make_unique<processors::PassThroughProcessor>(node.label().empty() ? "Output" : node.label(),
-                                                                  meterStore_ ? meterStore_->meterFor(node.id()) : nullptr,
-                                                                  channelSetForNode(node));
-    case GraphNodeType::SignalGenerator:
-        return std::make_unique<processors::SignalGeneratorProcessor>(meterStore_ ? meterStore_->meterFor(node.id()) : nullptr,
-                                                                      channelSetForNode(node));
-    case GraphNodeType::Utility:
-        if (node.label() == "Monitor Trim -3 dB") {
-            return std::make_unique<processors::GainProcessor>(juce::Decibels::decibelsToGain(-3.0F),
-                                                               "Monitor Trim -3 dB",
-                                                               meterStore_ ? meterStore_->meterFor(node.id()) : nullptr,
-                                                               channelSetForNode(node));
-        }
-        return std::make_unique<processors::PassThroughProcessor>("Utility",
-                                                                  meterStore_ ? meterStore_->meterFor(node.id()) : nullptr,
-                                                                  channelSetForNode(node));
-    case GraphNodeType::BroadcastBus:
-        return std::make_unique<processors::PassThroughProcessor>("Broadcast Bus",
-                                                                  meterStore_ ? meterStore_->meterFor(node.id()) : nullptr,
-                                                                  channelSetForNode(node));
-    case GraphNodeType::MixBus:
-        return std::make_unique<processors::PassThroughProcessor>(node.label().empty() ? "Monitor Bus" : node.label(),
-                                                                  meterStore_ ? meterStore_->meterFor(node.id()) : nullptr,
-                                                                  channelSetForNode(node));
-    case GraphNodeType::GroupBus:
-    case GraphNodeType::Person:
-        return std::make_unique<processors::PassThroughProcessor>("Group Bus",
-                                                                  meterStore_ ? meterStore_->meterFor(node.id()) : nullptr,
-                                                                  channelSetForNode(node));
-    case GraphNodeType::Channel:
-        return std::make_unique<processors::PassThroughProcessor>("Channel Processing",
-                                                                  meterStore_ ? meterStore_->meterFor(node.id()) : nullptr,
-                                                                  channelSetForNode(node));
-    case GraphNodeType::Plugin:
-        return std::make_unique<processors::PassThroughProcessor>("Plugin Placeholder",
-                                                                  meterStore_ ? meterStore_->meterFor(node.id()) : nullptr,
-                                                                  channelSetForNode(node));
-    default:
-        return std::make_unique<processors::PassThroughProcessor>("Node",
-                                                                  meterStore_ ? meterStore_->meterFor(node.id()) : nullptr,
-                                                                  channelSetForNode(node));
-    }
+    // Overlapping fan-outs can yield the same edge twice, which the processor graph would reject.
+    std::sort(connections.begin(), connections.end());
+    connections.erase(std::unique(connections.begin(), connections.end()), connections.end());
+    return connections;
 }
 
 } // namespace broadcastmix::audio
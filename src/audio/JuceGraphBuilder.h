@@ -1,30 +1,58 @@
 #pragma once
 
+#include "GraphBuilder.h"
 #include "GraphTopology.h"
 #include "MeterStore.h"
+#include "NodeTimingStore.h"
+#include "ParameterStore.h"
+#include "ProcessorFactory.h"
 
 #if BROADCASTMIX_HAS_JUCE
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <optional>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 namespace broadcastmix::audio {
 
-class JuceGraphBuilder {
+class JuceGraphBuilder : public GraphBuilder {
 public:
-    JuceGraphBuilder(juce::AudioProcessorGraph& graph, std::shared_ptr<MeterStore> meterStore);
+    explicit JuceGraphBuilder(std::shared_ptr<MeterStore> meterStore,
+                              std::shared_ptr<NodeTimingStore> timingStore = nullptr,
+                              std::shared_ptr<ParameterStore> parameterStore = nullptr);
 
-    void rebuildFromTopology(const GraphTopology& topology);
+    [[nodiscard]] std::unique_ptr<juce::AudioProcessor> buildFromTopology(const GraphTopology& topology,
+                                                                          const PlaybackConfiguration& configuration) override;
+    bool applyTopology(const GraphTopology& topology, const PlaybackConfiguration& configuration) override;
 
 private:
-    juce::AudioProcessorGraph& graph_;
-    std::shared_ptr<MeterStore> meterStore_;
-    std::unordered_map<std::string, juce::AudioProcessorGraph::NodeID> nodeMap_;
+    struct NodeBinding {
+        juce::AudioProcessorGraph::NodeID nodeId;
+        NodeSignature signature;
+        // Width the processor runs at, which is what connections pair against.
+        std::uint32_t channels { 0 };
+    };
+
+    juce::AudioProcessorGraph* graph_ { nullptr };
+    PlaybackConfiguration configuration_ {};
+    ProcessorFactory processorFactory_;
+    std::unordered_map<std::string, NodeBinding> nodeMap_;
+    struct Crosspoint {
+        juce::AudioProcessorGraph::NodeID nodeId;
+        // Carries the send level, so a gain edit retunes the live node through its smoother.
+        ParameterStore::ParametersPtr parameters;
+    };
+
+    // The graph sums at unity, so each weighted edge runs through a mono gain node per source channel.
+    std::unordered_map<std::string, Crosspoint> crosspoints_;
     std::optional<juce::AudioProcessorGraph::NodeID> hardwareInputNodeId_;
     std::optional<juce::AudioProcessorGraph::NodeID> hardwareOutputNodeId_;
 
-    std::unique_ptr<juce::AudioProcessor> createProcessorForNode(const GraphNode& node);
+    bool addNodeForTopology(const GraphNode& node);
+    std::size_t syncCrosspoints(const GraphTopology& topology);
+    [[nodiscard]] static std::string crosspointKey(const GraphConnection& connection, std::uint32_t sourceChannel);
+    [[nodiscard]] std::vector<juce::AudioProcessorGraph::Connection> connectionsForTopology(const GraphTopology& topology) const;
 };
 
 } // namespace broadcastmix::audio
@@ -0,0 +1,131 @@
+#include "LevelMeter.h"
+
+#include "LoudnessMeter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace broadcastmix::audio {
+
+LevelMeter::LevelMeter(MeterStore::MeterPtr meter, std::size_t numChannels, MeterBallistics ballistics)
+    : meter_(std::move(meter))
+    , ballistics_(ballistics)
+    , levels_(numChannels)
+    , states_(numChannels)
+    , truePeak_(numChannels) {}
+
+void LevelMeter::prepare(double sampleRate) noexcept {
+    sampleRate_ = sampleRate > 0.0 ? sampleRate : 48000.0;
+    coefficientSamples_ = 0;
+    cleared_ = false;
+    reset();
+    if (meter_) {
+        meter_->loudnessWriter.store(this, std::memory_order_relaxed);
+        if (meter_->resetGeneration != nullptr) {
+            resetGeneration_ = meter_->resetGeneration->load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void LevelMeter::reset() noexcept {
+    std::fill(states_.begin(), states_.end(), ChannelState {});
+    truePeak_.reset();
+}
+
+void LevelMeter::clear() noexcept {
+    if (cleared_) {
+        return;
+    }
+
+    cleared_ = true;
+    reset();
+    if (!meter_) {
+        return;
+    }
+    const auto count = std::min(levels_.size(), static_cast<std::size_t>(meter_->numChannels));
+    for (std::size_t channel = 0; channel < count; ++channel) {
+        meter_->peak[channel].store(0.0F, std::memory_order_relaxed);
+        meter_->peakHold[channel].store(0.0F, std::memory_order_relaxed);
+        meter_->rms[channel].store(0.0F, std::memory_order_relaxed);
+        meter_->truePeak[channel].store(0.0F, std::memory_order_relaxed);
+    }
+}
+
+void LevelMeter::process(const float* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept {
+    processChannels(channels, numChannels, numSamples);
+}
+
+void LevelMeter::process(const double* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept {
+    processChannels(channels, numChannels, numSamples);
+}
+
+template <typename SampleType>
+void LevelMeter::processChannels(const SampleType* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept {
+    if (!meter_ || numSamples == 0) {
+        return;
+    }
+    cleared_ = false;
+
+    if (meter_->resetGeneration != nullptr) {
+        if (const auto generation = meter_->resetGeneration->load(std::memory_order_relaxed); generation != resetGeneration_) {
+            resetGeneration_ = generation;
+            reset();
+        }
+    }
+
+    const auto count = std::min({ numChannels, levels_.size(), static_cast<std::size_t>(meter_->numChannels) });
+    dsp::measureLevels(channels, count, numSamples, levels_.data());
+    updateCoefficients(numSamples);
+
+    const auto elapsed = static_cast<double>(numSamples);
+    const auto holdSamples = ballistics_.holdMilliseconds * 0.001 * sampleRate_;
+    for (std::size_t channel = 0; channel < count; ++channel) {
+        auto& state = states_[channel];
+        const auto blockPeak = levels_[channel].peak;
+
+        state.peak = std::max(blockPeak, state.peak * releaseFactor_);
+
+        if (blockPeak >= state.peakHold) {
+            state.peakHold = blockPeak;
+            state.holdRemaining = holdSamples;
+        } else if (state.holdRemaining > elapsed) {
+            state.holdRemaining -= elapsed;
+        } else {
+            state.holdRemaining = 0.0;
+            state.peakHold = std::max(blockPeak, state.peakHold * releaseFactor_);
+        }
+
+        // Closed form of a one-pole mean-square filter run over the block's samples, exact
+        // for a stationary block whatever its length.
+        const auto blockMeanSquare = levels_[channel].sumOfSquares / elapsed;
+        state.meanSquare = blockMeanSquare + (state.meanSquare - blockMeanSquare) * rmsFactor_;
+
+        const auto blockTruePeak = std::max(blockPeak, truePeak_.process(channel, channels[channel], numSamples));
+        state.truePeak = std::max(blockTruePeak, state.truePeak * releaseFactor_);
+
+        meter_->peak[channel].store(state.peak, std::memory_order_relaxed);
+        meter_->peakHold[channel].store(state.peakHold, std::memory_order_relaxed);
+        meter_->rms[channel].store(static_cast<float>(std::sqrt(state.meanSquare)), std::memory_order_relaxed);
+        meter_->truePeak[channel].store(state.truePeak, std::memory_order_relaxed);
+    }
+
+    if (auto* loudness = meter_->loudness.load(std::memory_order_acquire);
+        loudness != nullptr && meter_->loudnessWriter.load(std::memory_order_relaxed) == this) {
+        loudness->push(channels, count, numSamples, sampleRate_);
+    }
+}
+
+void LevelMeter::updateCoefficients(std::size_t numSamples) noexcept {
+    if (numSamples == coefficientSamples_) {
+        return;
+    }
+
+    coefficientSamples_ = numSamples;
+    const auto samples = static_cast<double>(numSamples);
+    const auto releaseSamples = std::max(ballistics_.releaseMilliseconds, 1.0) * 0.001 * sampleRate_;
+    const auto rmsSamples = std::max(ballistics_.rmsMilliseconds, 1.0) * 0.001 * sampleRate_;
+    releaseFactor_ = static_cast<float>(std::exp(-samples * std::log(10.0) / releaseSamples));
+    rmsFactor_ = std::exp(-samples / rmsSamples);
+}
+
+} // namespace broadcastmix::audio
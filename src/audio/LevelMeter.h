@@ -0,0 +1,59 @@
+#pragma once
+
+#include "MeterStore.h"
+#include "dsp/MeterKernel.h"
+#include "dsp/TruePeak.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace broadcastmix::audio {
+
+struct MeterBallistics {
+    // Time for peak and true-peak readings to fall by 20 dB.
+    double releaseMilliseconds { 1700.0 };
+    double holdMilliseconds { 2000.0 };
+    double rmsMilliseconds { 300.0 };
+};
+
+// Per-processor metering state that publishes every MeterMode of a node's meter once per
+// block. Ballistics are applied per elapsed sample, so readings do not depend on block size.
+class LevelMeter {
+public:
+    LevelMeter(MeterStore::MeterPtr meter, std::size_t numChannels, MeterBallistics ballistics = {});
+
+    void prepare(double sampleRate) noexcept;
+    void reset() noexcept;
+    // Publishes silence once for a bypassed node instead of metering its block.
+    void clear() noexcept;
+
+    void process(const float* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept;
+    void process(const double* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept;
+
+private:
+    struct ChannelState {
+        float peak { 0.0F };
+        float peakHold { 0.0F };
+        double holdRemaining { 0.0 };
+        double meanSquare { 0.0 };
+        float truePeak { 0.0F };
+    };
+
+    template <typename SampleType>
+    void processChannels(const SampleType* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept;
+    void updateCoefficients(std::size_t numSamples) noexcept;
+
+    MeterStore::MeterPtr meter_;
+    MeterBallistics ballistics_;
+    double sampleRate_ { 48000.0 };
+    std::vector<dsp::ChannelLevel> levels_;
+    std::vector<ChannelState> states_;
+    dsp::TruePeakDetector truePeak_;
+    std::size_t coefficientSamples_ { 0 };
+    std::uint32_t resetGeneration_ { 0 };
+    bool cleared_ { false };
+    float releaseFactor_ { 1.0F };
+    double rmsFactor_ { 1.0 };
+};
+
+} // namespace broadcastmix::audio
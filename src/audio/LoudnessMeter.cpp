@@ -0,0 +1,329 @@
+#include "LoudnessMeter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+namespace broadcastmix::audio {
+
+namespace {
+constexpr auto kAnalysisInterval = std::chrono::milliseconds(50);
+constexpr std::size_t kMomentarySubBlocks = 4;
+constexpr std::size_t kShortTermSubBlocks = 30;
+constexpr double kRelativeGateLu = -10.0;
+constexpr double kRangeGateLu = -20.0;
+constexpr double kSilence = -std::numeric_limits<double>::infinity();
+
+double loudnessOf(double energy) {
+    return energy > 0.0 ? -0.691 + 10.0 * std::log10(energy) : kSilence;
+}
+} // namespace
+
+LoudnessMeter::LoudnessMeter()
+    : ring_(std::make_unique<float[]>(kMaxChannels * kRingFrames))
+    , momentary_(kSilence)
+    , shortTerm_(kSilence)
+    , integrated_(kSilence)
+    , range_(0.0) {}
+
+LoudnessMeter::~LoudnessMeter() {
+    stop();
+}
+
+bool LoudnessMeter::push(const float* const* channels, std::size_t numChannels, std::size_t numSamples, double sampleRate) noexcept {
+    return pushFrames(channels, numChannels, numSamples, sampleRate);
+}
+
+bool LoudnessMeter::push(const double* const* channels, std::size_t numChannels, std::size_t numSamples, double sampleRate) noexcept {
+    return pushFrames(channels, numChannels, numSamples, sampleRate);
+}
+
+template <typename SampleType>
+bool LoudnessMeter::pushFrames(const SampleType* const* channels, std::size_t numChannels, std::size_t numSamples, double sampleRate) noexcept {
+    const auto write = writeFrame_.load(std::memory_order_relaxed);
+    if (write + numSamples - readFrame_.load(std::memory_order_acquire) > kRingFrames) {
+        droppedFrames_.fetch_add(numSamples, std::memory_order_relaxed);
+        return false;
+    }
+
+    numChannels = std::min(numChannels, kMaxChannels);
+    if (sampleRate_.load(std::memory_order_relaxed) != sampleRate) {
+        sampleRate_.store(sampleRate, std::memory_order_relaxed);
+    }
+    if (numChannels_.load(std::memory_order_relaxed) != numChannels) {
+        numChannels_.store(numChannels, std::memory_order_relaxed);
+    }
+
+    const auto start = static_cast<std::size_t>(write % kRingFrames);
+    const auto firstPart = std::min(numSamples, kRingFrames - start);
+    for (std::size_t channel = 0; channel < numChannels; ++channel) {
+        auto* destination = ring_.get() + channel * kRingFrames;
+        const auto* source = channels[channel];
+        if (source == nullptr) {
+            std::fill(destination + start, destination + start + firstPart, 0.0F);
+            std::fill(destination, destination + (numSamples - firstPart), 0.0F);
+            continue;
+        }
+        std::transform(source, source + firstPart, destination + start, [](SampleType value) { return static_cast<float>(value); });
+        std::transform(source + firstPart, source + numSamples, destination, [](SampleType value) { return static_cast<float>(value); });
+    }
+
+    writeFrame_.store(write + numSamples, std::memory_order_release);
+    return true;
+}
+
+void LoudnessMeter::start() {
+    std::scoped_lock lock(threadMutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    analysisThread_ = std::thread([this] { run(); });
+}
+
+void LoudnessMeter::stop() {
+    {
+        std::scoped_lock lock(threadMutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    wakeUp_.notify_all();
+    analysisThread_.join();
+    analyse();
+}
+
+std::size_t LoudnessMeter::analyse() {
+    std::scoped_lock lock(analysisMutex_);
+
+    const auto write = writeFrame_.load(std::memory_order_acquire);
+    const auto read = readFrame_.load(std::memory_order_relaxed);
+    const auto sampleRate = sampleRate_.load(std::memory_order_relaxed);
+    const auto numChannels = numChannels_.load(std::memory_order_relaxed);
+    if (sampleRate != analysisRate_ || numChannels != analysisChannels_) {
+        configure(sampleRate, numChannels);
+    }
+    if (subBlockFrames_ == 0) {
+        readFrame_.store(write, std::memory_order_release);
+        return 0;
+    }
+
+    const auto& shelf = filters_[0];
+    const auto& highPass = filters_[1];
+    for (auto frame = read; frame != write; ++frame) {
+        const auto index = static_cast<std::size_t>(frame % kRingFrames);
+        double energy = 0.0;
+        for (std::size_t channel = 0; channel < analysisChannels_; ++channel) {
+            auto& state = filterState_[channel];
+            const double input = ring_[channel * kRingFrames + index];
+
+            const auto shelved = shelf.b0 * input + state[0];
+            state[0] = shelf.b1 * input - shelf.a1 * shelved + state[1];
+            state[1] = shelf.b2 * input - shelf.a2 * shelved;
+
+            const auto weighted = highPass.b0 * shelved + state[2];
+            state[2] = highPass.b1 * shelved - highPass.a1 * weighted + state[3];
+            state[3] = highPass.b2 * shelved - highPass.a2 * weighted;
+
+            energy += channelWeights_[channel] * weighted * weighted;
+        }
+
+        subBlockEnergy_ += energy;
+        if (++subBlockFill_ == subBlockFrames_) {
+            finishSubBlock();
+        }
+    }
+
+    readFrame_.store(write, std::memory_order_release);
+    return static_cast<std::size_t>(write - read);
+}
+
+void LoudnessMeter::reset() {
+    std::scoped_lock lock(analysisMutex_);
+    readFrame_.store(writeFrame_.load(std::memory_order_acquire), std::memory_order_release);
+    clearAnalysis();
+}
+
+LoudnessStats LoudnessMeter::stats() const noexcept {
+    return LoudnessStats {
+        .momentaryLufs = momentary_.load(std::memory_order_relaxed),
+        .shortTermLufs = shortTerm_.load(std::memory_order_relaxed),
+        .integratedLufs = integrated_.load(std::memory_order_relaxed),
+        .loudnessRangeLu = range_.load(std::memory_order_relaxed),
+        .droppedFrames = droppedFrames_.load(std::memory_order_relaxed),
+    };
+}
+
+void LoudnessMeter::run() {
+    while (true) {
+        {
+            std::unique_lock lock(threadMutex_);
+            wakeUp_.wait_for(lock, kAnalysisInterval, [this] { return !running_; });
+            if (!running_) {
+                return;
+            }
+        }
+        analyse();
+    }
+}
+
+void LoudnessMeter::configure(double sampleRate, std::size_t numChannels) {
+    analysisRate_ = sampleRate;
+    analysisChannels_ = numChannels;
+    subBlockFrames_ = sampleRate > 0.0 && numChannels > 0 ? static_cast<std::size_t>(std::lround(sampleRate / 10.0)) : 0;
+
+    if (sampleRate > 0.0) {
+        // ITU-R BS.1770-4 K-weighting, re-derived for the running sample rate.
+        {
+            const auto k = std::tan(std::numbers::pi * 1681.974450955533 / sampleRate);
+            const auto q = 0.7071752369554196;
+            const auto vh = std::pow(10.0, 3.999843853973347 / 20.0);
+            const auto vb = std::pow(vh, 0.4996667741545416);
+            const auto a0 = 1.0 + k / q + k * k;
+            filters_[0] = Biquad {
+                .b0 = (vh + vb * k / q + k * k) / a0,
+                .b1 = 2.0 * (k * k - vh) / a0,
+                .b2 = (vh - vb * k / q + k * k) / a0,
+                .a1 = 2.0 * (k * k - 1.0) / a0,
+                .a2 = (1.0 - k / q + k * k) / a0,
+            };
+        }
+        {
+            const auto k = std::tan(std::numbers::pi * 38.13547087602444 / sampleRate);
+            const auto q = 0.5003270373238773;
+            const auto a0 = 1.0 + k / q + k * k;
+            filters_[1] = Biquad {
+                .b0 = 1.0,
+                .b1 = -2.0,
+                .b2 = 1.0,
+                .a1 = 2.0 * (k * k - 1.0) / a0,
+                .a2 = (1.0 - k / q + k * k) / a0,
+            };
+        }
+    }
+
+    // 5.1 in SMPTE order: the LFE is excluded and the surrounds get +1.5 dB.
+    channelWeights_.fill(1.0);
+    if (numChannels == 6) {
+        channelWeights_[3] = 0.0;
+        channelWeights_[4] = 1.41;
+        channelWeights_[5] = 1.41;
+    }
+
+    clearAnalysis();
+}
+
+void LoudnessMeter::clearAnalysis() {
+    for (auto& state : filterState_) {
+        state.fill(0.0);
+    }
+    subBlockFill_ = 0;
+    subBlockEnergy_ = 0.0;
+    subBlockCount_ = 0;
+    blockHistogram_.clear();
+    shortTermHistogram_.clear();
+    momentary_.store(kSilence, std::memory_order_relaxed);
+    shortTerm_.store(kSilence, std::memory_order_relaxed);
+    integrated_.store(kSilence, std::memory_order_relaxed);
+    range_.store(0.0, std::memory_order_relaxed);
+}
+
+void LoudnessMeter::finishSubBlock() {
+    subBlocks_[subBlockCount_ % subBlocks_.size()] = subBlockEnergy_ / static_cast<double>(subBlockFrames_);
+    ++subBlockCount_;
+    subBlockFill_ = 0;
+    subBlockEnergy_ = 0.0;
+
+    const auto windowEnergy = [this](std::size_t subBlocks) {
+        double sum = 0.0;
+        for (std::size_t offset = 1; offset <= subBlocks; ++offset) {
+            sum += subBlocks_[(subBlockCount_ - offset) % subBlocks_.size()];
+        }
+        return sum / static_cast<double>(subBlocks);
+    };
+
+    // Gating blocks are 400 ms long and start every 100 ms, so each completed sub-block
+    // closes one momentary window.
+    if (subBlockCount_ >= kMomentarySubBlocks) {
+        const auto energy = windowEnergy(kMomentarySubBlocks);
+        const auto loudness = loudnessOf(energy);
+        momentary_.store(loudness, std::memory_order_relaxed);
+        if (loudness > kAbsoluteGateLufs) {
+            blockHistogram_.add(loudness, energy);
+        }
+    }
+
+    if (subBlockCount_ >= kShortTermSubBlocks) {
+        const auto energy = windowEnergy(kShortTermSubBlocks);
+        const auto loudness = loudnessOf(energy);
+        shortTerm_.store(loudness, std::memory_order_relaxed);
+        if (loudness > kAbsoluteGateLufs) {
+            shortTermHistogram_.add(loudness, energy);
+        }
+    }
+
+    publish();
+}
+
+void LoudnessMeter::publish() {
+    const auto relativeGate = loudnessOf(blockHistogram_.gatedEnergy(kAbsoluteGateLufs)) + kRelativeGateLu;
+    integrated_.store(loudnessOf(blockHistogram_.gatedEnergy(std::max(relativeGate, kAbsoluteGateLufs))),
+                      std::memory_order_relaxed);
+
+    // EBU Tech 3342: spread between the 10th and 95th percentiles of gated short-term loudness.
+    const auto rangeGate = std::max(loudnessOf(shortTermHistogram_.gatedEnergy(kAbsoluteGateLufs)) + kRangeGateLu,
+                                    kAbsoluteGateLufs);
+    const auto low = shortTermHistogram_.percentile(rangeGate, 0.10);
+    const auto high = shortTermHistogram_.percentile(rangeGate, 0.95);
+    range_.store(std::isfinite(low) && std::isfinite(high) ? high - low : 0.0, std::memory_order_relaxed);
+}
+
+void LoudnessMeter::Histogram::clear() {
+    counts.fill(0);
+    energies.fill(0.0);
+}
+
+void LoudnessMeter::Histogram::add(double loudness, double energy) {
+    const auto bin = std::clamp(static_cast<std::ptrdiff_t>((loudness - kMinimumLufs) / kBinWidth),
+                                std::ptrdiff_t { 0 },
+                                static_cast<std::ptrdiff_t>(kBins - 1));
+    ++counts[static_cast<std::size_t>(bin)];
+    energies[static_cast<std::size_t>(bin)] += energy;
+}
+
+double LoudnessMeter::Histogram::gatedEnergy(double gateLufs) const {
+    const auto first = static_cast<std::size_t>(std::clamp((gateLufs - kMinimumLufs) / kBinWidth, 0.0, static_cast<double>(kBins)));
+    std::uint64_t count = 0;
+    double energy = 0.0;
+    for (auto bin = first; bin < kBins; ++bin) {
+        count += counts[bin];
+        energy += energies[bin];
+    }
+    return count > 0 ? energy / static_cast<double>(count) : 0.0;
+}
+
+double LoudnessMeter::Histogram::percentile(double gateLufs, double fraction) const {
+    const auto first = static_cast<std::size_t>(std::clamp((gateLufs - kMinimumLufs) / kBinWidth, 0.0, static_cast<double>(kBins)));
+    std::uint64_t total = 0;
+    for (auto bin = first; bin < kBins; ++bin) {
+        total += counts[bin];
+    }
+    if (total == 0) {
+        return kSilence;
+    }
+
+    const auto target = static_cast<std::uint64_t>(fraction * static_cast<double>(total - 1));
+    std::uint64_t seen = 0;
+    for (auto bin = first; bin < kBins; ++bin) {
+        seen += counts[bin];
+        if (seen > target) {
+            return kMinimumLufs + (static_cast<double>(bin) + 0.5) * kBinWidth;
+        }
+    }
+    return kMaximumLufs;
+}
+
+} // namespace broadcastmix::audio
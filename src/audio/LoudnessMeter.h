@@ -0,0 +1,106 @@
+#pragma once
+
+#include "AudioEngine.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace broadcastmix::audio {
+
+// EBU R128 loudness of one node's output. The audio thread only copies samples into a
+// preallocated ring; K-weighting, gating and integration run on a background thread
+// that publishes the results through atomics.
+class LoudnessMeter {
+public:
+    static constexpr std::size_t kMaxChannels = 8;
+    static constexpr std::size_t kRingFrames = 32768;
+    static constexpr double kAbsoluteGateLufs = -70.0;
+
+    LoudnessMeter();
+    ~LoudnessMeter();
+
+    LoudnessMeter(const LoudnessMeter&) = delete;
+    LoudnessMeter& operator=(const LoudnessMeter&) = delete;
+
+    bool push(const float* const* channels, std::size_t numChannels, std::size_t numSamples, double sampleRate) noexcept;
+    bool push(const double* const* channels, std::size_t numChannels, std::size_t numSamples, double sampleRate) noexcept;
+
+    void start();
+    void stop();
+    std::size_t analyse();
+    void reset();
+
+    [[nodiscard]] LoudnessStats stats() const noexcept;
+
+private:
+    struct Biquad {
+        double b0 { 1.0 };
+        double b1 { 0.0 };
+        double b2 { 0.0 };
+        double a1 { 0.0 };
+        double a2 { 0.0 };
+    };
+
+    struct Histogram {
+        static constexpr double kMinimumLufs = kAbsoluteGateLufs;
+        static constexpr double kMaximumLufs = 10.0;
+        static constexpr double kBinWidth = 0.1;
+        static constexpr std::size_t kBins = 800;
+
+        void clear();
+        void add(double loudness, double energy);
+        [[nodiscard]] double gatedEnergy(double gateLufs) const;
+        [[nodiscard]] double percentile(double gateLufs, double fraction) const;
+
+        std::array<std::uint64_t, kBins> counts {};
+        std::array<double, kBins> energies {};
+    };
+
+    template <typename SampleType>
+    bool pushFrames(const SampleType* const* channels, std::size_t numChannels, std::size_t numSamples, double sampleRate) noexcept;
+    void run();
+    void configure(double sampleRate, std::size_t numChannels);
+    void clearAnalysis();
+    void finishSubBlock();
+    void publish();
+
+    std::unique_ptr<float[]> ring_;
+    alignas(64) std::atomic<std::uint64_t> writeFrame_ { 0 };
+    alignas(64) std::atomic<std::uint64_t> readFrame_ { 0 };
+    std::atomic<double> sampleRate_ { 0.0 };
+    std::atomic<std::size_t> numChannels_ { 0 };
+    std::atomic<std::uint64_t> droppedFrames_ { 0 };
+
+    std::atomic<double> momentary_;
+    std::atomic<double> shortTerm_;
+    std::atomic<double> integrated_;
+    std::atomic<double> range_;
+
+    // Analysis state, owned by whichever thread holds analysisMutex_.
+    std::mutex analysisMutex_;
+    double analysisRate_ { 0.0 };
+    std::size_t analysisChannels_ { 0 };
+    std::array<Biquad, 2> filters_ {};
+    std::array<std::array<double, 4>, kMaxChannels> filterState_ {};
+    std::array<double, kMaxChannels> channelWeights_ {};
+    std::size_t subBlockFrames_ { 0 };
+    std::size_t subBlockFill_ { 0 };
+    double subBlockEnergy_ { 0.0 };
+    std::array<double, 30> subBlocks_ {};
+    std::size_t subBlockCount_ { 0 };
+    Histogram blockHistogram_;
+    Histogram shortTermHistogram_;
+
+    std::mutex threadMutex_;
+    std::condition_variable wakeUp_;
+    std::thread analysisThread_;
+    bool running_ { false };
+};
+
+} // namespace broadcastmix::audio
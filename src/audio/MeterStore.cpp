@@ -1,64 +1,258 @@
 #include "MeterStore.h"
 
+#include "LoudnessMeter.h"
+#include "RenderPlan.h"
+
 #include <algorithm>
-#include <unordered_set>
+#include <thread>
+#include <unordered_map>
 
 namespace broadcastmix::audio {
 
-MeterStore::MeterValue::MeterValue() {
-    channels[0].store(0.0F, std::memory_order_relaxed);
-    channels[1].store(0.0F, std::memory_order_relaxed);
+struct MeterStore::Storage {
+    alignas(64) std::array<std::atomic<float>, kChannelCapacity> peak {};
+    alignas(64) std::array<std::atomic<float>, kChannelCapacity> peakHold {};
+    alignas(64) std::array<std::atomic<float>, kChannelCapacity> rms {};
+    alignas(64) std::array<std::atomic<float>, kChannelCapacity> truePeak {};
+    std::array<MeterValue, kCapacity> meters {};
+    std::array<std::atomic<std::uint64_t>, kCapacity> ranges {};
+    std::shared_ptr<LoudnessMeter> loudness;
+    std::atomic<std::uint32_t> resetGeneration { 0 };
+};
+
+namespace {
+std::uint64_t packRange(std::uint32_t firstChannel, std::uint32_t numChannels) noexcept {
+    return (static_cast<std::uint64_t>(firstChannel) << 32U) | numChannels;
+}
+
+// Writer side of the layout sequence lock; only ever held under mutex_.
+class ScopedLayoutWrite {
+public:
+    explicit ScopedLayoutWrite(std::atomic<std::uint64_t>& sequence) noexcept
+        : sequence_(sequence) {
+        sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    ~ScopedLayoutWrite() {
+        sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    ScopedLayoutWrite(const ScopedLayoutWrite&) = delete;
+    ScopedLayoutWrite& operator=(const ScopedLayoutWrite&) = delete;
+
+private:
+    std::atomic<std::uint64_t>& sequence_;
+};
+} // namespace
+
+MeterStore::MeterStore(std::shared_ptr<LoudnessMeter> loudness)
+    : storage_(std::make_shared<Storage>())
+    , leases_(kCapacity)
+    , reservedChannels_(kCapacity, 0)
+    , assigned_(kCapacity, false) {
+    storage_->loudness = std::move(loudness);
 }
 
-MeterStore::MeterStore() = default;
 MeterStore::~MeterStore() = default;
 
-MeterStore::MeterPtr MeterStore::meterFor(const std::string& nodeId) {
+MeterStore::MeterPtr MeterStore::meterFor(const GraphNode& node) {
+    const auto numChannels = meterChannelCount(node);
     std::scoped_lock lock(mutex_);
-    if (const auto it = meters_.find(nodeId); it != meters_.end()) {
-        return it->second;
+    if (const auto it = handles_.find(node.id()); it != handles_.end()
+        && storage_->meters[it->second].numChannels == numChannels) {
+        return leases_[it->second];
+    }
+    const ScopedLayoutWrite write(layoutSequence_);
+    if (const auto it = handles_.find(node.id()); it != handles_.end()) {
+        releaseMeterLocked(it->second);
+        handles_.erase(it);
     }
-    return createMeterLocked(nodeId);
+    const auto handle = createMeterLocked(node.id(), numChannels);
+    return handle != kInvalidMeterHandle ? leases_[handle] : nullptr;
 }
 
-std::array<float, 2> MeterStore::levelsFor(const std::string& nodeId) const {
+MeterHandle MeterStore::handleFor(const std::string& nodeId) const {
     std::scoped_lock lock(mutex_);
-    std::array<float, 2> levels { 0.0F, 0.0F };
-    if (const auto it = meters_.find(nodeId); it != meters_.end() && it->second) {
-        for (std::size_t channel = 0; channel < levels.size(); ++channel) {
-            levels[channel] = std::clamp(it->second->channels[channel].load(std::memory_order_relaxed), 0.0F, 1.0F);
-        }
+    if (const auto it = handles_.find(nodeId); it != handles_.end()) {
+        return it->second;
     }
+    return kInvalidMeterHandle;
+}
+
+std::vector<float> MeterStore::levelsFor(const std::string& nodeId, MeterMode mode) const {
+    std::vector<float> levels;
+    readLevels(handleFor(nodeId), levels, mode);
     return levels;
 }
 
+void MeterStore::readLevels(MeterHandle handle, std::vector<float>& levels, MeterMode mode) const {
+    const auto range = rangeOf(handle);
+    const auto* values = plane(mode) + range.firstChannel;
+    levels.resize(range.numChannels);
+    for (std::uint32_t channel = 0; channel < range.numChannels; ++channel) {
+        levels[channel] = values[channel].load(std::memory_order_relaxed);
+    }
+}
+
+void MeterStore::readSnapshot(MeterSnapshot& snapshot, MeterMode mode) const {
+    // Levels are written continuously and each is its own atomic; only the layout has to be
+    // seen whole, so the sweep is repeated if a layout edit overlapped it.
+    const auto* values = plane(mode);
+    for (;;) {
+        const auto sequence = layoutSequence_.load(std::memory_order_acquire);
+        if ((sequence & 1U) != 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        const auto slots = slotCount_.load(std::memory_order_acquire);
+        const auto channels = channelCount_.load(std::memory_order_acquire);
+        snapshot.ranges.resize(slots);
+        for (std::uint32_t handle = 0; handle < slots; ++handle) {
+            snapshot.ranges[handle] = rangeOf(handle);
+        }
+        snapshot.levels.resize(channels);
+        for (std::uint32_t channel = 0; channel < channels; ++channel) {
+            snapshot.levels[channel] = values[channel].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (layoutSequence_.load(std::memory_order_relaxed) == sequence) {
+            return;
+        }
+    }
+}
+
+std::uint64_t MeterStore::layoutVersion() const noexcept {
+    return layoutVersion_.load(std::memory_order_acquire);
+}
+
 void MeterStore::syncWithTopology(const GraphTopology& topology) {
-    std::unordered_set<std::string> ids;
-    ids.reserve(topology.nodes().size());
+    std::unordered_map<std::string, std::uint32_t> channelCounts;
+    channelCounts.reserve(topology.nodes().size());
     for (const auto& node : topology.nodes()) {
-        ids.insert(node.id());
+        channelCounts.emplace(node.id(), meterChannelCount(node));
+    }
+
+    std::scoped_lock lock(mutex_);
+    const ScopedLayoutWrite write(layoutSequence_);
+    for (auto it = handles_.begin(); it != handles_.end();) {
+        const auto node = channelCounts.find(it->first);
+        if (node == channelCounts.end() || storage_->meters[it->second].numChannels != node->second) {
+            releaseMeterLocked(it->second);
+            it = handles_.erase(it);
+        } else {
+            ++it;
+        }
     }
 
+    for (const auto& [id, numChannels] : channelCounts) {
+        if (!handles_.contains(id)) {
+            createMeterLocked(id, numChannels);
+        }
+    }
+}
+
+void MeterStore::setLoudnessSource(std::string nodeId) {
     std::scoped_lock lock(mutex_);
-    for (const auto& id : ids) {
-        if (!meters_.contains(id)) {
-            meters_.emplace(id, std::make_shared<MeterValue>());
+    loudnessSource_ = std::move(nodeId);
+    for (const auto& [id, handle] : handles_) {
+        storage_->meters[handle].loudness.store(id == loudnessSource_ ? storage_->loudness.get() : nullptr,
+                                                std::memory_order_release);
+    }
+}
+
+void MeterStore::requestReset() noexcept {
+    storage_->resetGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint32_t MeterStore::meterChannelCount(const GraphNode& node) noexcept {
+    return RenderPlan::processingChannelCount(node);
+}
+
+MeterHandle MeterStore::createMeterLocked(const std::string& nodeId, std::uint32_t numChannels) {
+    const auto slots = slotCount_.load(std::memory_order_relaxed);
+    auto handle = kInvalidMeterHandle;
+    for (std::uint32_t candidate = 0; candidate < slots; ++candidate) {
+        if (!assigned_[candidate] && reservedChannels_[candidate] >= numChannels
+            && (!leases_[candidate] || leases_[candidate].use_count() == 1)) {
+            handle = candidate;
+            break;
         }
     }
 
-    for (auto it = meters_.begin(); it != meters_.end();) {
-        if (!ids.contains(it->first)) {
-            it = meters_.erase(it);
-        } else {
-            ++it;
+    std::uint32_t firstChannel = 0;
+    if (handle != kInvalidMeterHandle) {
+        firstChannel = static_cast<std::uint32_t>(storage_->meters[handle].peak - storage_->peak.data());
+    } else {
+        const auto used = channelCount_.load(std::memory_order_relaxed);
+        const auto reserved = static_cast<std::uint32_t>((numChannels + kChannelAlignment - 1) / kChannelAlignment * kChannelAlignment);
+        if (slots >= kCapacity || used + reserved > kChannelCapacity) {
+            return kInvalidMeterHandle;
         }
+        handle = slots;
+        firstChannel = used;
+        reservedChannels_[handle] = reserved;
+        channelCount_.store(used + reserved, std::memory_order_release);
+    }
+
+    auto& slot = storage_->meters[handle];
+    slot.peak = storage_->peak.data() + firstChannel;
+    slot.peakHold = storage_->peakHold.data() + firstChannel;
+    slot.rms = storage_->rms.data() + firstChannel;
+    slot.truePeak = storage_->truePeak.data() + firstChannel;
+    slot.numChannels = numChannels;
+    slot.resetGeneration = &storage_->resetGeneration;
+    slot.loudness.store(nodeId == loudnessSource_ ? storage_->loudness.get() : nullptr, std::memory_order_release);
+    for (std::uint32_t channel = 0; channel < reservedChannels_[handle]; ++channel) {
+        slot.peak[channel].store(0.0F, std::memory_order_relaxed);
+        slot.peakHold[channel].store(0.0F, std::memory_order_relaxed);
+        slot.rms[channel].store(0.0F, std::memory_order_relaxed);
+        slot.truePeak[channel].store(0.0F, std::memory_order_relaxed);
+    }
+    if (!leases_[handle]) {
+        leases_[handle] = MeterPtr(&slot, [storage = storage_](MeterValue*) {});
+    }
+    assigned_[handle] = true;
+    handles_.emplace(nodeId, handle);
+    storage_->ranges[handle].store(packRange(firstChannel, numChannels), std::memory_order_relaxed);
+    if (handle == slots) {
+        slotCount_.store(slots + 1, std::memory_order_release);
     }
+    layoutVersion_.fetch_add(1, std::memory_order_release);
+    return handle;
 }
 
-MeterStore::MeterPtr MeterStore::createMeterLocked(const std::string& nodeId) {
-    auto meter = std::make_shared<MeterValue>();
-    meters_.emplace(nodeId, meter);
-    return meter;
+void MeterStore::releaseMeterLocked(MeterHandle handle) {
+    assigned_[handle] = false;
+    storage_->meters[handle].loudness.store(nullptr, std::memory_order_release);
+    storage_->ranges[handle].store(0, std::memory_order_relaxed);
+    layoutVersion_.fetch_add(1, std::memory_order_release);
+}
+
+MeterRange MeterStore::rangeOf(MeterHandle handle) const noexcept {
+    if (handle >= slotCount_.load(std::memory_order_acquire)) {
+        return {};
+    }
+    const auto packed = storage_->ranges[handle].load(std::memory_order_relaxed);
+    MeterRange range { static_cast<std::uint32_t>(packed >> 32U), static_cast<std::uint32_t>(packed & 0xFFFFFFFFU) };
+    if (range.firstChannel + range.numChannels > channelCount_.load(std::memory_order_acquire)) {
+        return {};
+    }
+    return range;
+}
+
+const std::atomic<float>* MeterStore::plane(MeterMode mode) const noexcept {
+    switch (mode) {
+    case MeterMode::PeakHold:
+        return storage_->peakHold.data();
+    case MeterMode::Rms:
+        return storage_->rms.data();
+    case MeterMode::TruePeak:
+        return storage_->truePeak.data();
+    case MeterMode::Peak:
+    default:
+        return storage_->peak.data();
+    }
 }
 
 } // namespace broadcastmix::audio
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "AudioEngine.h"
 #include "GraphTopology.h"
 
 #include <atomic>
@@ -7,31 +8,77 @@
 #include <mutex>
 #include <string>
 #include <unordered_map>
-#include <array>
+#include <vector>
 
 namespace broadcastmix::audio {
 
+class LoudnessMeter;
+
+// Meters live in a fixed table indexed by MeterHandle. Channel levels are kept in one
+// array per MeterMode, each node's run starting on its own cache line so nodes rendered
+// on different workers never share one. The id map and slot bookkeeping are guarded by
+// mutex_; reading levels never takes it. Layout edits run inside a sequence lock so
+// readSnapshot can retry instead of pairing ranges from two different layouts.
 class MeterStore {
 public:
-    MeterStore();
+    static constexpr std::size_t kCapacity = 1024;
+    static constexpr std::size_t kChannelCapacity = 16384;
+    static constexpr std::size_t kChannelAlignment = 64 / sizeof(std::atomic<float>);
+
+    explicit MeterStore(std::shared_ptr<LoudnessMeter> loudness = nullptr);
     ~MeterStore();
 
     struct MeterValue {
-        MeterValue();
-        std::array<std::atomic<float>, 2> channels;
+        std::atomic<float>* peak { nullptr };
+        std::atomic<float>* peakHold { nullptr };
+        std::atomic<float>* rms { nullptr };
+        std::atomic<float>* truePeak { nullptr };
+        std::uint32_t numChannels { 0 };
+        // Set while this node feeds the loudness meter; only the writer that prepared last
+        // pushes, so the outgoing graph of a crossfade does not feed it twice.
+        std::atomic<LoudnessMeter*> loudness { nullptr };
+        std::atomic<const void*> loudnessWriter { nullptr };
+        // Bumped by requestReset(); writers drop their ballistics when it moves.
+        const std::atomic<std::uint32_t>* resetGeneration { nullptr };
     };
 
     using MeterPtr = std::shared_ptr<MeterValue>;
 
-    MeterPtr meterFor(const std::string& nodeId);
-    std::array<float, 2> levelsFor(const std::string& nodeId) const;
+    MeterPtr meterFor(const GraphNode& node);
+    [[nodiscard]] MeterHandle handleFor(const std::string& nodeId) const;
+    std::vector<float> levelsFor(const std::string& nodeId, MeterMode mode = MeterMode::Peak) const;
+    void readLevels(MeterHandle handle, std::vector<float>& levels, MeterMode mode = MeterMode::Peak) const;
+    void readSnapshot(MeterSnapshot& snapshot, MeterMode mode = MeterMode::Peak) const;
+    [[nodiscard]] std::uint64_t layoutVersion() const noexcept;
     void syncWithTopology(const GraphTopology& topology);
+    void setLoudnessSource(std::string nodeId);
+    void requestReset() noexcept;
+
+    [[nodiscard]] static std::uint32_t meterChannelCount(const GraphNode& node) noexcept;
 
 private:
-    MeterPtr createMeterLocked(const std::string& nodeId);
+    struct Storage;
+
+    MeterHandle createMeterLocked(const std::string& nodeId, std::uint32_t numChannels);
+    void releaseMeterLocked(MeterHandle handle);
+    [[nodiscard]] MeterRange rangeOf(MeterHandle handle) const noexcept;
+    [[nodiscard]] const std::atomic<float>* plane(MeterMode mode) const noexcept;
+
+    std::shared_ptr<Storage> storage_;
+    std::atomic<std::uint32_t> slotCount_ { 0 };
+    std::atomic<std::uint32_t> channelCount_ { 0 };
+    std::atomic<std::uint64_t> layoutVersion_ { 0 };
+    // Odd while meterFor or syncWithTopology is rewriting slots.
+    std::atomic<std::uint64_t> layoutSequence_ { 0 };
 
     mutable std::mutex mutex_;
-    std::unordered_map<std::string, MeterPtr> meters_;
+    std::unordered_map<std::string, MeterHandle> handles_;
+    // One lease per live slot; processors hold copies, so a released slot is only reused
+    // once the graph that wrote to it has been torn down.
+    std::vector<MeterPtr> leases_;
+    std::vector<std::uint32_t> reservedChannels_;
+    std::vector<bool> assigned_;
+    std::string loudnessSource_;
 };
 
 } // namespace broadcastmix::audio
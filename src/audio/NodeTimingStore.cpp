@@ -0,0 +1,124 @@
+#include "NodeTimingStore.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace broadcastmix::audio {
+
+NodeTimingStore::NodeTiming::NodeTiming() {
+    enabled.store(false, std::memory_order_relaxed);
+    blocks.store(0, std::memory_order_relaxed);
+    totalNanoseconds.store(0, std::memory_order_relaxed);
+    lastNanoseconds.store(0, std::memory_order_relaxed);
+    maxNanoseconds.store(0, std::memory_order_relaxed);
+}
+
+void NodeTimingStore::NodeTiming::record(std::uint64_t nanoseconds) noexcept {
+    blocks.fetch_add(1, std::memory_order_relaxed);
+    totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    lastNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+    if (nanoseconds > maxNanoseconds.load(std::memory_order_relaxed)) {
+        maxNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+    }
+}
+
+NodeTimingStore::NodeTimingStore() = default;
+NodeTimingStore::~NodeTimingStore() = default;
+
+NodeTimingStore::TimingPtr NodeTimingStore::timingFor(const std::string& nodeId) {
+    std::scoped_lock lock(mutex_);
+    if (const auto it = timings_.find(nodeId); it != timings_.end()) {
+        return it->second;
+    }
+    return createTimingLocked(nodeId);
+}
+
+NodeTimingStats NodeTimingStore::statsFor(const std::string& nodeId) const {
+    std::scoped_lock lock(mutex_);
+    if (const auto it = timings_.find(nodeId); it != timings_.end() && it->second) {
+        return statsOf(*it->second);
+    }
+    return {};
+}
+
+std::vector<std::pair<std::string, NodeTimingStats>> NodeTimingStore::snapshot() const {
+    std::vector<std::pair<std::string, NodeTimingStats>> result;
+    {
+        std::scoped_lock lock(mutex_);
+        result.reserve(timings_.size());
+        for (const auto& [id, timing] : timings_) {
+            if (timing) {
+                result.emplace_back(id, statsOf(*timing));
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second.totalNanoseconds > rhs.second.totalNanoseconds;
+    });
+    return result;
+}
+
+void NodeTimingStore::syncWithTopology(const GraphTopology& topology) {
+    std::unordered_set<std::string> ids;
+    ids.reserve(topology.nodes().size());
+    for (const auto& node : topology.nodes()) {
+        ids.insert(node.id());
+    }
+
+    std::scoped_lock lock(mutex_);
+    for (const auto& id : ids) {
+        if (!timings_.contains(id)) {
+            createTimingLocked(id);
+        }
+    }
+
+    for (auto it = timings_.begin(); it != timings_.end();) {
+        if (!ids.contains(it->first)) {
+            it = timings_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void NodeTimingStore::setEnabled(bool enabled) {
+    std::scoped_lock lock(mutex_);
+    enabled_ = enabled;
+    for (auto& [id, timing] : timings_) {
+        timing->enabled.store(enabled, std::memory_order_relaxed);
+    }
+}
+
+bool NodeTimingStore::isEnabled() const {
+    std::scoped_lock lock(mutex_);
+    return enabled_;
+}
+
+void NodeTimingStore::reset() {
+    std::scoped_lock lock(mutex_);
+    for (auto& [id, timing] : timings_) {
+        timing->blocks.store(0, std::memory_order_relaxed);
+        timing->totalNanoseconds.store(0, std::memory_order_relaxed);
+        timing->lastNanoseconds.store(0, std::memory_order_relaxed);
+        timing->maxNanoseconds.store(0, std::memory_order_relaxed);
+    }
+}
+
+NodeTimingStore::TimingPtr NodeTimingStore::createTimingLocked(const std::string& nodeId) {
+    auto timing = std::make_shared<NodeTiming>();
+    timing->enabled.store(enabled_, std::memory_order_relaxed);
+    timings_.emplace(nodeId, timing);
+    return timing;
+}
+
+NodeTimingStats NodeTimingStore::statsOf(const NodeTiming& timing) {
+    NodeTimingStats stats;
+    stats.blocks = timing.blocks.load(std::memory_order_relaxed);
+    stats.totalNanoseconds = timing.totalNanoseconds.load(std::memory_order_relaxed);
+    stats.lastNanoseconds = timing.lastNanoseconds.load(std::memory_order_relaxed);
+    stats.maxNanoseconds = timing.maxNanoseconds.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace broadcastmix::audio
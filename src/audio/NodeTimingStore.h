@@ -0,0 +1,78 @@
+#pragma once
+
+#include "AudioEngine.h"
+#include "GraphTopology.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace broadcastmix::audio {
+
+class NodeTimingStore {
+public:
+    NodeTimingStore();
+    ~NodeTimingStore();
+
+    struct NodeTiming {
+        NodeTiming();
+
+        void record(std::uint64_t nanoseconds) noexcept;
+
+        std::atomic<bool> enabled;
+        std::atomic<std::uint64_t> blocks;
+        std::atomic<std::uint64_t> totalNanoseconds;
+        std::atomic<std::uint64_t> lastNanoseconds;
+        std::atomic<std::uint64_t> maxNanoseconds;
+    };
+
+    using TimingPtr = std::shared_ptr<NodeTiming>;
+
+    TimingPtr timingFor(const std::string& nodeId);
+    NodeTimingStats statsFor(const std::string& nodeId) const;
+    std::vector<std::pair<std::string, NodeTimingStats>> snapshot() const;
+    void syncWithTopology(const GraphTopology& topology);
+    void setEnabled(bool enabled);
+    [[nodiscard]] bool isEnabled() const;
+    void reset();
+
+private:
+    TimingPtr createTimingLocked(const std::string& nodeId);
+    static NodeTimingStats statsOf(const NodeTiming& timing);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, TimingPtr> timings_;
+    bool enabled_ { false };
+};
+
+// Times one processBlock call into a node's accumulator; free when profiling is off.
+class ScopedNodeTimer {
+public:
+    explicit ScopedNodeTimer(NodeTimingStore::NodeTiming* timing) noexcept
+        : timing_(timing != nullptr && timing->enabled.load(std::memory_order_relaxed) ? timing : nullptr) {
+        if (timing_ != nullptr) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedNodeTimer() {
+        if (timing_ != nullptr) {
+            const auto elapsed = std::chrono::steady_clock::now() - start_;
+            timing_->record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    }
+
+    ScopedNodeTimer(const ScopedNodeTimer&) = delete;
+    ScopedNodeTimer& operator=(const ScopedNodeTimer&) = delete;
+
+private:
+    NodeTimingStore::NodeTiming* timing_;
+    std::chrono::steady_clock::time_point start_ {};
+};
+
+} // namespace broadcastmix::audio
@@ -0,0 +1,245 @@
+#include "OfflineRenderer.h"
+
+#if BROADCASTMIX_HAS_JUCE
+
+#include "RealtimeScope.h"
+#include "../core/Logging.h"
+
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace broadcastmix::audio {
+
+OfflineRenderer::OfflineRenderer() = default;
+
+OfflineRenderer::~OfflineRenderer() {
+    release();
+}
+
+void OfflineRenderer::setProcessor(juce::AudioProcessor* processor) {
+    if (processor == processor_) {
+        return;
+    }
+    release();
+    processor_ = processor;
+}
+
+void OfflineRenderer::prepare(const AudioEngineSettings& settings) {
+    release();
+    if (processor_ == nullptr) {
+        return;
+    }
+
+    numInputs_ = static_cast<int>(settings.inputChannels);
+    numOutputs_ = static_cast<int>(settings.outputChannels);
+    blockSize_ = static_cast<int>(std::max<std::uint32_t>(1U, settings.blockSize));
+    const auto sampleRate = static_cast<double>(settings.sampleRate > 0 ? settings.sampleRate : 48000);
+
+    buffer_.setSize(std::max({ numInputs_, numOutputs_, 1 }), blockSize_, false, true, false);
+    midi_.ensureSize(256);
+
+    processor_->setNonRealtime(true);
+    processor_->setPlayConfigDetails(numInputs_, numOutputs_, sampleRate, blockSize_);
+    processor_->prepareToPlay(sampleRate, blockSize_);
+    prepared_ = true;
+}
+
+void OfflineRenderer::release() {
+    if (!prepared_ || processor_ == nullptr) {
+        return;
+    }
+
+    processor_->releaseResources();
+    processor_->setNonRealtime(false);
+    prepared_ = false;
+}
+
+bool OfflineRenderer::isPrepared() const noexcept {
+    return prepared_;
+}
+
+void OfflineRenderer::processBlock(const float* const* inputs,
+                                   std::uint32_t numInputs,
+                                   float* const* outputs,
+                                   std::uint32_t numOutputs,
+                                   std::uint32_t numSamples) {
+    if (!prepared_) {
+        return;
+    }
+
+    const RealtimeScope realtime;
+    const auto copyInputs = std::min(static_cast<int>(numInputs), numInputs_);
+    const auto copyOutputs = std::min(static_cast<int>(numOutputs), numOutputs_);
+
+    for (std::uint32_t offset = 0; offset < numSamples;) {
+        const auto chunk = static_cast<int>(std::min<std::uint32_t>(numSamples - offset, static_cast<std::uint32_t>(blockSize_)));
+        resizeChunk(chunk);
+
+        for (int channel = 0; channel < buffer_.getNumChannels(); ++channel) {
+            if (channel < copyInputs && inputs != nullptr && inputs[channel] != nullptr) {
+                buffer_.copyFrom(channel, 0, inputs[channel] + offset, chunk);
+            } else {
+                buffer_.clear(channel, 0, chunk);
+            }
+        }
+
+        renderChunk();
+
+        for (int channel = 0; channel < copyOutputs; ++channel) {
+            if (outputs != nullptr && outputs[channel] != nullptr) {
+                juce::FloatVectorOperations::copy(outputs[channel] + offset, buffer_.getReadPointer(channel), chunk);
+            }
+        }
+        for (auto channel = static_cast<std::uint32_t>(copyOutputs); channel < numOutputs; ++channel) {
+            if (outputs != nullptr && outputs[channel] != nullptr) {
+                juce::FloatVectorOperations::clear(outputs[channel] + offset, chunk);
+            }
+        }
+
+        offset += static_cast<std::uint32_t>(chunk);
+    }
+}
+
+// buffer_ keeps the storage it was prepared with, so resizing it within the block size
+// only relays the channels. A view over its pointers would allocate instead: juce::AudioBuffer
+// keeps just 32 channel pointers inline. Contents are not kept, so call this before filling.
+void OfflineRenderer::resizeChunk(int numSamples) {
+    buffer_.setSize(buffer_.getNumChannels(), numSamples, false, false, true);
+}
+
+void OfflineRenderer::renderChunk() {
+    midi_.clear();
+    processor_->processBlock(buffer_, midi_);
+}
+
+OfflineRenderResult OfflineRenderer::render(const OfflineRenderRequest& request, const AudioEngineSettings& settings) {
+    OfflineRenderResult result;
+
+    juce::AudioFormatManager formatManager;
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    std::uint64_t length = request.lengthInSamples;
+
+    if (!request.inputFile.empty()) {
+        formatManager.registerBasicFormats();
+        reader.reset(formatManager.createReaderFor(juce::File(request.inputFile)));
+        if (reader == nullptr) {
+            result.error = "Unable to open input file " + request.inputFile;
+            return result;
+        }
+        if (length == 0) {
+            length = static_cast<std::uint64_t>(std::max<juce::int64>(0, reader->lengthInSamples));
+        }
+    } else if (length == 0) {
+        for (const auto& channel : request.inputBuffers) {
+            length = std::max<std::uint64_t>(length, channel.size());
+        }
+    }
+
+    if (length == 0) {
+        result.error = "Nothing to render: no input and no length requested";
+        return result;
+    }
+
+    prepare(settings);
+    if (!prepared_) {
+        result.error = "No processor graph to render";
+        return result;
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    if (!request.outputFile.empty()) {
+        const juce::File outputFile(request.outputFile);
+        outputFile.getParentDirectory().createDirectory();
+        outputFile.deleteFile();
+        if (auto stream = outputFile.createOutputStream()) {
+            juce::WavAudioFormat wav;
+            writer.reset(wav.createWriterFor(stream.get(),
+                                             processor_->getSampleRate(),
+                                             static_cast<unsigned int>(std::max(numOutputs_, 1)),
+                                             24,
+                                             {},
+                                             0));
+            if (writer != nullptr) {
+                stream.release();
+            }
+        }
+        if (writer == nullptr) {
+            release();
+            result.error = "Unable to create output file " + request.outputFile;
+            return result;
+        }
+    }
+
+    if (request.collectOutput) {
+        result.outputBuffers.assign(static_cast<std::size_t>(numOutputs_), {});
+        for (auto& channel : result.outputBuffers) {
+            channel.reserve(static_cast<std::size_t>(length));
+        }
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    for (std::uint64_t position = 0; position < length;) {
+        const auto chunk = static_cast<int>(std::min<std::uint64_t>(length - position, static_cast<std::uint64_t>(blockSize_)));
+        resizeChunk(chunk);
+
+        if (reader != nullptr) {
+            reader->read(&buffer_, 0, chunk, static_cast<juce::int64>(position), true, true);
+            for (int channel = std::min(numInputs_, static_cast<int>(reader->numChannels)); channel < buffer_.getNumChannels(); ++channel) {
+                buffer_.clear(channel, 0, chunk);
+            }
+        } else {
+            for (int channel = 0; channel < buffer_.getNumChannels(); ++channel) {
+                buffer_.clear(channel, 0, chunk);
+                if (channel >= numInputs_ || static_cast<std::size_t>(channel) >= request.inputBuffers.size()) {
+                    continue;
+                }
+                const auto& source = request.inputBuffers[static_cast<std::size_t>(channel)];
+                if (position < source.size()) {
+                    const auto available = static_cast<int>(std::min<std::uint64_t>(source.size() - position, static_cast<std::uint64_t>(chunk)));
+                    buffer_.copyFrom(channel, 0, source.data() + position, available);
+                }
+            }
+        }
+
+        renderChunk();
+
+        if (writer != nullptr) {
+            writer->writeFromFloatArrays(buffer_.getArrayOfReadPointers(), std::max(numOutputs_, 1), chunk);
+        }
+
+        if (request.collectOutput) {
+            for (int channel = 0; channel < numOutputs_; ++channel) {
+                const auto* data = buffer_.getReadPointer(channel);
+                auto& destination = result.outputBuffers[static_cast<std::size_t>(channel)];
+                destination.insert(destination.end(), data, data + chunk);
+            }
+        }
+
+        position += static_cast<std::uint64_t>(chunk);
+    }
+
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    writer.reset();
+    release();
+
+    result.success = true;
+    result.samplesRendered = length;
+    result.audioSeconds = static_cast<double>(length) / static_cast<double>(settings.sampleRate > 0 ? settings.sampleRate : 48000);
+    result.wallSeconds = elapsed;
+    result.realtimeFactor = elapsed > 0.0 ? result.audioSeconds / elapsed : 0.0;
+
+    core::log(core::LogCategory::Audio,
+              "Offline render finished: {} samples in {:.2f}s ({:.2f}x realtime)",
+              result.samplesRendered,
+              result.wallSeconds,
+              result.realtimeFactor);
+    return result;
+}
+
+} // namespace broadcastmix::audio
+
+#endif // BROADCASTMIX_HAS_JUCE
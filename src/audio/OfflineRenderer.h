@@ -0,0 +1,46 @@
+#pragma once
+
+#include "AudioEngine.h"
+
+#if BROADCASTMIX_HAS_JUCE
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace broadcastmix::audio {
+
+class OfflineRenderer {
+public:
+    OfflineRenderer();
+    ~OfflineRenderer();
+
+    OfflineRenderer(const OfflineRenderer&) = delete;
+    OfflineRenderer& operator=(const OfflineRenderer&) = delete;
+
+    void setProcessor(juce::AudioProcessor* processor);
+    void prepare(const AudioEngineSettings& settings);
+    void release();
+    [[nodiscard]] bool isPrepared() const noexcept;
+
+    void processBlock(const float* const* inputs,
+                      std::uint32_t numInputs,
+                      float* const* outputs,
+                      std::uint32_t numOutputs,
+                      std::uint32_t numSamples);
+
+    [[nodiscard]] OfflineRenderResult render(const OfflineRenderRequest& request, const AudioEngineSettings& settings);
+
+private:
+    void resizeChunk(int numSamples);
+    void renderChunk();
+
+    juce::AudioProcessor* processor_ { nullptr };
+    juce::AudioBuffer<float> buffer_;
+    juce::MidiBuffer midi_;
+    int numInputs_ { 0 };
+    int numOutputs_ { 0 };
+    int blockSize_ { 0 };
+    bool prepared_ { false };
+};
+
+} // namespace broadcastmix::audio
+
+#endif // BROADCASTMIX_HAS_JUCE
@@ -0,0 +1,172 @@
+#include "ParameterStore.h"
+
+#include "dsp/ChannelStrip.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace broadcastmix::audio {
+
+namespace {
+// Channel strip slots start at the strip's own defaults, which leave every stage flat.
+float channelStripDefault(NodeParameter parameter) noexcept {
+    const dsp::ChannelStrip::Settings strip;
+    const auto index = static_cast<std::size_t>(parameter);
+    const auto firstBand = static_cast<std::size_t>(NodeParameter::EqLowFrequency);
+    if (index >= firstBand && index < firstBand + dsp::ChannelStrip::kBands * 3) {
+        const auto& band = strip.bands[(index - firstBand) / 3];
+        const float fields[] = { band.frequency, band.gainDecibels, band.q };
+        return fields[(index - firstBand) % 3];
+    }
+    switch (parameter) {
+    case NodeParameter::HighPassFrequency:
+        return strip.highPassFrequency;
+    case NodeParameter::GateThreshold:
+        return strip.gateThresholdDecibels;
+    case NodeParameter::CompressorThreshold:
+        return strip.compressorThresholdDecibels;
+    case NodeParameter::CompressorRatio:
+        return strip.compressorRatio;
+    case NodeParameter::CompressorAttack:
+        return strip.compressorAttackMilliseconds;
+    case NodeParameter::CompressorRelease:
+        return strip.compressorReleaseMilliseconds;
+    case NodeParameter::CompressorMakeup:
+        return strip.makeupDecibels;
+    default:
+        return 0.0F;
+    }
+}
+} // namespace
+
+ParameterStore::NodeParameters::NodeParameters() {
+    for (auto& value : values) {
+        value.store(0.0F, std::memory_order_relaxed);
+    }
+    recallSafe.store(false, std::memory_order_relaxed);
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+ParameterStore::ParameterStore() = default;
+ParameterStore::~ParameterStore() = default;
+
+ParameterStore::ParametersPtr ParameterStore::parametersFor(const GraphNode& node) {
+    std::scoped_lock lock(mutex_);
+    if (const auto it = parameters_.find(node.id()); it != parameters_.end()) {
+        return it->second;
+    }
+    return createParametersLocked(node);
+}
+
+ParameterStore::ParametersPtr ParameterStore::find(const std::string& nodeId) const {
+    std::scoped_lock lock(mutex_);
+    if (const auto it = parameters_.find(nodeId); it != parameters_.end()) {
+        return it->second;
+    }
+    return nullptr;
+}
+
+bool ParameterStore::setParameter(const std::string& nodeId, NodeParameter parameter, float value) {
+    if (!std::isfinite(value)) {
+        return false;
+    }
+
+    std::scoped_lock lock(mutex_);
+    const auto it = parameters_.find(nodeId);
+    if (it == parameters_.end()) {
+        return false;
+    }
+    it->second->store(parameter, value);
+    return true;
+}
+
+std::optional<float> ParameterStore::parameter(const std::string& nodeId, NodeParameter parameter) const {
+    std::scoped_lock lock(mutex_);
+    if (const auto it = parameters_.find(nodeId); it != parameters_.end()) {
+        return it->second->load(parameter);
+    }
+    return std::nullopt;
+}
+
+bool ParameterStore::setRecallSafe(const std::string& nodeId, bool safe) {
+    std::scoped_lock lock(mutex_);
+    const auto it = parameters_.find(nodeId);
+    if (it == parameters_.end()) {
+        return false;
+    }
+    it->second->recallSafe.store(safe, std::memory_order_relaxed);
+    return true;
+}
+
+std::vector<SnapshotParameter> ParameterStore::capture() const {
+    std::vector<SnapshotParameter> result;
+    {
+        std::scoped_lock lock(mutex_);
+        result.reserve(parameters_.size() * kNodeParameterCount);
+        for (const auto& [id, parameters] : parameters_) {
+            for (std::size_t index = 0; index < kNodeParameterCount; ++index) {
+                const auto parameter = static_cast<NodeParameter>(index);
+                result.push_back({ id, parameter, parameters->load(parameter) });
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.nodeId != rhs.nodeId ? lhs.nodeId < rhs.nodeId : lhs.parameter < rhs.parameter;
+    });
+    return result;
+}
+
+void ParameterStore::syncWithTopology(const GraphTopology& topology) {
+    std::unordered_set<std::string> ids;
+    ids.reserve(topology.nodes().size());
+
+    std::scoped_lock lock(mutex_);
+    for (const auto& node : topology.nodes()) {
+        ids.insert(node.id());
+        if (!parameters_.contains(node.id())) {
+            createParametersLocked(node);
+        }
+    }
+
+    for (auto it = parameters_.begin(); it != parameters_.end();) {
+        if (!ids.contains(it->first)) {
+            it = parameters_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+float ParameterStore::defaultValue(const GraphNode& node, NodeParameter parameter) noexcept {
+    switch (parameter) {
+    case NodeParameter::Gain:
+        if (node.type() == GraphNodeType::Utility && node.label() == "Monitor Trim -3 dB") {
+            return std::pow(10.0F, -3.0F / 20.0F);
+        }
+        return 1.0F;
+    case NodeParameter::Mute:
+        return 0.0F;
+    case NodeParameter::Signal:
+        return static_cast<float>(GeneratorSignal::Sine);
+    case NodeParameter::Frequency:
+        return 1000.0F;
+    default:
+        break;
+    }
+    return channelStripDefault(parameter);
+}
+
+ParameterStore::ParametersPtr ParameterStore::createParametersLocked(const GraphNode& node) {
+    auto parameters = std::make_shared<NodeParameters>();
+    for (std::size_t index = 0; index < kNodeParameterCount; ++index) {
+        const auto parameter = static_cast<NodeParameter>(index);
+        parameters->store(parameter, defaultValue(node, parameter));
+    }
+    parameters->enabled.store(node.enabled(), std::memory_order_relaxed);
+    parameters_.emplace(node.id(), parameters);
+    return parameters;
+}
+
+} // namespace broadcastmix::audio
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "AudioEngine.h"
+#include "GraphTopology.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace broadcastmix::audio {
+
+// Per-node parameter slots shared between the control thread and the processors built
+// for that node. Writing a value is a single atomic store; processors pick it up on their
+// next block and smooth towards it. Slots outlive graph rebuilds, so values survive edits.
+class ParameterStore {
+public:
+    ParameterStore();
+    ~ParameterStore();
+
+    struct NodeParameters {
+        NodeParameters();
+
+        [[nodiscard]] float load(NodeParameter parameter) const noexcept {
+            return values[static_cast<std::size_t>(parameter)].load(std::memory_order_relaxed);
+        }
+
+        void store(NodeParameter parameter, float value) noexcept {
+            values[static_cast<std::size_t>(parameter)].store(value, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] bool isBypassed() const noexcept {
+            return !enabled.load(std::memory_order_relaxed);
+        }
+
+        std::array<std::atomic<float>, kNodeParameterCount> values;
+        // Safe nodes keep their values when a snapshot is recalled, including mid-glide.
+        std::atomic<bool> recallSafe;
+        // Mirrors GraphNode::enabled(); a disabled node's processor leaves its block untouched.
+        std::atomic<bool> enabled;
+    };
+
+    using ParametersPtr = std::shared_ptr<NodeParameters>;
+
+    ParametersPtr parametersFor(const GraphNode& node);
+    [[nodiscard]] ParametersPtr find(const std::string& nodeId) const;
+    bool setParameter(const std::string& nodeId, NodeParameter parameter, float value);
+    [[nodiscard]] std::optional<float> parameter(const std::string& nodeId, NodeParameter parameter) const;
+    bool setRecallSafe(const std::string& nodeId, bool safe);
+    [[nodiscard]] std::vector<SnapshotParameter> capture() const;
+    void syncWithTopology(const GraphTopology& topology);
+
+    [[nodiscard]] static float defaultValue(const GraphNode& node, NodeParameter parameter) noexcept;
+
+private:
+    ParametersPtr createParametersLocked(const GraphNode& node);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, ParametersPtr> parameters_;
+};
+
+} // namespace broadcastmix::audio
@@ -0,0 +1,118 @@
+#include "ProcessorFactory.h"
+
+#if BROADCASTMIX_HAS_JUCE
+
+#include "processors/ChannelStripProcessor.h"
+#include "processors/GainProcessor.h"
+#include "processors/PassThroughProcessor.h"
+#include "processors/SignalGeneratorProcessor.h"
+
+#include <algorithm>
+
+namespace broadcastmix::audio {
+
+namespace {
+juce::AudioChannelSet channelSetForNode(const GraphNode& node) {
+    const auto channels = static_cast<int>(std::max(node.inputChannelCount(), node.outputChannelCount()));
+    if (channels <= 0) {
+        return juce::AudioChannelSet::stereo();
+    }
+    if (channels == 1) {
+        return juce::AudioChannelSet::mono();
+    }
+    if (channels == 2) {
+        return juce::AudioChannelSet::stereo();
+    }
+    return juce::AudioChannelSet::discreteChannels(channels);
+}
+} // namespace
+
+ProcessorFactory::ProcessorFactory(std::shared_ptr<MeterStore> meterStore,
+                                   std::shared_ptr<NodeTimingStore> timingStore,
+                                   std::shared_ptr<ParameterStore> parameterStore)
+    : meterStore_(std::move(meterStore))
+    , timingStore_(std::move(timingStore))
+    , parameterStore_(std::move(parameterStore)) {}
+
+std::unique_ptr<juce::AudioProcessor> ProcessorFactory::createProcessorForNode(const GraphNode& node) const {
+    auto meter = meterStore_ ? meterStore_->meterFor(node) : nullptr;
+    auto timing = timingStore_ ? timingStore_->timingFor(node.id()) : nullptr;
+    auto parameters = parameterStore_ ? parameterStore_->parametersFor(node) : nullptr;
+    switch (node.type()) {
+    case GraphNodeType::Input:
+        return std::make_unique<processors::PassThroughProcessor>(node.label().empty() ? "Input" : node.label(),
+                                                                  meter,
+                                                                  channelSetForNode(node),
+                                                                  timing,
+                                                                  parameters);
+    case GraphNodeType::Output:
+        return std::make_unique<processors::PassThroughProcessor>(node.label().empty() ? "Output" : node.label(),
+                                                                  meter,
+                                                                  channelSetForNode(node),
+                                                                  timing,
+                                                                  parameters);
+    case GraphNodeType::SignalGenerator:
+        return std::make_unique<processors::SignalGeneratorProcessor>(meter,
+                                                                      channelSetForNode(node),
+                                                                      timing,
+                                                                      parameters);
+    case GraphNodeType::Utility:
+        if (node.label() == "Monitor Trim -3 dB") {
+            return std::make_unique<processors::GainProcessor>(ParameterStore::defaultValue(node, NodeParameter::Gain),
+                                                               std::move(parameters),
+                                                               "Monitor Trim -3 dB",
+                                                               meter,
+                                                               channelSetForNode(node),
+                                                               timing);
+        }
+        return std::make_unique<processors::PassThroughProcessor>("Utility",
+                                                                  meter,
+                                                                  channelSetForNode(node),
+                                                                  timing,
+                                                                  parameters);
+    case GraphNodeType::BroadcastBus:
+        return std::make_unique<processors::PassThroughProcessor>("Broadcast Bus",
+                                                                  meter,
+                                                                  channelSetForNode(node),
+                                                                  timing,
+                                                                  parameters);
+    case GraphNodeType::MixBus:
+        return std::make_unique<processors::PassThroughProcessor>(node.label().empty() ? "Monitor Bus" : node.label(),
+                                                                  meter,
+                                                                  channelSetForNode(node),
+                                                                  timing,
+                                                                  parameters);
+    case GraphNodeType::GroupBus:
+    case GraphNodeType::Person:
+        return std::make_unique<processors::PassThroughProcessor>("Group Bus",
+                                                                  meter,
+                                                                  channelSetForNode(node),
+                                                                  timing,
+                                                                  parameters);
+    case GraphNodeType::Channel:
+        return std::make_unique<processors::ChannelStripProcessor>(meter,
+                                                                   channelSetForNode(node),
+                                                                   timing,
+                                                                   parameters);
+    case GraphNodeType::Plugin:
+        return std::make_unique<processors::PassThroughProcessor>("Plugin Placeholder",
+                                                                  meter,
+                                                                  channelSetForNode(node),
+                                                                  timing,
+                                                                  parameters);
+    default:
+        return std::make_unique<processors::PassThroughProcessor>("Node",
+                                                                  meter,
+                                                                  channelSetForNode(node),
+                                                                  timing,
+                                                                  parameters);
+    }
+}
+
+bool ProcessorFactory::isPassThrough(const juce::AudioProcessor& processor) {
+    return dynamic_cast<const processors::PassThroughProcessor*>(&processor) != nullptr;
+}
+
+} // namespace broadcastmix::audio
+
+#endif // BROADCASTMIX_HAS_JUCE
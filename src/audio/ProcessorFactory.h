@@ -0,0 +1,32 @@
+#pragma once
+
+#include "GraphNode.h"
+#include "MeterStore.h"
+#include "NodeTimingStore.h"
+#include "ParameterStore.h"
+
+#if BROADCASTMIX_HAS_JUCE
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <memory>
+
+namespace broadcastmix::audio {
+
+class ProcessorFactory {
+public:
+    explicit ProcessorFactory(std::shared_ptr<MeterStore> meterStore,
+                              std::shared_ptr<NodeTimingStore> timingStore = nullptr,
+                              std::shared_ptr<ParameterStore> parameterStore = nullptr);
+
+    [[nodiscard]] std::unique_ptr<juce::AudioProcessor> createProcessorForNode(const GraphNode& node) const;
+    [[nodiscard]] static bool isPassThrough(const juce::AudioProcessor& processor);
+
+private:
+    std::shared_ptr<MeterStore> meterStore_;
+    std::shared_ptr<NodeTimingStore> timingStore_;
+    std::shared_ptr<ParameterStore> parameterStore_;
+};
+
+} // namespace broadcastmix::audio
+
+#endif // BROADCASTMIX_HAS_JUCE
@@ -0,0 +1,24 @@
+#include "RealtimeScope.h"
+
+namespace broadcastmix::audio {
+
+namespace {
+// constinit keeps the flag in static TLS, so reading it from an interposed malloc can
+// never itself allocate.
+constinit thread_local bool realtimeThread = false;
+} // namespace
+
+RealtimeScope::RealtimeScope() noexcept
+    : previous_(realtimeThread) {
+    realtimeThread = true;
+}
+
+RealtimeScope::~RealtimeScope() {
+    realtimeThread = previous_;
+}
+
+bool inRealtimeScope() noexcept {
+    return realtimeThread;
+}
+
+} // namespace broadcastmix::audio
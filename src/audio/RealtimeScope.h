@@ -0,0 +1,23 @@
+#pragma once
+
+namespace broadcastmix::audio {
+
+// Marks the calling thread as running audio-callback code for the scope's lifetime.
+// Nothing is enforced in a normal build; the realtime sanitizer test
+// (BROADCASTMIX_REALTIME_SANITIZER) interposes allocation, locking and sleeping and
+// fails on any call made while a scope is open. Scopes nest.
+class RealtimeScope {
+public:
+    RealtimeScope() noexcept;
+    ~RealtimeScope();
+
+    RealtimeScope(const RealtimeScope&) = delete;
+    RealtimeScope& operator=(const RealtimeScope&) = delete;
+
+private:
+    bool previous_ { false };
+};
+
+[[nodiscard]] bool inRealtimeScope() noexcept;
+
+} // namespace broadcastmix::audio
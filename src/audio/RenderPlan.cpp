@@ -0,0 +1,486 @@
+#include "RenderPlan.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+namespace broadcastmix::audio {
+
+namespace {
+
+class BufferAllocator {
+public:
+    template <typename Predicate>
+    std::uint32_t allocate(Predicate&& reusable) {
+        for (auto it = freeList_.rbegin(); it != freeList_.rend(); ++it) {
+            if (reusable(*it)) {
+                const auto buffer = *it;
+                freeList_.erase(std::next(it).base());
+                return buffer;
+            }
+        }
+        refCounts_.push_back(0);
+        return static_cast<std::uint32_t>(refCounts_.size() - 1);
+    }
+
+    void retain(std::uint32_t buffer) {
+        ++refCounts_[buffer];
+    }
+
+    void release(std::uint32_t buffer) {
+        if (--refCounts_[buffer] == 0) {
+            // Most recently freed first: the slot that was just written is the one most likely still in cache.
+            freeList_.push_back(buffer);
+        }
+    }
+
+    [[nodiscard]] std::uint32_t references(std::uint32_t buffer) const {
+        return refCounts_[buffer];
+    }
+
+    [[nodiscard]] std::uint32_t count() const {
+        return static_cast<std::uint32_t>(refCounts_.size());
+    }
+
+private:
+    std::vector<std::uint32_t> refCounts_;
+    std::vector<std::uint32_t> freeList_;
+};
+
+// One bit per step; used to prove that two steps can never run at the same time.
+class StepSet {
+public:
+    explicit StepSet(std::size_t steps = 0)
+        : words_((steps + 63) / 64, 0) {}
+
+    void insert(std::uint32_t step) {
+        words_[step / 64] |= std::uint64_t { 1 } << (step % 64);
+    }
+
+    void merge(const StepSet& other) {
+        for (std::size_t word = 0; word < words_.size(); ++word) {
+            words_[word] |= other.words_[word];
+        }
+    }
+
+    void clear() {
+        std::fill(words_.begin(), words_.end(), 0);
+    }
+
+    [[nodiscard]] bool isSubsetOf(const StepSet& other, std::uint32_t except) const {
+        for (std::size_t word = 0; word < words_.size(); ++word) {
+            auto bits = words_[word];
+            if (word == except / 64) {
+                bits &= ~(std::uint64_t { 1 } << (except % 64));
+            }
+            if ((bits & ~other.words_[word]) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::vector<std::uint64_t> words_;
+};
+
+struct SignalSource {
+    std::uint32_t value { 0 };
+    float gain { 1.0F };
+};
+
+// I/O nodes without declared channels are wired to the first hardware channel only, as in the processor graph.
+std::uint32_t hardwareChannels(const GraphNode& node) {
+    return std::max<std::uint32_t>(1U, std::max(node.inputChannelCount(), node.outputChannelCount()));
+}
+
+} // namespace
+
+std::uint32_t RenderPlan::processingChannelCount(const GraphNode& node) noexcept {
+    // Mirrors the channel sets handed to processors: nodes without declared channels run as stereo.
+    const auto channels = std::max(node.inputChannelCount(), node.outputChannelCount());
+    return channels == 0 ? 2U : channels;
+}
+
+RenderPlan RenderPlan::compile(const GraphTopology& topology, const RenderPlanOptions& options) {
+    RenderPlan plan;
+    const auto& nodes = topology.nodes();
+    const auto nodeCount = static_cast<std::uint32_t>(nodes.size());
+    const auto hardwareInputs = options.hardwareInputs;
+
+    // Signals ("values") are numbered hardware inputs first, then every node output channel.
+    std::unordered_map<std::string, std::uint32_t> indexById;
+    indexById.reserve(nodeCount);
+    std::vector<std::uint32_t> channels(nodeCount);
+    std::vector<std::uint32_t> valueBase(nodeCount);
+    std::vector<std::uint32_t> producer;
+    producer.assign(hardwareInputs, std::numeric_limits<std::uint32_t>::max());
+    auto valueCount = hardwareInputs;
+    for (std::uint32_t index = 0; index < nodeCount; ++index) {
+        indexById.emplace(nodes[index].id(), index);
+        channels[index] = processingChannelCount(nodes[index]);
+        valueBase[index] = valueCount;
+        valueCount += channels[index];
+        plan.totalChannels += channels[index];
+        producer.insert(producer.end(), channels[index], index);
+    }
+
+    const auto inputSlot = [&](std::uint32_t node, std::uint32_t channel) {
+        return valueBase[node] - hardwareInputs + channel;
+    };
+
+    std::vector<std::vector<SignalSource>> sources(valueCount - hardwareInputs);
+    std::vector<std::vector<std::uint32_t>> successors(nodeCount);
+    std::vector<std::uint32_t> indegree(nodeCount, 0);
+
+    for (const auto& connection : topology.connections()) {
+        const auto fromIt = indexById.find(connection.fromNodeId);
+        const auto toIt = indexById.find(connection.toNodeId);
+        if (fromIt == indexById.end() || toIt == indexById.end() || fromIt->second == toIt->second) {
+            continue;
+        }
+        const auto from = fromIt->second;
+        const auto to = toIt->second;
+        bool wired = false;
+        GraphTopology::forEachChannelPair(connection,
+                                          channels[from],
+                                          channels[to],
+                                          [&](std::uint32_t fromChannel, std::uint32_t toChannel) {
+            if (fromChannel >= channels[from] || toChannel >= channels[to]) {
+                return;
+            }
+            // Overlapping fan-outs may name the same pair twice; the first connection wins.
+            const auto value = valueBase[from] + fromChannel;
+            auto& slotSources = sources[inputSlot(to, toChannel)];
+            if (std::none_of(slotSources.begin(), slotSources.end(), [&](const auto& source) { return source.value == value; })) {
+                slotSources.push_back({ value, connection.gain });
+                wired = true;
+            }
+        });
+        if (!wired) {
+            continue;
+        }
+        successors[from].push_back(to);
+        ++indegree[to];
+    }
+
+    for (std::uint32_t index = 0; index < nodeCount; ++index) {
+        if (nodes[index].type() != GraphNodeType::Input) {
+            continue;
+        }
+        for (std::uint32_t channel = 0; channel < std::min(hardwareChannels(nodes[index]), hardwareInputs); ++channel) {
+            sources[inputSlot(index, channel)].push_back({ channel, 1.0F });
+        }
+    }
+
+    std::vector<std::uint32_t> order;
+    order.reserve(nodeCount);
+    for (std::uint32_t index = 0; index < nodeCount; ++index) {
+        if (indegree[index] == 0) {
+            order.push_back(index);
+        }
+    }
+    for (std::size_t head = 0; head < order.size(); ++head) {
+        for (const auto next : successors[order[head]]) {
+            if (--indegree[next] == 0) {
+                order.push_back(next);
+            }
+        }
+    }
+    if (order.size() < nodeCount) {
+        // Feedback loops cannot be scheduled; run those nodes last and treat their late inputs as silence.
+        std::vector<bool> scheduled(nodeCount, false);
+        for (const auto index : order) {
+            scheduled[index] = true;
+        }
+        for (std::uint32_t index = 0; index < nodeCount; ++index) {
+            if (!scheduled[index]) {
+                order.push_back(index);
+                ++plan.unorderedNodes;
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> stepOf(nodeCount, 0);
+    for (std::uint32_t step = 0; step < nodeCount; ++step) {
+        stepOf[order[step]] = step;
+    }
+
+    const auto isAvailable = [&](std::uint32_t value, std::uint32_t consumer) {
+        return value < hardwareInputs || stepOf[producer[value]] < stepOf[consumer];
+    };
+
+    // Step-level dependency graph, in step numbering, for schedulers that run steps concurrently.
+    std::vector<std::vector<std::uint32_t>> stepDependencies(nodeCount);
+    for (std::uint32_t step = 0; step < nodeCount; ++step) {
+        const auto index = order[step];
+        auto& dependencies = stepDependencies[step];
+        for (std::uint32_t channel = 0; channel < channels[index]; ++channel) {
+            for (const auto& source : sources[inputSlot(index, channel)]) {
+                if (source.value >= hardwareInputs && isAvailable(source.value, index)) {
+                    dependencies.push_back(stepOf[producer[source.value]]);
+                }
+            }
+        }
+        std::sort(dependencies.begin(), dependencies.end());
+        dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+    }
+
+    const bool concurrent = options.concurrentSteps;
+    plan.concurrent = concurrent;
+    std::vector<StepSet> ancestors;
+    std::vector<StepSet> bufferUsers;
+    if (concurrent) {
+        ancestors.assign(nodeCount, StepSet(nodeCount));
+        for (std::uint32_t step = 0; step < nodeCount; ++step) {
+            for (const auto dependency : stepDependencies[step]) {
+                ancestors[step].merge(ancestors[dependency]);
+                ancestors[step].insert(dependency);
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> remainingUses(valueCount, 0);
+    for (std::uint32_t index = 0; index < nodeCount; ++index) {
+        for (std::uint32_t channel = 0; channel < channels[index]; ++channel) {
+            for (const auto& source : sources[inputSlot(index, channel)]) {
+                if (isAvailable(source.value, index)) {
+                    ++remainingUses[source.value];
+                }
+            }
+        }
+    }
+
+    BufferAllocator allocator;
+    std::vector<std::uint32_t> bufferOf(valueCount, kNoBuffer);
+
+    // A slot may only be overwritten by a step that every earlier user of the slot is guaranteed to precede.
+    const auto isOrderedBefore = [&](std::uint32_t buffer, std::uint32_t step) {
+        return !concurrent || buffer >= bufferUsers.size() || bufferUsers[buffer].isSubsetOf(ancestors[step], step);
+    };
+    const auto touch = [&](std::uint32_t buffer, std::uint32_t step) {
+        if (!concurrent) {
+            return;
+        }
+        if (buffer >= bufferUsers.size()) {
+            bufferUsers.resize(buffer + 1, StepSet(nodeCount));
+        }
+        bufferUsers[buffer].insert(step);
+    };
+    const auto allocateFor = [&](std::uint32_t step) {
+        const auto buffer = allocator.allocate([&](std::uint32_t candidate) { return isOrderedBefore(candidate, step); });
+        if (concurrent && buffer < bufferUsers.size()) {
+            bufferUsers[buffer].clear();
+        }
+        return buffer;
+    };
+
+    plan.hardwareInputBuffers.assign(hardwareInputs, kNoBuffer);
+    for (std::uint32_t channel = 0; channel < hardwareInputs; ++channel) {
+        if (remainingUses[channel] > 0) {
+            const auto buffer = allocator.allocate([](std::uint32_t) { return true; });
+            allocator.retain(buffer);
+            bufferOf[channel] = buffer;
+            plan.hardwareInputBuffers[channel] = buffer;
+        }
+    }
+
+    std::vector<bool> hardwareWritten(options.hardwareOutputs, false);
+    std::vector<SignalSource> available;
+    std::vector<std::uint32_t> consumed;
+    std::vector<std::uint32_t> claimed;
+
+    plan.steps.reserve(nodeCount);
+    for (std::uint32_t stepIndex = 0; stepIndex < nodeCount; ++stepIndex) {
+        const auto index = order[stepIndex];
+        Step step;
+        step.node = index;
+        step.dependencies = static_cast<std::uint32_t>(stepDependencies[stepIndex].size());
+        step.firstChannel = static_cast<std::uint32_t>(plan.channelBuffers.size());
+        step.numChannels = channels[index];
+        step.firstMix = static_cast<std::uint32_t>(plan.mixes.size());
+        step.firstOutput = static_cast<std::uint32_t>(plan.outputs.size());
+
+        const bool passThrough = options.isPassThrough && options.isPassThrough(nodes[index]);
+        consumed.clear();
+        claimed.clear();
+
+        const auto isClaimed = [&](std::uint32_t buffer) {
+            return std::find(claimed.begin(), claimed.end(), buffer) != claimed.end();
+        };
+        // A source may be processed in place only if nothing else will read it or shares its slot.
+        const auto isExclusive = [&](std::uint32_t value) {
+            const auto buffer = bufferOf[value];
+            return remainingUses[value] == 1 && allocator.references(buffer) == 1 && !isClaimed(buffer)
+                && isOrderedBefore(buffer, stepIndex);
+        };
+
+        // Inputs from more than one producer may arrive with different latency, so every input of
+        // such a step is routed through a delay line, unity channels included.
+        bool readsHardware = false;
+        for (std::uint32_t channel = 0; channel < channels[index] && !readsHardware; ++channel) {
+            const auto& slotSources = sources[inputSlot(index, channel)];
+            readsHardware = std::any_of(slotSources.begin(), slotSources.end(), [&](const auto& source) {
+                return source.value < hardwareInputs;
+            });
+        }
+        const bool compensated = stepDependencies[stepIndex].size() + (readsHardware ? 1U : 0U) > 1;
+        const auto pushInputs = [&] {
+            for (const auto& source : available) {
+                plan.mixInputs.push_back({
+                    .source = bufferOf[source.value],
+                    .gain = source.gain,
+                    .producer = source.value < hardwareInputs ? kNoStep : stepOf[producer[source.value]],
+                    .delayLine = compensated ? plan.delayLineCount++ : kNoDelayLine,
+                });
+            }
+        };
+
+        for (std::uint32_t channel = 0; channel < channels[index]; ++channel) {
+            available.clear();
+            for (const auto& source : sources[inputSlot(index, channel)]) {
+                if (isAvailable(source.value, index)) {
+                    available.push_back(source);
+                }
+            }
+
+            std::uint32_t buffer = kNoBuffer;
+            if (available.empty()) {
+                buffer = allocateFor(stepIndex);
+                plan.mixes.push_back({ MixKind::Clear, kNoBuffer, buffer });
+            } else {
+                const auto& first = available.front();
+                const bool unity = available.size() == 1 && first.gain == 1.0F;
+                if (unity && !compensated && !isClaimed(bufferOf[first.value]) && (passThrough || isExclusive(first.value))) {
+                    buffer = bufferOf[first.value];
+                    ++plan.aliasedChannels;
+                } else if (unity) {
+                    // A compensated copy goes through its delay line, so it may land back in a slot nothing else reads.
+                    buffer = compensated && isExclusive(first.value) ? bufferOf[first.value] : allocateFor(stepIndex);
+                    plan.mixes.push_back({
+                        .kind = MixKind::Copy,
+                        .source = bufferOf[first.value],
+                        .destination = buffer,
+                        .firstInput = static_cast<std::uint32_t>(plan.mixInputs.size()),
+                        .numInputs = compensated ? 1U : 0U,
+                    });
+                    if (compensated) {
+                        pushInputs();
+                    }
+                } else {
+                    // Sum in place over an input nothing else reads, or into a fresh slot.
+                    const auto target = std::find_if(available.begin(), available.end(), [&](const auto& source) {
+                        return isExclusive(source.value);
+                    });
+                    buffer = target != available.end() ? bufferOf[target->value] : allocateFor(stepIndex);
+                    plan.mixes.push_back({
+                        .kind = MixKind::Sum,
+                        .destination = buffer,
+                        .firstInput = static_cast<std::uint32_t>(plan.mixInputs.size()),
+                        .numInputs = static_cast<std::uint32_t>(available.size()),
+                    });
+                    pushInputs();
+                }
+            }
+
+            claimed.push_back(buffer);
+            plan.channelBuffers.push_back(buffer);
+            touch(buffer, stepIndex);
+            for (const auto& source : available) {
+                touch(bufferOf[source.value], stepIndex);
+                --remainingUses[source.value];
+                consumed.push_back(source.value);
+            }
+        }
+
+        for (std::uint32_t channel = 0; channel < channels[index]; ++channel) {
+            const auto buffer = plan.channelBuffers[step.firstChannel + channel];
+            bufferOf[valueBase[index] + channel] = buffer;
+            allocator.retain(buffer);
+        }
+
+        if (nodes[index].type() == GraphNodeType::Output) {
+            const auto writeHardware = [&](std::uint32_t buffer, std::uint32_t hardwareChannel) {
+                plan.outputs.push_back({ buffer, hardwareChannel, hardwareWritten[hardwareChannel] });
+                hardwareWritten[hardwareChannel] = true;
+            };
+            const auto wired = hardwareChannels(nodes[index]);
+            for (std::uint32_t channel = 0; channel < std::min(wired, options.hardwareOutputs); ++channel) {
+                writeHardware(plan.channelBuffers[step.firstChannel + channel], channel);
+            }
+            if (wired == 1) {
+                for (std::uint32_t extra = 1; extra < options.hardwareOutputs; ++extra) {
+                    writeHardware(plan.channelBuffers[step.firstChannel], extra);
+                }
+            }
+        }
+
+        for (const auto value : consumed) {
+            if (remainingUses[value] == 0 && bufferOf[value] != kNoBuffer) {
+                allocator.release(bufferOf[value]);
+                bufferOf[value] = kNoBuffer;
+            }
+        }
+        // Concurrent plans copy to hardware after every step has run, so output slots stay live until then.
+        const bool pinned = concurrent && nodes[index].type() == GraphNodeType::Output;
+        for (std::uint32_t channel = 0; channel < channels[index] && !pinned; ++channel) {
+            const auto value = valueBase[index] + channel;
+            if (remainingUses[value] == 0 && bufferOf[value] != kNoBuffer) {
+                allocator.release(bufferOf[value]);
+                bufferOf[value] = kNoBuffer;
+            }
+        }
+
+        step.numMixes = static_cast<std::uint32_t>(plan.mixes.size()) - step.firstMix;
+        step.numOutputs = static_cast<std::uint32_t>(plan.outputs.size()) - step.firstOutput;
+        plan.steps.push_back(step);
+    }
+
+    std::vector<std::vector<std::uint32_t>> stepDependents(nodeCount);
+    for (std::uint32_t step = 0; step < nodeCount; ++step) {
+        for (const auto dependency : stepDependencies[step]) {
+            stepDependents[dependency].push_back(step);
+        }
+    }
+    for (std::uint32_t step = 0; step < nodeCount; ++step) {
+        plan.steps[step].firstDependent = static_cast<std::uint32_t>(plan.dependents.size());
+        plan.steps[step].numDependents = static_cast<std::uint32_t>(stepDependents[step].size());
+        plan.dependents.insert(plan.dependents.end(), stepDependents[step].begin(), stepDependents[step].end());
+        plan.steps[step].firstUpstream = static_cast<std::uint32_t>(plan.upstream.size());
+        plan.steps[step].numUpstream = static_cast<std::uint32_t>(stepDependencies[step].size());
+        plan.upstream.insert(plan.upstream.end(), stepDependencies[step].begin(), stepDependencies[step].end());
+    }
+
+    for (std::uint32_t channel = 0; channel < options.hardwareOutputs; ++channel) {
+        if (!hardwareWritten[channel]) {
+            plan.silentHardwareOutputs.push_back(channel);
+        }
+    }
+
+    plan.bufferCount = allocator.count();
+    return plan;
+}
+
+void RenderPlan::computeCompensation(const std::uint32_t* stepLatencies,
+                                     std::uint32_t* outputLatencies,
+                                     std::uint32_t* inputDelays) const noexcept {
+    // Steps are topologically ordered, so every upstream latency is final before it is read.
+    for (std::uint32_t stepIndex = 0; stepIndex < steps.size(); ++stepIndex) {
+        const auto& step = steps[stepIndex];
+        std::uint32_t arrival = 0;
+        for (std::uint32_t index = step.firstUpstream; index < step.firstUpstream + step.numUpstream; ++index) {
+            arrival = std::max(arrival, outputLatencies[upstream[index]]);
+        }
+        for (std::uint32_t mix = step.firstMix; mix < step.firstMix + step.numMixes; ++mix) {
+            const auto& op = mixes[mix];
+            for (std::uint32_t input = op.firstInput; input < op.firstInput + op.numInputs; ++input) {
+                const auto producerStep = mixInputs[input].producer;
+                inputDelays[input] = arrival - (producerStep == kNoStep ? 0 : outputLatencies[producerStep]);
+            }
+        }
+        outputLatencies[stepIndex] = arrival + stepLatencies[stepIndex];
+    }
+}
+
+} // namespace broadcastmix::audio
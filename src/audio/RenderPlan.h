@@ -0,0 +1,104 @@
+#pragma once
+
+#include "GraphTopology.h"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace broadcastmix::audio {
+
+struct RenderPlanOptions {
+    std::uint32_t hardwareInputs { 0 };
+    std::uint32_t hardwareOutputs { 0 };
+    std::function<bool(const GraphNode&)> isPassThrough;
+    bool concurrentSteps { false };
+};
+
+// Flat, topologically sorted schedule for a GraphTopology. Every channel a step
+// touches is bound to a slot in a shared scratch pool; slots are recycled as soon
+// as the last reader of a signal has run, and pass-through stages reuse their
+// source slot instead of copying. Channels fed by several connections, or through a
+// crosspoint gain, are summed by one Sum op over all of their inputs. With concurrentSteps, slots are only recycled
+// between steps ordered by a dependency path, so independent steps may run on
+// different threads; hardware outputs are then written once all steps are done.
+// Every input of a step fed by more than one producer owns a compensation delay line, so
+// parallel paths with different processing latency can be realigned where they meet.
+struct RenderPlan {
+    static constexpr std::uint32_t kNoBuffer = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t kNoStep = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::uint32_t kNoDelayLine = std::numeric_limits<std::uint32_t>::max();
+
+    enum class MixKind : std::uint8_t {
+        Clear,
+        Copy,
+        Sum
+    };
+
+    struct MixInput {
+        std::uint32_t source { kNoBuffer };
+        float gain { 1.0F };
+        std::uint32_t producer { kNoStep };
+        std::uint32_t delayLine { kNoDelayLine };
+    };
+
+    // Sum reads mixInputs[firstInput, firstInput + numInputs), which may include the destination.
+    // A Copy on a compensated step reads its source through the single input at firstInput.
+    struct MixOp {
+        MixKind kind { MixKind::Clear };
+        std::uint32_t source { kNoBuffer };
+        std::uint32_t destination { kNoBuffer };
+        std::uint32_t firstInput { 0 };
+        std::uint32_t numInputs { 0 };
+    };
+
+    struct OutputOp {
+        std::uint32_t source { kNoBuffer };
+        std::uint32_t hardwareChannel { 0 };
+        bool accumulate { false };
+    };
+
+    struct Step {
+        std::uint32_t node { 0 };
+        std::uint32_t firstChannel { 0 };
+        std::uint32_t numChannels { 0 };
+        std::uint32_t firstMix { 0 };
+        std::uint32_t numMixes { 0 };
+        std::uint32_t firstOutput { 0 };
+        std::uint32_t numOutputs { 0 };
+        std::uint32_t dependencies { 0 };
+        std::uint32_t firstDependent { 0 };
+        std::uint32_t numDependents { 0 };
+        std::uint32_t firstUpstream { 0 };
+        std::uint32_t numUpstream { 0 };
+    };
+
+    std::vector<Step> steps;
+    std::vector<std::uint32_t> channelBuffers;
+    std::vector<MixOp> mixes;
+    std::vector<MixInput> mixInputs;
+    std::vector<OutputOp> outputs;
+    std::vector<std::uint32_t> dependents;
+    std::vector<std::uint32_t> upstream;
+    std::vector<std::uint32_t> hardwareInputBuffers;
+    std::vector<std::uint32_t> silentHardwareOutputs;
+    std::uint32_t bufferCount { 0 };
+    std::uint32_t aliasedChannels { 0 };
+    std::uint32_t totalChannels { 0 };
+    std::uint32_t unorderedNodes { 0 };
+    std::uint32_t delayLineCount { 0 };
+    bool concurrent { false };
+
+    [[nodiscard]] static RenderPlan compile(const GraphTopology& topology, const RenderPlanOptions& options);
+
+    // Given each step's own latency, fills the latency at each step's output and the delay
+    // every mix input needs to line up with the latest signal arriving at its step. Walks
+    // the plan once in step order without allocating, so it can run on the audio thread.
+    void computeCompensation(const std::uint32_t* stepLatencies,
+                             std::uint32_t* outputLatencies,
+                             std::uint32_t* inputDelays) const noexcept;
+    [[nodiscard]] static std::uint32_t processingChannelCount(const GraphNode& node) noexcept;
+};
+
+} // namespace broadcastmix::audio
@@ -0,0 +1,159 @@
+#include "RoutingMatrix.h"
+
+#include "dsp/MixKernel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace broadcastmix::audio {
+
+namespace {
+std::vector<HardwarePatch> diagonalPatches() {
+    std::vector<HardwarePatch> diagonal;
+    diagonal.reserve(RoutingMatrix::kMaxChannels);
+    for (std::uint32_t channel = 0; channel < RoutingMatrix::kMaxChannels; ++channel) {
+        diagonal.push_back({ .source = channel, .destination = channel });
+    }
+    return diagonal;
+}
+} // namespace
+
+RoutingMatrix::RoutingMatrix() {
+    for (auto& side : sides_) {
+        for (auto& table : side.tables) {
+            table.sources.reserve(kMaxPatches);
+            table.gains.reserve(kMaxPatches);
+        }
+        side.published = diagonalPatches();
+    }
+}
+
+bool RoutingMatrix::setPatches(PatchSide side, const std::vector<HardwarePatch>& patches) {
+    const bool valid = std::all_of(patches.begin(), patches.end(), [](const HardwarePatch& patch) {
+        return patch.source < kMaxChannels && patch.destination < kMaxChannels && std::isfinite(patch.gain);
+    });
+    if (!valid) {
+        return false;
+    }
+
+    auto sorted = patches;
+    // Stable, so the last of any duplicated crosspoints ends up last in its run.
+    std::stable_sort(sorted.begin(), sorted.end(), [](const HardwarePatch& lhs, const HardwarePatch& rhs) {
+        return lhs.destination != rhs.destination ? lhs.destination < rhs.destination : lhs.source < rhs.source;
+    });
+    std::vector<HardwarePatch> unique;
+    unique.reserve(sorted.size());
+    for (const auto& patch : sorted) {
+        if (!unique.empty() && unique.back().destination == patch.destination && unique.back().source == patch.source) {
+            unique.back().gain = patch.gain;
+        } else {
+            unique.push_back(patch);
+        }
+    }
+
+    std::lock_guard lock(mutex_);
+    publish(sideFor(side), unique, false);
+    return true;
+}
+
+void RoutingMatrix::resetPatches(PatchSide side) {
+    const auto diagonal = diagonalPatches();
+    std::lock_guard lock(mutex_);
+    publish(sideFor(side), diagonal, true);
+}
+
+std::vector<HardwarePatch> RoutingMatrix::patches(PatchSide side) const {
+    std::lock_guard lock(mutex_);
+    return sideFor(side).published;
+}
+
+void RoutingMatrix::publish(Side& side, const std::vector<HardwarePatch>& patches, bool direct) {
+    auto& table = side.tables[side.back];
+    table.direct = direct;
+    table.sources.clear();
+    table.gains.clear();
+    std::size_t next = 0;
+    for (std::size_t destination = 0; destination < kMaxChannels; ++destination) {
+        table.first[destination] = static_cast<std::uint16_t>(table.sources.size());
+        for (; next < patches.size() && patches[next].destination == destination; ++next) {
+            table.sources.push_back(static_cast<std::uint8_t>(patches[next].source));
+            table.gains.push_back(patches[next].gain);
+        }
+    }
+    table.first[kMaxChannels] = static_cast<std::uint16_t>(table.sources.size());
+
+    side.published = patches;
+    side.back = side.middle.exchange(side.back | kFresh, std::memory_order_acq_rel) & ~kFresh;
+}
+
+void RoutingMatrix::update() noexcept {
+    for (auto& side : sides_) {
+        if ((side.middle.load(std::memory_order_acquire) & kFresh) != 0) {
+            side.front = side.middle.exchange(side.front, std::memory_order_acq_rel) & ~kFresh;
+        }
+    }
+}
+
+void RoutingMatrix::apply(PatchSide side,
+                          const float* const* sources,
+                          std::size_t numSources,
+                          float* const* destinations,
+                          std::size_t numDestinations,
+                          std::size_t numSamples) const noexcept {
+    const auto& entry = sideFor(side);
+    const auto& table = entry.tables[entry.front];
+
+    if (table.direct) {
+        for (std::size_t channel = 0; channel < numDestinations; ++channel) {
+            if (destinations[channel] == nullptr) {
+                continue;
+            }
+            if (channel < numSources && sources[channel] != nullptr) {
+                std::memcpy(destinations[channel], sources[channel], numSamples * sizeof(float));
+            } else {
+                std::fill(destinations[channel], destinations[channel] + numSamples, 0.0F);
+            }
+        }
+        return;
+    }
+
+    std::array<const float*, kMaxChannels> inputs {};
+    std::array<float, kMaxChannels> gains {};
+    for (std::size_t destination = 0; destination < numDestinations; ++destination) {
+        auto* samples = destinations[destination];
+        if (samples == nullptr) {
+            continue;
+        }
+
+        std::size_t count = 0;
+        if (destination < kMaxChannels) {
+            for (auto index = table.first[destination]; index < table.first[destination + 1]; ++index) {
+                const auto source = table.sources[index];
+                if (source < numSources && sources[source] != nullptr && table.gains[index] != 0.0F) {
+                    inputs[count] = sources[source];
+                    gains[count] = table.gains[index];
+                    ++count;
+                }
+            }
+        }
+
+        if (count == 0) {
+            std::fill(samples, samples + numSamples, 0.0F);
+        } else if (count == 1 && gains[0] == 1.0F) {
+            std::memcpy(samples, inputs[0], numSamples * sizeof(float));
+        } else {
+            dsp::sumInto(samples, inputs.data(), gains.data(), count, numSamples);
+        }
+    }
+}
+
+RoutingMatrix::Side& RoutingMatrix::sideFor(PatchSide side) noexcept {
+    return sides_[side == PatchSide::Input ? 0 : 1];
+}
+
+const RoutingMatrix::Side& RoutingMatrix::sideFor(PatchSide side) const noexcept {
+    return sides_[side == PatchSide::Input ? 0 : 1];
+}
+
+} // namespace broadcastmix::audio
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "AudioEngine.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace broadcastmix::audio {
+
+// Sparse patch between device channels and the graph's I/O channels, applied in the
+// device callback. Each side holds a list of crosspoints sorted by destination, so a
+// destination costs one pass of dsp::sumInto over its sources (a plain copy for a single
+// unity patch) and unpatched destinations are cleared. Repatching only rewrites a table:
+// the control thread fills a spare one and publishes it through a triple buffer, and the
+// audio thread picks the newest up at the start of a callback without locking or
+// allocating. The default one-to-one patch also passes channels beyond kMaxChannels.
+class RoutingMatrix {
+public:
+    static constexpr std::size_t kMaxChannels = 64;
+    static constexpr std::size_t kMaxPatches = kMaxChannels * kMaxChannels;
+
+    RoutingMatrix();
+
+    RoutingMatrix(const RoutingMatrix&) = delete;
+    RoutingMatrix& operator=(const RoutingMatrix&) = delete;
+
+    // Rejects the whole list if any channel is out of range or any gain is not finite.
+    // A crosspoint listed twice keeps its last gain.
+    bool setPatches(PatchSide side, const std::vector<HardwarePatch>& patches);
+    void resetPatches(PatchSide side);
+    [[nodiscard]] std::vector<HardwarePatch> patches(PatchSide side) const;
+
+    // Audio thread: adopts any newly published tables; call once per callback.
+    void update() noexcept;
+    void apply(PatchSide side,
+               const float* const* sources,
+               std::size_t numSources,
+               float* const* destinations,
+               std::size_t numDestinations,
+               std::size_t numSamples) const noexcept;
+
+private:
+    static constexpr std::uint32_t kFresh = 4;
+
+    struct Table {
+        bool direct { true };
+        // Patches for destination d sit in [first[d], first[d + 1]).
+        std::array<std::uint16_t, kMaxChannels + 1> first {};
+        std::vector<std::uint8_t> sources;
+        std::vector<float> gains;
+    };
+
+    struct Side {
+        std::array<Table, 3> tables;
+        std::atomic<std::uint32_t> middle { 1 };
+        std::uint32_t back { 2 };
+        std::uint32_t front { 0 };
+        std::vector<HardwarePatch> published;
+    };
+
+    [[nodiscard]] Side& sideFor(PatchSide side) noexcept;
+    [[nodiscard]] const Side& sideFor(PatchSide side) const noexcept;
+    void publish(Side& side, const std::vector<HardwarePatch>& patches, bool direct);
+
+    mutable std::mutex mutex_;
+    std::array<Side, 2> sides_;
+};
+
+} // namespace broadcastmix::audio
@@ -0,0 +1,166 @@
+#include "SnapshotRecaller.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace broadcastmix::audio {
+
+namespace {
+constexpr float kSilenceDecibels = -100.0F;
+
+// Gains glide in decibels so a fade sounds even across its whole length.
+bool glidesInDecibels(NodeParameter parameter) noexcept {
+    return parameter == NodeParameter::Gain;
+}
+
+// Switches have no in-between; they take their new state as the glide starts.
+bool isSwitch(NodeParameter parameter) noexcept {
+    return parameter == NodeParameter::Mute || parameter == NodeParameter::Signal;
+}
+
+float toDecibels(float gain) noexcept {
+    return gain > 0.0F ? std::max(kSilenceDecibels, 20.0F * std::log10(gain)) : kSilenceDecibels;
+}
+
+float fromDecibels(float decibels) noexcept {
+    return decibels <= kSilenceDecibels ? 0.0F : std::pow(10.0F, decibels / 20.0F);
+}
+} // namespace
+
+SnapshotRecaller::SnapshotRecaller() = default;
+SnapshotRecaller::~SnapshotRecaller() = default;
+
+void SnapshotRecaller::submit(const std::vector<Target>& targets, double glideSeconds) {
+    collectGarbage();
+
+    Recall* recall = nullptr;
+    if (!spare_.empty()) {
+        recall = spare_.back();
+        spare_.pop_back();
+    } else {
+        owned_.push_back(std::make_unique<Recall>());
+        recall = owned_.back().get();
+    }
+
+    recall->leases.clear();
+    recall->glides.clear();
+    const auto count = std::min(targets.size(), kMaxTargets);
+    for (std::size_t index = 0; index < count; ++index) {
+        const auto& target = targets[index];
+        if (!target.parameters) {
+            continue;
+        }
+        recall->leases.push_back(target.parameters);
+        recall->glides.push_back(Glide {
+            .slot = target.parameters.get(),
+            .parameter = target.parameter,
+            .target = target.value,
+            .decibels = glidesInDecibels(target.parameter),
+            .isSwitch = isSwitch(target.parameter),
+        });
+    }
+    recall->glideSeconds = std::max(0.0, glideSeconds);
+
+    // A recall that was still pending was never started and can be reused straight away.
+    if (auto* superseded = pending_.exchange(recall, std::memory_order_acq_rel)) {
+        spare_.push_back(superseded);
+    }
+}
+
+void SnapshotRecaller::collectGarbage() {
+    for (auto& slot : retired_) {
+        if (auto* recall = slot.exchange(nullptr, std::memory_order_acq_rel)) {
+            spare_.push_back(recall);
+        }
+    }
+}
+
+bool SnapshotRecaller::isGliding() const noexcept {
+    return pending_.load() != nullptr || gliding_.load();
+}
+
+double SnapshotRecaller::glideSeconds(SnapshotGlide glide) noexcept {
+    switch (glide) {
+    case SnapshotGlide::Short:
+        return 1.0;
+    case SnapshotGlide::Medium:
+        return 3.0;
+    case SnapshotGlide::Long:
+        return 6.0;
+    }
+    return 3.0;
+}
+
+void SnapshotRecaller::advance(std::size_t numSamples, double sampleRate) noexcept {
+    if (active_ != nullptr && finished_ && hasRetireSlot()) {
+        retire(active_);
+        active_ = nullptr;
+    }
+
+    if (pending_.load(std::memory_order_acquire) != nullptr && (active_ == nullptr || hasRetireSlot())) {
+        gliding_.store(true);
+        auto* next = pending_.exchange(nullptr, std::memory_order_acq_rel);
+        if (active_ != nullptr) {
+            retire(active_);
+        }
+        active_ = next;
+        begin(*active_);
+    }
+
+    if (active_ == nullptr || finished_) {
+        return;
+    }
+
+    elapsedSamples_ += static_cast<double>(numSamples);
+    const auto glideSamples = active_->glideSeconds * sampleRate;
+    const auto position = glideSamples > 0.0 ? std::min(1.0, elapsedSamples_ / glideSamples) : 1.0;
+    finished_ = position >= 1.0;
+    for (const auto& glide : active_->glides) {
+        if (glide.slot->recallSafe.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        auto value = glide.target;
+        if (!finished_ && !glide.isSwitch) {
+            const auto level = glide.start + (glide.end - glide.start) * static_cast<float>(position);
+            value = glide.decibels ? fromDecibels(level) : level;
+        }
+        glide.slot->store(glide.parameter, value);
+    }
+
+    if (finished_) {
+        gliding_.store(false);
+        if (hasRetireSlot()) {
+            retire(active_);
+            active_ = nullptr;
+        }
+    }
+}
+
+void SnapshotRecaller::begin(Recall& recall) noexcept {
+    // Glides start from wherever each slot is now, so a recall that interrupts another
+    // carries on from the interrupted values without a jump.
+    elapsedSamples_ = 0.0;
+    finished_ = false;
+    for (auto& glide : recall.glides) {
+        const auto current = glide.slot->load(glide.parameter);
+        glide.start = glide.decibels ? toDecibels(current) : current;
+        glide.end = glide.decibels ? toDecibels(glide.target) : glide.target;
+    }
+}
+
+bool SnapshotRecaller::hasRetireSlot() const noexcept {
+    return std::any_of(retired_.begin(), retired_.end(), [](const auto& slot) {
+        return slot.load(std::memory_order_acquire) == nullptr;
+    });
+}
+
+void SnapshotRecaller::retire(Recall* recall) noexcept {
+    for (auto& slot : retired_) {
+        Recall* expected = nullptr;
+        if (slot.compare_exchange_strong(expected, recall, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+}
+
+} // namespace broadcastmix::audio
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "AudioEngine.h"
+#include "ParameterStore.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace broadcastmix::audio {
+
+// Glides parameter slots to a recalled snapshot from the audio thread. The control thread
+// resolves the snapshot into a recall it owns and hands it over through pending_; each
+// block then moves every targeted slot one step along its glide, so the cost per block is
+// one store per recalled parameter with no allocation or locking. Recalls come back
+// through retire slots and are reused by later submissions.
+class SnapshotRecaller {
+public:
+    static constexpr std::size_t kRetireSlots = 4;
+    static constexpr std::size_t kMaxTargets = 8192;
+
+    struct Target {
+        ParameterStore::ParametersPtr parameters;
+        NodeParameter parameter { NodeParameter::Gain };
+        float value { 0.0F };
+    };
+
+    SnapshotRecaller();
+    ~SnapshotRecaller();
+
+    SnapshotRecaller(const SnapshotRecaller&) = delete;
+    SnapshotRecaller& operator=(const SnapshotRecaller&) = delete;
+
+    void submit(const std::vector<Target>& targets, double glideSeconds);
+    void collectGarbage();
+    [[nodiscard]] bool isGliding() const noexcept;
+
+    void advance(std::size_t numSamples, double sampleRate) noexcept;
+
+    [[nodiscard]] static double glideSeconds(SnapshotGlide glide) noexcept;
+
+private:
+    struct Glide {
+        ParameterStore::NodeParameters* slot { nullptr };
+        NodeParameter parameter { NodeParameter::Gain };
+        float target { 0.0F };
+        float start { 0.0F };
+        float end { 0.0F };
+        bool decibels { false };
+        bool isSwitch { false };
+    };
+
+    struct Recall {
+        std::vector<ParameterStore::ParametersPtr> leases;
+        std::vector<Glide> glides;
+        double glideSeconds { 0.0 };
+    };
+
+    void begin(Recall& recall) noexcept;
+    [[nodiscard]] bool hasRetireSlot() const noexcept;
+    void retire(Recall* recall) noexcept;
+
+    std::vector<std::unique_ptr<Recall>> owned_;
+    std::vector<Recall*> spare_;
+
+    std::atomic<Recall*> pending_ { nullptr };
+    std::array<std::atomic<Recall*>, kRetireSlots> retired_ {};
+    std::atomic<bool> gliding_ { false };
+
+    Recall* active_ { nullptr };
+    double elapsedSamples_ { 0.0 };
+    bool finished_ { false };
+};
+
+} // namespace broadcastmix::audio
@@ -0,0 +1,297 @@
+#include "VirtualAudioDevice.h"
+
+#if BROADCASTMIX_HAS_JUCE
+
+#include "../core/Logging.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace broadcastmix::audio {
+
+namespace {
+constexpr int kOutputBitDepth = 32;
+
+juce::StringArray channelNames(const char* prefix, int count) {
+    juce::StringArray names;
+    for (int channel = 0; channel < count; ++channel) {
+        names.add(juce::String(prefix) + " " + juce::String(channel + 1));
+    }
+    return names;
+}
+} // namespace
+
+VirtualAudioDevice::VirtualAudioDevice(VirtualDeviceSettings settings, int numInputs, int numOutputs)
+    : juce::AudioIODevice(kDeviceName, kTypeName)
+    , settings_(std::move(settings))
+    , numInputs_(std::max(0, numInputs))
+    , numOutputs_(std::max(1, numOutputs)) {
+    formatManager_.registerBasicFormats();
+}
+
+VirtualAudioDevice::~VirtualAudioDevice() {
+    close();
+}
+
+juce::StringArray VirtualAudioDevice::getOutputChannelNames() {
+    return channelNames("Output", numOutputs_);
+}
+
+juce::StringArray VirtualAudioDevice::getInputChannelNames() {
+    return channelNames("Input", numInputs_);
+}
+
+juce::Array<double> VirtualAudioDevice::getAvailableSampleRates() {
+    return { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+}
+
+juce::Array<int> VirtualAudioDevice::getAvailableBufferSizes() {
+    return { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+}
+
+int VirtualAudioDevice::getDefaultBufferSize() {
+    return 512;
+}
+
+juce::String VirtualAudioDevice::open(const juce::BigInteger& inputChannels,
+                                      const juce::BigInteger& outputChannels,
+                                      double sampleRate,
+                                      int bufferSizeSamples) {
+    close();
+    lastError_.clear();
+
+    activeInputs_ = inputChannels;
+    activeInputs_.setRange(numInputs_, std::max(0, activeInputs_.getHighestBit() + 1 - numInputs_), false);
+    activeOutputs_ = outputChannels;
+    activeOutputs_.setRange(numOutputs_, std::max(0, activeOutputs_.getHighestBit() + 1 - numOutputs_), false);
+    sampleRate_ = sampleRate > 0.0 ? sampleRate : 48000.0;
+    blockSize_ = bufferSizeSamples > 0 ? bufferSizeSamples : getDefaultBufferSize();
+
+    length_ = settings_.lengthInSamples;
+    if (!settings_.inputFile.empty()) {
+        reader_.reset(formatManager_.createReaderFor(juce::File(settings_.inputFile)));
+        if (reader_ == nullptr) {
+            lastError_ = "Unable to open input file " + juce::String(settings_.inputFile);
+            return lastError_;
+        }
+        if (length_ == 0) {
+            length_ = static_cast<std::uint64_t>(std::max<juce::int64>(0, reader_->lengthInSamples));
+        }
+        // Files are played sample for sample; a rate mismatch changes pitch and timing.
+        if (reader_->sampleRate != sampleRate_) {
+            core::log(core::LogCategory::Audio,
+                      "Virtual device input {} is {} Hz, device runs at {} Hz",
+                      settings_.inputFile,
+                      reader_->sampleRate,
+                      sampleRate_);
+        }
+    }
+
+    const auto numActiveOutputs = std::max(1, activeOutputs_.countNumberOfSetBits());
+    if (!settings_.outputFile.empty()) {
+        const juce::File outputFile(settings_.outputFile);
+        outputFile.getParentDirectory().createDirectory();
+        outputFile.deleteFile();
+        if (auto stream = outputFile.createOutputStream()) {
+            juce::WavAudioFormat wav;
+            writer_.reset(wav.createWriterFor(stream.get(),
+                                              sampleRate_,
+                                              static_cast<unsigned int>(numActiveOutputs),
+                                              kOutputBitDepth,
+                                              {},
+                                              0));
+            if (writer_ != nullptr) {
+                stream.release();
+            }
+        }
+        if (writer_ == nullptr) {
+            reader_.reset();
+            lastError_ = "Unable to create output file " + juce::String(settings_.outputFile);
+            return lastError_;
+        }
+    }
+
+    inputs_.setSize(std::max(1, activeInputs_.countNumberOfSetBits()), blockSize_, false, true, false);
+    outputs_.setSize(numActiveOutputs, blockSize_, false, true, false);
+    position_ = 0;
+    finished_.store(false);
+    xruns_.store(0);
+    open_ = true;
+    return {};
+}
+
+void VirtualAudioDevice::close() {
+    stop();
+    writer_.reset();
+    reader_.reset();
+    open_ = false;
+}
+
+bool VirtualAudioDevice::isOpen() {
+    return open_;
+}
+
+void VirtualAudioDevice::start(juce::AudioIODeviceCallback* callback) {
+    if (!open_ || callback == nullptr || running_.load()) {
+        return;
+    }
+
+    callback_ = callback;
+    callback_->audioDeviceAboutToStart(this);
+    running_.store(true);
+    thread_ = std::thread([this] { run(); });
+}
+
+void VirtualAudioDevice::stop() {
+    running_.store(false);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (callback_ != nullptr) {
+        callback_->audioDeviceStopped();
+        callback_ = nullptr;
+    }
+}
+
+bool VirtualAudioDevice::isPlaying() {
+    return running_.load() && !finished_.load();
+}
+
+juce::String VirtualAudioDevice::getLastError() {
+    return lastError_;
+}
+
+int VirtualAudioDevice::getCurrentBufferSizeSamples() {
+    return blockSize_;
+}
+
+double VirtualAudioDevice::getCurrentSampleRate() {
+    return sampleRate_;
+}
+
+int VirtualAudioDevice::getCurrentBitDepth() {
+    return kOutputBitDepth;
+}
+
+juce::BigInteger VirtualAudioDevice::getActiveOutputChannels() const {
+    return activeOutputs_;
+}
+
+juce::BigInteger VirtualAudioDevice::getActiveInputChannels() const {
+    return activeInputs_;
+}
+
+int VirtualAudioDevice::getOutputLatencyInSamples() {
+    return 0;
+}
+
+int VirtualAudioDevice::getInputLatencyInSamples() {
+    return 0;
+}
+
+int VirtualAudioDevice::getXRunCount() const noexcept {
+    return xruns_.load(std::memory_order_relaxed);
+}
+
+bool VirtualAudioDevice::isFinished() const noexcept {
+    return finished_.load();
+}
+
+void VirtualAudioDevice::run() {
+    using Clock = std::chrono::steady_clock;
+    const auto blockDuration = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(blockSize_) / sampleRate_));
+    const auto startTime = Clock::now();
+    auto deadline = startTime;
+    const auto numInputs = activeInputs_.countNumberOfSetBits();
+    const auto numOutputs = outputs_.getNumChannels();
+
+    while (running_.load(std::memory_order_relaxed) && (length_ == 0 || position_ < length_)) {
+        const auto remaining = length_ == 0 ? static_cast<std::uint64_t>(blockSize_) : length_ - position_;
+        const auto numSamples = static_cast<int>(std::min<std::uint64_t>(remaining, static_cast<std::uint64_t>(blockSize_)));
+
+        // Shrink within the capacity allocated in open() so the reader fills exactly this block.
+        inputs_.setSize(inputs_.getNumChannels(), numSamples, false, false, true);
+        inputs_.clear();
+        if (reader_ != nullptr && numInputs > 0) {
+            reader_->read(&inputs_, 0, numSamples, static_cast<juce::int64>(position_), true, true);
+            for (int channel = static_cast<int>(reader_->numChannels); channel < numInputs; ++channel) {
+                inputs_.clear(channel, 0, numSamples);
+            }
+        }
+
+        callback_->audioDeviceIOCallbackWithContext(inputs_.getArrayOfReadPointers(),
+                                                    numInputs,
+                                                    outputs_.getArrayOfWritePointers(),
+                                                    numOutputs,
+                                                    numSamples,
+                                                    {});
+
+        if (writer_ != nullptr) {
+            writer_->writeFromFloatArrays(outputs_.getArrayOfReadPointers(), numOutputs, numSamples);
+        }
+        position_ += static_cast<std::uint64_t>(numSamples);
+
+        if (settings_.realtimeClock) {
+            deadline += blockDuration;
+            const auto now = Clock::now();
+            if (now > deadline) {
+                // Restart the clock from here instead of bursting through catch-up blocks.
+                xruns_.fetch_add(1, std::memory_order_relaxed);
+                deadline = now;
+            } else {
+                std::this_thread::sleep_until(deadline);
+            }
+        }
+    }
+
+    if (length_ != 0 && position_ >= length_) {
+        writer_.reset();
+        const auto elapsed = std::chrono::duration<double>(Clock::now() - startTime).count();
+        const auto audioSeconds = static_cast<double>(position_) / sampleRate_;
+        core::log(core::LogCategory::Audio,
+                  "Virtual device finished: {} samples in {:.2f}s ({:.2f}x realtime, {} xruns)",
+                  position_,
+                  elapsed,
+                  elapsed > 0.0 ? audioSeconds / elapsed : 0.0,
+                  xruns_.load());
+        finished_.store(true);
+    }
+}
+
+VirtualAudioDeviceType::VirtualAudioDeviceType(VirtualDeviceSettings settings, int numInputs, int numOutputs)
+    : juce::AudioIODeviceType(VirtualAudioDevice::kTypeName)
+    , settings_(std::move(settings))
+    , numInputs_(numInputs)
+    , numOutputs_(numOutputs) {}
+
+void VirtualAudioDeviceType::scanForDevices() {}
+
+juce::StringArray VirtualAudioDeviceType::getDeviceNames(bool) const {
+    return { VirtualAudioDevice::kDeviceName };
+}
+
+int VirtualAudioDeviceType::getDefaultDeviceIndex(bool) const {
+    return 0;
+}
+
+int VirtualAudioDeviceType::getIndexOfDevice(juce::AudioIODevice* device, bool) const {
+    return dynamic_cast<VirtualAudioDevice*>(device) != nullptr ? 0 : -1;
+}
+
+bool VirtualAudioDeviceType::hasSeparateInputsAndOutputs() const {
+    return false;
+}
+
+juce::AudioIODevice* VirtualAudioDeviceType::createDevice(const juce::String& outputDeviceName, const juce::String& inputDeviceName) {
+    const auto name = outputDeviceName.isNotEmpty() ? outputDeviceName : inputDeviceName;
+    if (name.isNotEmpty() && name != VirtualAudioDevice::kDeviceName) {
+        return nullptr;
+    }
+    return new VirtualAudioDevice(settings_, numInputs_, numOutputs_);
+}
+
+} // namespace broadcastmix::audio
+
+#endif // BROADCASTMIX_HAS_JUCE
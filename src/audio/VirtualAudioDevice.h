@@ -0,0 +1,106 @@
+#pragma once
+
+#include "AudioEngine.h"
+
+#if BROADCASTMIX_HAS_JUCE
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace broadcastmix::audio {
+
+// File-backed stand-in for a sound card, for machines without one. A thread of its own
+// plays the part of the driver: it reads each block of input from the WAV, runs the
+// callback and writes the block to the output WAV. File I/O happens between callbacks,
+// never inside one. On the simulated clock each block waits for its deadline and a
+// block that finishes past the following one counts as an xrun; flat out, blocks run
+// back to back, so the same input always produces the same output.
+class VirtualAudioDevice : public juce::AudioIODevice {
+public:
+    static constexpr const char* kTypeName = "Virtual";
+    static constexpr const char* kDeviceName = "Virtual File Device";
+
+    VirtualAudioDevice(VirtualDeviceSettings settings, int numInputs, int numOutputs);
+    ~VirtualAudioDevice() override;
+
+    juce::StringArray getOutputChannelNames() override;
+    juce::StringArray getInputChannelNames() override;
+    juce::Array<double> getAvailableSampleRates() override;
+    juce::Array<int> getAvailableBufferSizes() override;
+    int getDefaultBufferSize() override;
+
+    juce::String open(const juce::BigInteger& inputChannels,
+                      const juce::BigInteger& outputChannels,
+                      double sampleRate,
+                      int bufferSizeSamples) override;
+    void close() override;
+    bool isOpen() override;
+    void start(juce::AudioIODeviceCallback* callback) override;
+    void stop() override;
+    bool isPlaying() override;
+    juce::String getLastError() override;
+
+    int getCurrentBufferSizeSamples() override;
+    double getCurrentSampleRate() override;
+    int getCurrentBitDepth() override;
+    juce::BigInteger getActiveOutputChannels() const override;
+    juce::BigInteger getActiveInputChannels() const override;
+    int getOutputLatencyInSamples() override;
+    int getInputLatencyInSamples() override;
+    int getXRunCount() const noexcept override;
+
+    // True once the configured length has been rendered and the output file closed.
+    [[nodiscard]] bool isFinished() const noexcept;
+
+private:
+    void run();
+
+    VirtualDeviceSettings settings_;
+    int numInputs_ { 0 };
+    int numOutputs_ { 0 };
+    juce::BigInteger activeInputs_;
+    juce::BigInteger activeOutputs_;
+    double sampleRate_ { 48000.0 };
+    int blockSize_ { 512 };
+    bool open_ { false };
+    juce::String lastError_;
+
+    juce::AudioFormatManager formatManager_;
+    std::unique_ptr<juce::AudioFormatReader> reader_;
+    std::unique_ptr<juce::AudioFormatWriter> writer_;
+    juce::AudioBuffer<float> inputs_;
+    juce::AudioBuffer<float> outputs_;
+    std::uint64_t length_ { 0 };
+    std::uint64_t position_ { 0 };
+
+    juce::AudioIODeviceCallback* callback_ { nullptr };
+    std::thread thread_;
+    std::atomic<bool> running_ { false };
+    std::atomic<bool> finished_ { false };
+    std::atomic<int> xruns_ { 0 };
+};
+
+class VirtualAudioDeviceType : public juce::AudioIODeviceType {
+public:
+    VirtualAudioDeviceType(VirtualDeviceSettings settings, int numInputs, int numOutputs);
+
+    void scanForDevices() override;
+    juce::StringArray getDeviceNames(bool wantInputNames) const override;
+    int getDefaultDeviceIndex(bool forInput) const override;
+    int getIndexOfDevice(juce::AudioIODevice* device, bool asInput) const override;
+    bool hasSeparateInputsAndOutputs() const override;
+    juce::AudioIODevice* createDevice(const juce::String& outputDeviceName, const juce::String& inputDeviceName) override;
+
+private:
+    VirtualDeviceSettings settings_;
+    int numInputs_ { 0 };
+    int numOutputs_ { 0 };
+};
+
+} // namespace broadcastmix::audio
+
+#endif // BROADCASTMIX_HAS_JUCE
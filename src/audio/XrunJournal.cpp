@@ -0,0 +1,152 @@
+#include "XrunJournal.h"
+
+#include "../core/Logging.h"
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace broadcastmix::audio {
+
+namespace {
+constexpr auto kDrainInterval = std::chrono::milliseconds(500);
+}
+
+XrunJournal::XrunJournal() = default;
+
+XrunJournal::~XrunJournal() {
+    stop();
+}
+
+bool XrunJournal::push(const XrunEvent& event) noexcept {
+    const auto write = writeIndex_.load(std::memory_order_relaxed);
+    if (write - readIndex_.load(std::memory_order_acquire) >= kCapacity) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    events_[write % kCapacity] = event;
+    writeIndex_.store(write + 1, std::memory_order_release);
+    recorded_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void XrunJournal::setLogDirectory(std::filesystem::path directory) {
+    std::scoped_lock lock(mutex_);
+    directory_ = std::move(directory);
+}
+
+void XrunJournal::start() {
+    std::scoped_lock lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    drainThread_ = std::thread([this] { run(); });
+}
+
+void XrunJournal::stop() {
+    {
+        std::scoped_lock lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    wakeUp_.notify_all();
+    drainThread_.join();
+    drain();
+}
+
+std::size_t XrunJournal::drain() {
+    // Only one consumer may pop at a time; the mutex also guards the log directory.
+    std::scoped_lock lock(mutex_);
+
+    std::vector<std::string> lines;
+    const auto write = writeIndex_.load(std::memory_order_acquire);
+    auto read = readIndex_.load(std::memory_order_relaxed);
+    for (; read != write; ++read) {
+        lines.push_back(format(events_[read % kCapacity]));
+    }
+    readIndex_.store(read, std::memory_order_release);
+
+    const auto dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reportedDrops_) {
+        lines.push_back(std::to_string(dropped - reportedDrops_) + " xrun events dropped (journal full)");
+        reportedDrops_ = dropped;
+    }
+
+    if (lines.empty()) {
+        return 0;
+    }
+
+    if (directory_.empty()) {
+        for (const auto& line : lines) {
+            core::log(core::LogCategory::Audio, "xrun: {}", line);
+        }
+        return lines.size();
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    std::ofstream stream(directory_ / kLogFileName, std::ios::app);
+    if (!stream) {
+        core::log(core::LogCategory::Audio, "Failed to open xrun log in {}", directory_.string());
+        return 0;
+    }
+    for (const auto& line : lines) {
+        stream << line << '\n';
+    }
+    return lines.size();
+}
+
+std::uint64_t XrunJournal::recordedEvents() const noexcept {
+    return recorded_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t XrunJournal::droppedEvents() const noexcept {
+    return dropped_.load(std::memory_order_relaxed);
+}
+
+std::int64_t XrunJournal::nowMicroseconds() noexcept {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string XrunJournal::format(const XrunEvent& event) {
+    const auto seconds = static_cast<std::time_t>(event.timestampMicroseconds / 1000000);
+    std::tm tm {};
+#if defined(_WIN32)
+    gmtime_s(&tm, &seconds);
+#else
+    gmtime_r(&seconds, &tm);
+#endif
+
+    std::ostringstream oss;
+    oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S") << '.' << std::setfill('0') << std::setw(6)
+        << event.timestampMicroseconds % 1000000 << "Z " << std::setfill(' ')
+        << (event.kind == XrunKind::DeadlineMiss ? "deadline-miss" : "device-xrun")
+        << std::fixed << std::setprecision(3)
+        << " callback=" << static_cast<double>(event.callbackNanoseconds) / 1.0e6 << "ms"
+        << " deadline=" << static_cast<double>(event.deadlineNanoseconds) / 1.0e6 << "ms"
+        << " topology=" << event.topologyVersion
+        << " device-xruns=" << event.deviceXruns;
+    return oss.str();
+}
+
+void XrunJournal::run() {
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            wakeUp_.wait_for(lock, kDrainInterval, [this] { return !running_; });
+            if (!running_) {
+                return;
+            }
+        }
+        drain();
+    }
+}
+
+} // namespace broadcastmix::audio
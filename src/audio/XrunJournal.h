@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace broadcastmix::audio {
+
+enum class XrunKind : std::uint8_t {
+    DeadlineMiss,
+    DeviceXrun
+};
+
+struct XrunEvent {
+    XrunKind kind { XrunKind::DeadlineMiss };
+    std::int64_t timestampMicroseconds { 0 };
+    std::uint64_t callbackNanoseconds { 0 };
+    std::uint64_t deadlineNanoseconds { 0 };
+    std::uint64_t topologyVersion { 0 };
+    std::uint32_t deviceXruns { 0 };
+};
+
+// Single-producer ring of glitch evidence. The audio thread pushes into
+// preallocated storage; a background thread appends the entries to
+// audio-xruns.log in the configured directory.
+class XrunJournal {
+public:
+    static constexpr std::size_t kCapacity = 1024;
+    static constexpr const char* kLogFileName = "audio-xruns.log";
+
+    XrunJournal();
+    ~XrunJournal();
+
+    XrunJournal(const XrunJournal&) = delete;
+    XrunJournal& operator=(const XrunJournal&) = delete;
+
+    bool push(const XrunEvent& event) noexcept;
+
+    void setLogDirectory(std::filesystem::path directory);
+    void start();
+    void stop();
+    std::size_t drain();
+
+    [[nodiscard]] std::uint64_t recordedEvents() const noexcept;
+    [[nodiscard]] std::uint64_t droppedEvents() const noexcept;
+
+    [[nodiscard]] static std::int64_t nowMicroseconds() noexcept;
+    [[nodiscard]] static std::string format(const XrunEvent& event);
+
+private:
+    void run();
+
+    std::array<XrunEvent, kCapacity> events_ {};
+    alignas(64) std::atomic<std::size_t> writeIndex_ { 0 };
+    alignas(64) std::atomic<std::size_t> readIndex_ { 0 };
+    std::atomic<std::uint64_t> recorded_ { 0 };
+    std::atomic<std::uint64_t> dropped_ { 0 };
+
+    std::mutex mutex_;
+    std::condition_variable wakeUp_;
+    std::filesystem::path directory_;
+    std::thread drainThread_;
+    bool running_ { false };
+    std::uint64_t reportedDrops_ { 0 };
+};
+
+} // namespace broadcastmix::audio
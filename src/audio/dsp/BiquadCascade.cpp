@@ -0,0 +1,302 @@
+#include "BiquadCascade.h"
+
+#include "SimdDispatch.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace broadcastmix::audio::dsp {
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr std::size_t kLanes = BiquadCascade::kLanes;
+constexpr std::size_t kMaxStages = BiquadCascade::kMaxStages;
+
+struct Prewarp {
+    double cosine;
+    double alpha;
+};
+
+Prewarp prewarp(double sampleRate, double frequency, double q) noexcept {
+    const auto rate = sampleRate > 0.0 ? sampleRate : 48000.0;
+    const auto omega = 2.0 * kPi * std::clamp(frequency, 1.0, 0.49 * rate) / rate;
+    return { std::cos(omega), std::sin(omega) / (2.0 * std::max(q, 0.1)) };
+}
+
+BiquadCoefficients normalise(double b0, double b1, double b2, double a0, double a1, double a2) noexcept {
+    return {
+        static_cast<float>(b0 / a0),
+        static_cast<float>(b1 / a0),
+        static_cast<float>(b2 / a0),
+        static_cast<float>(a1 / a0),
+        static_cast<float>(a2 / a0),
+    };
+}
+
+// Transposed direct form II, one lane of a group at a time. Used for block tails, double
+// buffers and targets without a vector kernel.
+template <typename SampleType>
+void processLane(SampleType* samples,
+                 std::size_t numSamples,
+                 const BiquadCoefficients* stages,
+                 const std::uint8_t* active,
+                 std::size_t numActive,
+                 BiquadCascade::LaneState& state,
+                 std::size_t lane) noexcept {
+    for (std::size_t stage = 0; stage < numActive; ++stage) {
+        const auto slot = active[stage];
+        const auto& c = stages[slot];
+        auto z1 = state.s1[slot][lane];
+        auto z2 = state.s2[slot][lane];
+        for (std::size_t index = 0; index < numSamples; ++index) {
+            const auto x = static_cast<float>(samples[index]);
+            const auto y = c.b0 * x + z1;
+            z1 = c.b1 * x - c.a1 * y + z2;
+            z2 = c.b2 * x - c.a2 * y;
+            samples[index] = static_cast<SampleType>(y);
+        }
+        state.s1[slot][lane] = z1;
+        state.s2[slot][lane] = z2;
+    }
+}
+
+void processGroupScalar(float* const* lanes,
+                        std::size_t numLanes,
+                        std::size_t numSamples,
+                        const BiquadCoefficients* stages,
+                        const std::uint8_t* active,
+                        std::size_t numActive,
+                        BiquadCascade::LaneState& state) noexcept {
+    for (std::size_t lane = 0; lane < numLanes; ++lane) {
+        processLane(lanes[lane], numSamples, stages, active, numActive, state, lane);
+    }
+}
+
+#if BROADCASTMIX_SIMD_SSE2
+struct Sse2 {
+    using Vector = __m128;
+    static Vector load(const float* samples) noexcept { return _mm_loadu_ps(samples); }
+    static Vector loadAligned(const float* samples) noexcept { return _mm_load_ps(samples); }
+    static void store(float* samples, Vector value) noexcept { _mm_storeu_ps(samples, value); }
+    static void storeAligned(float* samples, Vector value) noexcept { _mm_store_ps(samples, value); }
+    static Vector splat(float value) noexcept { return _mm_set1_ps(value); }
+    static Vector add(Vector a, Vector b) noexcept { return _mm_add_ps(a, b); }
+    static Vector sub(Vector a, Vector b) noexcept { return _mm_sub_ps(a, b); }
+    static Vector mul(Vector a, Vector b) noexcept { return _mm_mul_ps(a, b); }
+    static void transpose(Vector& r0, Vector& r1, Vector& r2, Vector& r3) noexcept { _MM_TRANSPOSE4_PS(r0, r1, r2, r3); }
+};
+#endif
+
+#if BROADCASTMIX_SIMD_NEON
+struct Neon {
+    using Vector = float32x4_t;
+    static Vector load(const float* samples) noexcept { return vld1q_f32(samples); }
+    static Vector loadAligned(const float* samples) noexcept { return vld1q_f32(samples); }
+    static void store(float* samples, Vector value) noexcept { vst1q_f32(samples, value); }
+    static void storeAligned(float* samples, Vector value) noexcept { vst1q_f32(samples, value); }
+    static Vector splat(float value) noexcept { return vdupq_n_f32(value); }
+    static Vector add(Vector a, Vector b) noexcept { return vaddq_f32(a, b); }
+    static Vector sub(Vector a, Vector b) noexcept { return vsubq_f32(a, b); }
+    static Vector mul(Vector a, Vector b) noexcept { return vmulq_f32(a, b); }
+    static void transpose(Vector& r0, Vector& r1, Vector& r2, Vector& r3) noexcept {
+        const auto t01 = vtrnq_f32(r0, r1);
+        const auto t23 = vtrnq_f32(r2, r3);
+        r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+};
+#endif
+
+#if BROADCASTMIX_SIMD_SSE2 || BROADCASTMIX_SIMD_NEON
+// Loads kLanes samples from each channel, transposes so every vector holds one instant
+// across the group, runs all stages over those kLanes instants and transposes back.
+template <typename Ops>
+void processGroupVector(float* const* lanes,
+                        std::size_t numLanes,
+                        std::size_t numSamples,
+                        const BiquadCoefficients* stages,
+                        const std::uint8_t* active,
+                        std::size_t numActive,
+                        BiquadCascade::LaneState& state) noexcept {
+    using Vector = typename Ops::Vector;
+    struct Stage {
+        Vector b0, b1, b2, a1, a2, z1, z2;
+    };
+
+    std::array<Stage, kMaxStages> vectors;
+    for (std::size_t stage = 0; stage < numActive; ++stage) {
+        const auto slot = active[stage];
+        const auto& c = stages[slot];
+        vectors[stage] = { Ops::splat(c.b0), Ops::splat(c.b1), Ops::splat(c.b2), Ops::splat(c.a1), Ops::splat(c.a2),
+                           Ops::loadAligned(state.s1[slot].data()), Ops::loadAligned(state.s2[slot].data()) };
+    }
+
+    // Unused lanes re-filter lane 0 so their state stays finite; their output is dropped.
+    std::array<const float*, kLanes> sources {};
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        sources[lane] = lanes[lane < numLanes ? lane : 0];
+    }
+
+    std::size_t index = 0;
+    for (; index + kLanes <= numSamples; index += kLanes) {
+        Vector rows[kLanes] {
+            Ops::load(sources[0] + index),
+            Ops::load(sources[1] + index),
+            Ops::load(sources[2] + index),
+            Ops::load(sources[3] + index),
+        };
+        Ops::transpose(rows[0], rows[1], rows[2], rows[3]);
+        for (std::size_t stage = 0; stage < numActive; ++stage) {
+            auto& s = vectors[stage];
+            for (auto& x : rows) {
+                const auto y = Ops::add(Ops::mul(s.b0, x), s.z1);
+                s.z1 = Ops::add(Ops::sub(Ops::mul(s.b1, x), Ops::mul(s.a1, y)), s.z2);
+                s.z2 = Ops::sub(Ops::mul(s.b2, x), Ops::mul(s.a2, y));
+                x = y;
+            }
+        }
+        Ops::transpose(rows[0], rows[1], rows[2], rows[3]);
+        for (std::size_t lane = 0; lane < numLanes; ++lane) {
+            Ops::store(lanes[lane] + index, rows[lane]);
+        }
+    }
+
+    for (std::size_t stage = 0; stage < numActive; ++stage) {
+        const auto slot = active[stage];
+        Ops::storeAligned(state.s1[slot].data(), vectors[stage].z1);
+        Ops::storeAligned(state.s2[slot].data(), vectors[stage].z2);
+    }
+
+    if (index < numSamples) {
+        for (std::size_t lane = 0; lane < numLanes; ++lane) {
+            processLane(lanes[lane] + index, numSamples - index, stages, active, numActive, state, lane);
+        }
+    }
+}
+#endif
+
+struct Kernels {
+    void (*group)(float* const*, std::size_t, std::size_t, const BiquadCoefficients*, const std::uint8_t*, std::size_t, BiquadCascade::LaneState&) noexcept;
+};
+
+// A group of kLanes channels fills one 128-bit vector, so AVX machines run the SSE2 kernel.
+const auto kKernels = selectSimdVariant(SimdVariants<Kernels> {
+    .scalar = { &processGroupScalar },
+#if BROADCASTMIX_SIMD_SSE2
+    .sse2 = Kernels { &processGroupVector<Sse2> },
+#endif
+#if BROADCASTMIX_SIMD_NEON
+    .neon = Kernels { &processGroupVector<Neon> },
+#endif
+});
+} // namespace
+
+bool BiquadCoefficients::isIdentity() const noexcept {
+    return b0 == 1.0F && b1 == 0.0F && b2 == 0.0F && a1 == 0.0F && a2 == 0.0F;
+}
+
+BiquadCoefficients BiquadCoefficients::highPass(double sampleRate, double frequency, double q) noexcept {
+    const auto [cosine, alpha] = prewarp(sampleRate, frequency, q);
+    return normalise((1.0 + cosine) / 2.0, -(1.0 + cosine), (1.0 + cosine) / 2.0, 1.0 + alpha, -2.0 * cosine, 1.0 - alpha);
+}
+
+BiquadCoefficients BiquadCoefficients::peak(double sampleRate, double frequency, double gainDecibels, double q) noexcept {
+    if (gainDecibels == 0.0) {
+        return {};
+    }
+    const auto [cosine, alpha] = prewarp(sampleRate, frequency, q);
+    const auto a = std::pow(10.0, gainDecibels / 40.0);
+    return normalise(1.0 + alpha * a, -2.0 * cosine, 1.0 - alpha * a, 1.0 + alpha / a, -2.0 * cosine, 1.0 - alpha / a);
+}
+
+BiquadCoefficients BiquadCoefficients::lowShelf(double sampleRate, double frequency, double gainDecibels, double q) noexcept {
+    if (gainDecibels == 0.0) {
+        return {};
+    }
+    const auto [cosine, alpha] = prewarp(sampleRate, frequency, q);
+    const auto a = std::pow(10.0, gainDecibels / 40.0);
+    const auto root = 2.0 * std::sqrt(a) * alpha;
+    return normalise(a * ((a + 1.0) - (a - 1.0) * cosine + root),
+                     2.0 * a * ((a - 1.0) - (a + 1.0) * cosine),
+                     a * ((a + 1.0) - (a - 1.0) * cosine - root),
+                     (a + 1.0) + (a - 1.0) * cosine + root,
+                     -2.0 * ((a - 1.0) + (a + 1.0) * cosine),
+                     (a + 1.0) + (a - 1.0) * cosine - root);
+}
+
+BiquadCoefficients BiquadCoefficients::highShelf(double sampleRate, double frequency, double gainDecibels, double q) noexcept {
+    if (gainDecibels == 0.0) {
+        return {};
+    }
+    const auto [cosine, alpha] = prewarp(sampleRate, frequency, q);
+    const auto a = std::pow(10.0, gainDecibels / 40.0);
+    const auto root = 2.0 * std::sqrt(a) * alpha;
+    return normalise(a * ((a + 1.0) + (a - 1.0) * cosine + root),
+                     -2.0 * a * ((a - 1.0) + (a + 1.0) * cosine),
+                     a * ((a + 1.0) + (a - 1.0) * cosine - root),
+                     (a + 1.0) - (a - 1.0) * cosine + root,
+                     2.0 * ((a - 1.0) - (a + 1.0) * cosine),
+                     (a + 1.0) - (a - 1.0) * cosine - root);
+}
+
+void BiquadCascade::prepare(std::size_t numChannels) {
+    groups_.assign((numChannels + kLanes - 1) / kLanes, {});
+}
+
+void BiquadCascade::reset() noexcept {
+    std::fill(groups_.begin(), groups_.end(), LaneState {});
+}
+
+void BiquadCascade::setStage(std::size_t slot, const BiquadCoefficients& coefficients) noexcept {
+    if (slot >= kMaxStages) {
+        return;
+    }
+    const bool wasActive = !stages_[slot].isIdentity();
+    stages_[slot] = coefficients;
+    const bool isActive = !coefficients.isIdentity();
+    if (wasActive == isActive) {
+        return;
+    }
+    for (auto& group : groups_) {
+        group.s1[slot].fill(0.0F);
+        group.s2[slot].fill(0.0F);
+    }
+    rebuildActive();
+}
+
+void BiquadCascade::rebuildActive() noexcept {
+    numActive_ = 0;
+    for (std::size_t slot = 0; slot < kMaxStages; ++slot) {
+        if (!stages_[slot].isIdentity()) {
+            active_[numActive_++] = static_cast<std::uint8_t>(slot);
+        }
+    }
+}
+
+void BiquadCascade::process(float* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept {
+    if (numActive_ == 0) {
+        return;
+    }
+    const auto channelCount = std::min(numChannels, groups_.size() * kLanes);
+    for (std::size_t first = 0, group = 0; first < channelCount; first += kLanes, ++group) {
+        kKernels.kernels.group(channels + first, std::min(kLanes, channelCount - first), numSamples, stages_.data(), active_.data(), numActive_, groups_[group]);
+    }
+}
+
+void BiquadCascade::process(double* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept {
+    if (numActive_ == 0) {
+        return;
+    }
+    const auto channelCount = std::min(numChannels, groups_.size() * kLanes);
+    for (std::size_t channel = 0; channel < channelCount; ++channel) {
+        processLane(channels[channel], numSamples, stages_.data(), active_.data(), numActive_, groups_[channel / kLanes], channel % kLanes);
+    }
+}
+
+const char* biquadKernelName() noexcept {
+    return kKernels.name;
+}
+
+} // namespace broadcastmix::audio::dsp
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace broadcastmix::audio::dsp {
+
+// Normalised (a0 == 1) biquad from the RBJ cookbook formulas.
+struct BiquadCoefficients {
+    float b0 { 1.0F };
+    float b1 { 0.0F };
+    float b2 { 0.0F };
+    float a1 { 0.0F };
+    float a2 { 0.0F };
+
+    [[nodiscard]] bool isIdentity() const noexcept;
+
+    [[nodiscard]] static BiquadCoefficients highPass(double sampleRate, double frequency, double q) noexcept;
+    [[nodiscard]] static BiquadCoefficients peak(double sampleRate, double frequency, double gainDecibels, double q) noexcept;
+    [[nodiscard]] static BiquadCoefficients lowShelf(double sampleRate, double frequency, double gainDecibels, double q) noexcept;
+    [[nodiscard]] static BiquadCoefficients highShelf(double sampleRate, double frequency, double gainDecibels, double q) noexcept;
+};
+
+// Serial biquad stages shared by every channel of a node. Channels are grouped kLanes at a
+// time and each vector lane carries one channel, so a stage costs the same handful of
+// vector operations whether it filters one channel or four. Stages sit in fixed slots;
+// an identity slot is skipped entirely and its state cleared, so flat bands are free and
+// re-enabling one starts from silence instead of stale history.
+class BiquadCascade {
+public:
+    static constexpr std::size_t kMaxStages = 8;
+    static constexpr std::size_t kLanes = 4;
+
+    struct LaneState {
+        alignas(16) std::array<std::array<float, kLanes>, kMaxStages> s1 {};
+        alignas(16) std::array<std::array<float, kLanes>, kMaxStages> s2 {};
+    };
+
+    void prepare(std::size_t numChannels);
+    void reset() noexcept;
+
+    void setStage(std::size_t slot, const BiquadCoefficients& coefficients) noexcept;
+    [[nodiscard]] std::size_t activeStages() const noexcept { return numActive_; }
+
+    void process(float* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept;
+    void process(double* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept;
+
+private:
+    void rebuildActive() noexcept;
+
+    std::array<BiquadCoefficients, kMaxStages> stages_ {};
+    std::array<std::uint8_t, kMaxStages> active_ {};
+    std::size_t numActive_ { 0 };
+    std::vector<LaneState> groups_;
+};
+
+[[nodiscard]] const char* biquadKernelName() noexcept;
+
+} // namespace broadcastmix::audio::dsp
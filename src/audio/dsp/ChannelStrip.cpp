@@ -0,0 +1,180 @@
+#include "ChannelStrip.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace broadcastmix::audio::dsp {
+
+namespace {
+constexpr std::size_t kHighPassSlot = 0;
+constexpr std::size_t kFirstBandSlot = 1;
+constexpr double kButterworthQ = 0.70710678118654752440;
+// 20 * log10(2) and its inverse, so decibel conversions use the cheaper base-2 functions.
+constexpr float kDecibelsPerOctave = 6.0205999F;
+constexpr float kOctavesPerDecibel = 1.0F / kDecibelsPerOctave;
+
+float fromDecibels(float decibels) noexcept {
+    return std::exp2(decibels * kOctavesPerDecibel);
+}
+
+BiquadCoefficients bandCoefficients(std::size_t band, const ChannelStrip::Band& settings, double sampleRate) noexcept {
+    const auto frequency = static_cast<double>(settings.frequency);
+    const auto gain = static_cast<double>(settings.gainDecibels);
+    const auto q = static_cast<double>(settings.q);
+    if (band == 0) {
+        return BiquadCoefficients::lowShelf(sampleRate, frequency, gain, q);
+    }
+    if (band == ChannelStrip::kBands - 1) {
+        return BiquadCoefficients::highShelf(sampleRate, frequency, gain, q);
+    }
+    return BiquadCoefficients::peak(sampleRate, frequency, gain, q);
+}
+} // namespace
+
+ChannelStrip::ChannelStrip() {
+    updateDynamics();
+}
+
+void ChannelStrip::prepare(double sampleRate, std::size_t numChannels) {
+    sampleRate_ = sampleRate > 0.0 ? sampleRate : 48000.0;
+    filters_.prepare(numChannels);
+    updateFilters(settings_, true);
+    updateDynamics();
+    reset();
+}
+
+void ChannelStrip::reset() noexcept {
+    filters_.reset();
+    reductionDecibels_ = 0.0F;
+    gateGain_ = 1.0F;
+    gateHold_ = 0;
+    gain_ = 1.0F;
+}
+
+void ChannelStrip::setSettings(const Settings& settings) noexcept {
+    if (settings == settings_) {
+        return;
+    }
+    const auto previous = settings_;
+    settings_ = settings;
+    updateFilters(previous, false);
+    updateDynamics();
+}
+
+void ChannelStrip::process(float* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept {
+    filters_.process(channels, numChannels, numSamples);
+    if (!dynamicsIdle()) {
+        processDynamics(channels, numChannels, numSamples);
+    }
+}
+
+void ChannelStrip::process(double* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept {
+    filters_.process(channels, numChannels, numSamples);
+    if (!dynamicsIdle()) {
+        processDynamics(channels, numChannels, numSamples);
+    }
+}
+
+bool ChannelStrip::dynamicsIdle() const noexcept {
+    // Stages switched off still finish their way back to unity before the pass is skipped.
+    return settings_.gateThresholdDecibels <= kOffDecibels && settings_.compressorRatio <= 1.0F
+        && settings_.makeupDecibels == 0.0F && gain_ == 1.0F && gateGain_ == 1.0F && reductionDecibels_ == 0.0F;
+}
+
+template <typename SampleType>
+void ChannelStrip::processDynamics(SampleType* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept {
+    const bool gateOn = settings_.gateThresholdDecibels > kOffDecibels;
+    const bool compressorOn = settings_.compressorRatio > 1.0F;
+    const auto gateFloor = fromDecibels(kGateRangeDecibels);
+
+    // Per-instant work is element-wise across channels into ramp, so it vectorises; only
+    // the per-period reduction and gain computation are scalar.
+    std::array<float, kControlSamples> ramp {};
+    for (std::size_t offset = 0; offset < numSamples; offset += kControlSamples) {
+        const auto count = std::min(kControlSamples, numSamples - offset);
+
+        ramp.fill(0.0F);
+        for (std::size_t channel = 0; channel < numChannels; ++channel) {
+            const auto* samples = channels[channel] + offset;
+            for (std::size_t index = 0; index < count; ++index) {
+                ramp[index] = std::max(ramp[index], static_cast<float>(std::abs(samples[index])));
+            }
+        }
+        const auto level = *std::max_element(ramp.begin(), ramp.begin() + static_cast<std::ptrdiff_t>(count));
+
+        if (gateOn && level < gateThreshold_) {
+            gateHold_ = gateHold_ > count ? gateHold_ - count : 0;
+        } else {
+            gateHold_ = gateHoldSamples_;
+        }
+        const bool gateOpen = gateHold_ > 0;
+        gateGain_ += ((gateOpen ? 1.0F : gateFloor) - gateGain_) * (gateOpen ? gateAttack_ : gateRelease_);
+        if (std::abs(gateGain_ - 1.0F) < 1.0e-6F) {
+            gateGain_ = 1.0F;
+        }
+
+        // The log is only taken once the level is over the threshold.
+        auto targetReduction = 0.0F;
+        if (compressorOn && level > compressorThreshold_) {
+            targetReduction = (kDecibelsPerOctave * std::log2(level) - settings_.compressorThresholdDecibels) * compressorSlope_;
+        }
+        reductionDecibels_ += (targetReduction - reductionDecibels_) * (targetReduction > reductionDecibels_ ? attack_ : release_);
+        if (reductionDecibels_ < 1.0e-4F) {
+            reductionDecibels_ = 0.0F;
+        }
+
+        const auto dynamicDecibels = settings_.makeupDecibels - reductionDecibels_;
+        const auto target = gateGain_ * (dynamicDecibels == 0.0F ? 1.0F : fromDecibels(dynamicDecibels));
+        if (target != 1.0F || gain_ != 1.0F) {
+            const auto step = (target - gain_) / static_cast<float>(count);
+            for (std::size_t index = 0; index < count; ++index) {
+                ramp[index] = gain_ + step * static_cast<float>(index + 1);
+            }
+            for (std::size_t channel = 0; channel < numChannels; ++channel) {
+                auto* samples = channels[channel] + offset;
+                for (std::size_t index = 0; index < count; ++index) {
+                    samples[index] *= static_cast<SampleType>(ramp[index]);
+                }
+            }
+        }
+        gain_ = target;
+    }
+}
+
+void ChannelStrip::updateFilters(const Settings& previous, bool force) noexcept {
+    if (force || settings_.highPassFrequency != previous.highPassFrequency) {
+        filters_.setStage(kHighPassSlot,
+                          settings_.highPassFrequency > 0.0F
+                              ? BiquadCoefficients::highPass(sampleRate_, settings_.highPassFrequency, kButterworthQ)
+                              : BiquadCoefficients {});
+    }
+    for (std::size_t band = 0; band < kBands; ++band) {
+        if (force || settings_.bands[band] != previous.bands[band]) {
+            filters_.setStage(kFirstBandSlot + band, bandCoefficients(band, settings_.bands[band], sampleRate_));
+        }
+    }
+}
+
+void ChannelStrip::updateDynamics() noexcept {
+    gateThreshold_ = fromDecibels(settings_.gateThresholdDecibels);
+    compressorThreshold_ = fromDecibels(settings_.compressorThresholdDecibels);
+    compressorSlope_ = settings_.compressorRatio > 1.0F ? 1.0F - 1.0F / settings_.compressorRatio : 0.0F;
+    attack_ = periodCoefficient(settings_.compressorAttackMilliseconds);
+    release_ = periodCoefficient(settings_.compressorReleaseMilliseconds);
+    gateAttack_ = periodCoefficient(kGateAttackMilliseconds);
+    gateRelease_ = periodCoefficient(kGateReleaseMilliseconds);
+    gateHoldSamples_ = static_cast<std::size_t>(kGateHoldMilliseconds * 0.001 * sampleRate_);
+}
+
+float ChannelStrip::periodCoefficient(double milliseconds) const noexcept {
+    const auto samples = milliseconds * 0.001 * sampleRate_;
+    if (samples <= static_cast<double>(kControlSamples)) {
+        return 1.0F;
+    }
+    return static_cast<float>(1.0 - std::exp(-static_cast<double>(kControlSamples) / samples));
+}
+
+template void ChannelStrip::processDynamics<float>(float* const*, std::size_t, std::size_t) noexcept;
+template void ChannelStrip::processDynamics<double>(double* const*, std::size_t, std::size_t) noexcept;
+
+} // namespace broadcastmix::audio::dsp
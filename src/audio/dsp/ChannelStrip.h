@@ -0,0 +1,85 @@
+#pragma once
+
+#include "BiquadCascade.h"
+
+#include <array>
+#include <cstddef>
+
+namespace broadcastmix::audio::dsp {
+
+// Input channel processing: high-pass, four-band EQ (low shelf, two peaks, high shelf),
+// gate and compressor, in that order. All filters run as one BiquadCascade and both
+// dynamics stages share a detector and a single gain pass, linked across channels. The
+// dynamics gain is computed every kControlSamples and ramped between, and the log/exp
+// work is skipped while the signal sits below both thresholds.
+class ChannelStrip {
+public:
+    static constexpr std::size_t kBands = 4;
+    static constexpr std::size_t kControlSamples = 16;
+    // A gate threshold at or below this, like a high-pass at 0 Hz, turns the stage off.
+    static constexpr float kOffDecibels = -100.0F;
+    static constexpr float kGateRangeDecibels = -80.0F;
+    static constexpr double kGateHoldMilliseconds = 50.0;
+    static constexpr double kGateAttackMilliseconds = 0.5;
+    static constexpr double kGateReleaseMilliseconds = 80.0;
+
+    struct Band {
+        float frequency { 1000.0F };
+        float gainDecibels { 0.0F };
+        float q { 0.707F };
+
+        bool operator==(const Band&) const = default;
+    };
+
+    struct Settings {
+        float highPassFrequency { 0.0F };
+        std::array<Band, kBands> bands { { { 100.0F }, { 400.0F }, { 2500.0F }, { 8000.0F } } };
+        float gateThresholdDecibels { kOffDecibels };
+        float compressorThresholdDecibels { 0.0F };
+        float compressorRatio { 1.0F };
+        float compressorAttackMilliseconds { 10.0F };
+        float compressorReleaseMilliseconds { 100.0F };
+        float makeupDecibels { 0.0F };
+
+        bool operator==(const Settings&) const = default;
+    };
+
+    ChannelStrip();
+
+    void prepare(double sampleRate, std::size_t numChannels);
+    void reset() noexcept;
+    void setSettings(const Settings& settings) noexcept;
+
+    void process(float* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept;
+    void process(double* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept;
+
+    [[nodiscard]] float gainReductionDecibels() const noexcept { return reductionDecibels_; }
+
+private:
+    template <typename SampleType>
+    void processDynamics(SampleType* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept;
+    [[nodiscard]] bool dynamicsIdle() const noexcept;
+    void updateFilters(const Settings& previous, bool force) noexcept;
+    void updateDynamics() noexcept;
+    [[nodiscard]] float periodCoefficient(double milliseconds) const noexcept;
+
+    double sampleRate_ { 48000.0 };
+    Settings settings_;
+    BiquadCascade filters_;
+
+    float gateThreshold_ { 0.0F };
+    float compressorThreshold_ { 1.0F };
+    float compressorSlope_ { 0.0F };
+    float attack_ { 1.0F };
+    float release_ { 1.0F };
+    float gateAttack_ { 1.0F };
+    float gateRelease_ { 1.0F };
+    std::size_t gateHoldSamples_ { 0 };
+
+    float reductionDecibels_ { 0.0F };
+    float gateGain_ { 1.0F };
+    std::size_t gateHold_ { 0 };
+    float gain_ { 1.0F };
+};
+
+} // namespace broadcastmix::audio::dsp
@@ -0,0 +1,54 @@
+#include "DelayLine.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace broadcastmix::audio::dsp {
+
+std::size_t DelayLine::storageSize(std::size_t maxDelay, std::size_t maxBlock) noexcept {
+    return std::bit_ceil(std::max<std::size_t>(maxDelay + maxBlock, 1));
+}
+
+void DelayLine::prepare(std::size_t maxDelay, std::size_t maxBlock) {
+    owned_.assign(storageSize(maxDelay, maxBlock), 0.0F);
+    prepare(owned_.data(), maxDelay, maxBlock);
+}
+
+void DelayLine::prepare(float* storage, std::size_t maxDelay, std::size_t maxBlock) noexcept {
+    if (storage != owned_.data()) {
+        owned_ = {};
+    }
+    maxDelay_ = maxDelay;
+    buffer_ = storage;
+    size_ = storageSize(maxDelay, maxBlock);
+    mask_ = size_ - 1;
+    reset();
+}
+
+void DelayLine::reset() noexcept {
+    std::fill_n(buffer_, size_, 0.0F);
+    write_ = 0;
+}
+
+void DelayLine::process(const float* input, float* output, std::size_t numSamples, std::size_t delay) noexcept {
+    if (buffer_ == nullptr) {
+        std::copy_n(input, numSamples, output);
+        return;
+    }
+    delay = std::min(delay, maxDelay_);
+
+    // Both the write and the read are at most two contiguous runs around the wrap point.
+    const auto size = size_;
+    const auto writeHead = std::min(numSamples, size - write_);
+    std::copy_n(input, writeHead, buffer_ + write_);
+    std::copy_n(input + writeHead, numSamples - writeHead, buffer_);
+
+    const auto read = (write_ + size - delay) & mask_;
+    const auto readHead = std::min(numSamples, size - read);
+    std::copy_n(buffer_ + read, readHead, output);
+    std::copy_n(buffer_, numSamples - readHead, output + readHead);
+
+    write_ = (write_ + numSamples) & mask_;
+}
+
+} // namespace broadcastmix::audio::dsp
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace broadcastmix::audio::dsp {
+
+// Fixed-capacity integer delay for latency compensation. Storage is sized once in
+// prepare, either owned by the line or borrowed from the caller; process never
+// allocates, and the delay may change from block to block.
+class DelayLine {
+public:
+    DelayLine() = default;
+    // A line may point into its own storage, so it moves but does not copy.
+    DelayLine(DelayLine&&) noexcept = default;
+    DelayLine& operator=(DelayLine&&) noexcept = default;
+    DelayLine(const DelayLine&) = delete;
+    DelayLine& operator=(const DelayLine&) = delete;
+
+    // Samples of storage a line needs for the given limits.
+    [[nodiscard]] static std::size_t storageSize(std::size_t maxDelay, std::size_t maxBlock) noexcept;
+
+    void prepare(std::size_t maxDelay, std::size_t maxBlock);
+    // Runs in storage the caller keeps alive, which must hold storageSize(maxDelay, maxBlock) samples.
+    void prepare(float* storage, std::size_t maxDelay, std::size_t maxBlock) noexcept;
+    void reset() noexcept;
+
+    // Writes input into the line and reads the same number of samples delayed by delay.
+    // numSamples may not exceed maxBlock, input and output must not overlap, and delay is
+    // clamped to maxDelay.
+    void process(const float* input, float* output, std::size_t numSamples, std::size_t delay) noexcept;
+
+    [[nodiscard]] std::size_t maxDelay() const noexcept { return maxDelay_; }
+
+private:
+    std::vector<float> owned_;
+    float* buffer_ { nullptr };
+    std::size_t size_ { 0 };
+    std::size_t mask_ { 0 };
+    std::size_t write_ { 0 };
+    std::size_t maxDelay_ { 0 };
+};
+
+} // namespace broadcastmix::audio::dsp
@@ -0,0 +1,234 @@
+#include "MeterKernel.h"
+
+#include "SimdDispatch.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace broadcastmix::audio::dsp {
+
+namespace {
+
+template <typename SampleType>
+ChannelLevel measureScalar(const SampleType* samples, std::size_t numSamples) noexcept {
+    SampleType peak { 0 };
+    SampleType sum { 0 };
+    for (std::size_t index = 0; index < numSamples; ++index) {
+        const auto value = samples[index];
+        peak = std::max(peak, std::abs(value));
+        sum += value * value;
+    }
+    return { static_cast<float>(peak), static_cast<double>(sum) };
+}
+
+#if BROADCASTMIX_SIMD_SSE2
+ChannelLevel measureSse2(const float* samples, std::size_t numSamples) noexcept {
+    const auto signMask = _mm_set1_ps(-0.0F);
+    auto peak0 = _mm_setzero_ps();
+    auto peak1 = _mm_setzero_ps();
+    auto sum0 = _mm_setzero_ps();
+    auto sum1 = _mm_setzero_ps();
+
+    std::size_t index = 0;
+    for (; index + 8 <= numSamples; index += 8) {
+        const auto a = _mm_loadu_ps(samples + index);
+        const auto b = _mm_loadu_ps(samples + index + 4);
+        peak0 = _mm_max_ps(peak0, _mm_andnot_ps(signMask, a));
+        peak1 = _mm_max_ps(peak1, _mm_andnot_ps(signMask, b));
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(a, a));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(b, b));
+    }
+
+    alignas(16) float peaks[4];
+    alignas(16) float sums[4];
+    _mm_store_ps(peaks, _mm_max_ps(peak0, peak1));
+    _mm_store_ps(sums, _mm_add_ps(sum0, sum1));
+
+    auto tail = measureScalar(samples + index, numSamples - index);
+    tail.peak = std::max({ tail.peak, peaks[0], peaks[1], peaks[2], peaks[3] });
+    tail.sumOfSquares += static_cast<double>(sums[0]) + sums[1] + sums[2] + sums[3];
+    return tail;
+}
+
+ChannelLevel measureSse2(const double* samples, std::size_t numSamples) noexcept {
+    const auto signMask = _mm_set1_pd(-0.0);
+    auto peak0 = _mm_setzero_pd();
+    auto peak1 = _mm_setzero_pd();
+    auto sum0 = _mm_setzero_pd();
+    auto sum1 = _mm_setzero_pd();
+
+    std::size_t index = 0;
+    for (; index + 4 <= numSamples; index += 4) {
+        const auto a = _mm_loadu_pd(samples + index);
+        const auto b = _mm_loadu_pd(samples + index + 2);
+        peak0 = _mm_max_pd(peak0, _mm_andnot_pd(signMask, a));
+        peak1 = _mm_max_pd(peak1, _mm_andnot_pd(signMask, b));
+        sum0 = _mm_add_pd(sum0, _mm_mul_pd(a, a));
+        sum1 = _mm_add_pd(sum1, _mm_mul_pd(b, b));
+    }
+
+    alignas(16) double peaks[2];
+    alignas(16) double sums[2];
+    _mm_store_pd(peaks, _mm_max_pd(peak0, peak1));
+    _mm_store_pd(sums, _mm_add_pd(sum0, sum1));
+
+    auto tail = measureScalar(samples + index, numSamples - index);
+    tail.peak = std::max({ tail.peak, static_cast<float>(peaks[0]), static_cast<float>(peaks[1]) });
+    tail.sumOfSquares += sums[0] + sums[1];
+    return tail;
+}
+#endif
+
+#if BROADCASTMIX_SIMD_AVX
+__attribute__((target("avx"))) ChannelLevel measureAvx(const float* samples, std::size_t numSamples) noexcept {
+    const auto signMask = _mm256_set1_ps(-0.0F);
+    auto peak0 = _mm256_setzero_ps();
+    auto peak1 = _mm256_setzero_ps();
+    auto sum0 = _mm256_setzero_ps();
+    auto sum1 = _mm256_setzero_ps();
+
+    std::size_t index = 0;
+    for (; index + 16 <= numSamples; index += 16) {
+        const auto a = _mm256_loadu_ps(samples + index);
+        const auto b = _mm256_loadu_ps(samples + index + 8);
+        peak0 = _mm256_max_ps(peak0, _mm256_andnot_ps(signMask, a));
+        peak1 = _mm256_max_ps(peak1, _mm256_andnot_ps(signMask, b));
+        sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(a, a));
+        sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(b, b));
+    }
+
+    alignas(32) float peaks[8];
+    alignas(32) float sums[8];
+    _mm256_store_ps(peaks, _mm256_max_ps(peak0, peak1));
+    _mm256_store_ps(sums, _mm256_add_ps(sum0, sum1));
+
+    auto tail = measureSse2(samples + index, numSamples - index);
+    for (int lane = 0; lane < 8; ++lane) {
+        tail.peak = std::max(tail.peak, peaks[lane]);
+        tail.sumOfSquares += sums[lane];
+    }
+    return tail;
+}
+
+__attribute__((target("avx"))) ChannelLevel measureAvx(const double* samples, std::size_t numSamples) noexcept {
+    const auto signMask = _mm256_set1_pd(-0.0);
+    auto peak0 = _mm256_setzero_pd();
+    auto peak1 = _mm256_setzero_pd();
+    auto sum0 = _mm256_setzero_pd();
+    auto sum1 = _mm256_setzero_pd();
+
+    std::size_t index = 0;
+    for (; index + 8 <= numSamples; index += 8) {
+        const auto a = _mm256_loadu_pd(samples + index);
+        const auto b = _mm256_loadu_pd(samples + index + 4);
+        peak0 = _mm256_max_pd(peak0, _mm256_andnot_pd(signMask, a));
+        peak1 = _mm256_max_pd(peak1, _mm256_andnot_pd(signMask, b));
+        sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(a, a));
+        sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(b, b));
+    }
+
+    alignas(32) double peaks[4];
+    alignas(32) double sums[4];
+    _mm256_store_pd(peaks, _mm256_max_pd(peak0, peak1));
+    _mm256_store_pd(sums, _mm256_add_pd(sum0, sum1));
+
+    auto tail = measureSse2(samples + index, numSamples - index);
+    for (int lane = 0; lane < 4; ++lane) {
+        tail.peak = std::max(tail.peak, static_cast<float>(peaks[lane]));
+        tail.sumOfSquares += sums[lane];
+    }
+    return tail;
+}
+#endif
+
+#if BROADCASTMIX_SIMD_NEON
+ChannelLevel measureNeon(const float* samples, std::size_t numSamples) noexcept {
+    auto peak0 = vdupq_n_f32(0.0F);
+    auto peak1 = vdupq_n_f32(0.0F);
+    auto sum0 = vdupq_n_f32(0.0F);
+    auto sum1 = vdupq_n_f32(0.0F);
+
+    std::size_t index = 0;
+    for (; index + 8 <= numSamples; index += 8) {
+        const auto a = vld1q_f32(samples + index);
+        const auto b = vld1q_f32(samples + index + 4);
+        peak0 = vmaxq_f32(peak0, vabsq_f32(a));
+        peak1 = vmaxq_f32(peak1, vabsq_f32(b));
+        sum0 = vfmaq_f32(sum0, a, a);
+        sum1 = vfmaq_f32(sum1, b, b);
+    }
+
+    auto tail = measureScalar(samples + index, numSamples - index);
+    tail.peak = std::max(tail.peak, vmaxvq_f32(vmaxq_f32(peak0, peak1)));
+    tail.sumOfSquares += vaddvq_f32(vaddq_f32(sum0, sum1));
+    return tail;
+}
+
+ChannelLevel measureNeon(const double* samples, std::size_t numSamples) noexcept {
+    auto peak0 = vdupq_n_f64(0.0);
+    auto peak1 = vdupq_n_f64(0.0);
+    auto sum0 = vdupq_n_f64(0.0);
+    auto sum1 = vdupq_n_f64(0.0);
+
+    std::size_t index = 0;
+    for (; index + 4 <= numSamples; index += 4) {
+        const auto a = vld1q_f64(samples + index);
+        const auto b = vld1q_f64(samples + index + 2);
+        peak0 = vmaxq_f64(peak0, vabsq_f64(a));
+        peak1 = vmaxq_f64(peak1, vabsq_f64(b));
+        sum0 = vfmaq_f64(sum0, a, a);
+        sum1 = vfmaq_f64(sum1, b, b);
+    }
+
+    auto tail = measureScalar(samples + index, numSamples - index);
+    tail.peak = std::max(tail.peak, static_cast<float>(vmaxvq_f64(vmaxq_f64(peak0, peak1))));
+    tail.sumOfSquares += vaddvq_f64(vaddq_f64(sum0, sum1));
+    return tail;
+}
+#endif
+
+struct Kernels {
+    ChannelLevel (*measureFloat)(const float*, std::size_t) noexcept;
+    ChannelLevel (*measureDouble)(const double*, std::size_t) noexcept;
+};
+
+const auto kKernels = selectSimdVariant(SimdVariants<Kernels> {
+    .scalar = { &measureScalar<float>, &measureScalar<double> },
+#if BROADCASTMIX_SIMD_SSE2
+    .sse2 = Kernels { &measureSse2, &measureSse2 },
+#endif
+#if BROADCASTMIX_SIMD_AVX
+    .avx = Kernels { &measureAvx, &measureAvx },
+#endif
+#if BROADCASTMIX_SIMD_NEON
+    .neon = Kernels { &measureNeon, &measureNeon },
+#endif
+});
+
+} // namespace
+
+void measureLevels(const float* const* channels, std::size_t numChannels, std::size_t numSamples, ChannelLevel* levels) noexcept {
+    for (std::size_t channel = 0; channel < numChannels; ++channel) {
+        levels[channel] = channels[channel] != nullptr ? kKernels.kernels.measureFloat(channels[channel], numSamples) : ChannelLevel {};
+    }
+}
+
+void measureLevels(const double* const* channels, std::size_t numChannels, std::size_t numSamples, ChannelLevel* levels) noexcept {
+    for (std::size_t channel = 0; channel < numChannels; ++channel) {
+        levels[channel] = channels[channel] != nullptr ? kKernels.kernels.measureDouble(channels[channel], numSamples) : ChannelLevel {};
+    }
+}
+
+ChannelLevel measureChannel(const float* samples, std::size_t numSamples) noexcept {
+    return kKernels.kernels.measureFloat(samples, numSamples);
+}
+
+ChannelLevel measureChannel(const double* samples, std::size_t numSamples) noexcept {
+    return kKernels.kernels.measureDouble(samples, numSamples);
+}
+
+const char* meterKernelName() noexcept {
+    return kKernels.name;
+}
+
+} // namespace broadcastmix::audio::dsp
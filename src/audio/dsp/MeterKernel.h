@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+namespace broadcastmix::audio::dsp {
+
+struct ChannelLevel {
+    float peak { 0.0F };
+    double sumOfSquares { 0.0 };
+};
+
+// Peak magnitude and sum of squares of every channel, both from a single read of
+// each sample. Dispatches to AVX, SSE2 or NEON where available.
+void measureLevels(const float* const* channels, std::size_t numChannels, std::size_t numSamples, ChannelLevel* levels) noexcept;
+void measureLevels(const double* const* channels, std::size_t numChannels, std::size_t numSamples, ChannelLevel* levels) noexcept;
+
+[[nodiscard]] ChannelLevel measureChannel(const float* samples, std::size_t numSamples) noexcept;
+[[nodiscard]] ChannelLevel measureChannel(const double* samples, std::size_t numSamples) noexcept;
+
+[[nodiscard]] const char* meterKernelName() noexcept;
+
+} // namespace broadcastmix::audio::dsp
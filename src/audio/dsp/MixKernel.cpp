@@ -0,0 +1,138 @@
+#include "MixKernel.h"
+
+#include "SimdDispatch.h"
+
+namespace broadcastmix::audio::dsp {
+
+namespace {
+
+void sumScalar(float* destination,
+               const float* const* sources,
+               const float* gains,
+               std::size_t numSources,
+               std::size_t start,
+               std::size_t numSamples) noexcept {
+    for (std::size_t index = start; index < numSamples; ++index) {
+        float sum = 0.0F;
+        for (std::size_t source = 0; source < numSources; ++source) {
+            sum += gains[source] * sources[source][index];
+        }
+        destination[index] = sum;
+    }
+}
+
+#if BROADCASTMIX_SIMD_SSE2
+void sumSse2(float* destination, const float* const* sources, const float* gains, std::size_t numSources, std::size_t numSamples) noexcept {
+    std::size_t index = 0;
+    for (; index + 16 <= numSamples; index += 16) {
+        auto sum0 = _mm_setzero_ps();
+        auto sum1 = _mm_setzero_ps();
+        auto sum2 = _mm_setzero_ps();
+        auto sum3 = _mm_setzero_ps();
+        for (std::size_t source = 0; source < numSources; ++source) {
+            const auto* samples = sources[source] + index;
+            const auto gain = _mm_set1_ps(gains[source]);
+            sum0 = _mm_add_ps(sum0, _mm_mul_ps(gain, _mm_loadu_ps(samples)));
+            sum1 = _mm_add_ps(sum1, _mm_mul_ps(gain, _mm_loadu_ps(samples + 4)));
+            sum2 = _mm_add_ps(sum2, _mm_mul_ps(gain, _mm_loadu_ps(samples + 8)));
+            sum3 = _mm_add_ps(sum3, _mm_mul_ps(gain, _mm_loadu_ps(samples + 12)));
+        }
+        _mm_storeu_ps(destination + index, sum0);
+        _mm_storeu_ps(destination + index + 4, sum1);
+        _mm_storeu_ps(destination + index + 8, sum2);
+        _mm_storeu_ps(destination + index + 12, sum3);
+    }
+    sumScalar(destination, sources, gains, numSources, index, numSamples);
+}
+#endif
+
+#if BROADCASTMIX_SIMD_AVX
+__attribute__((target("avx"))) void sumAvx(float* destination,
+                                           const float* const* sources,
+                                           const float* gains,
+                                           std::size_t numSources,
+                                           std::size_t numSamples) noexcept {
+    std::size_t index = 0;
+    for (; index + 32 <= numSamples; index += 32) {
+        auto sum0 = _mm256_setzero_ps();
+        auto sum1 = _mm256_setzero_ps();
+        auto sum2 = _mm256_setzero_ps();
+        auto sum3 = _mm256_setzero_ps();
+        for (std::size_t source = 0; source < numSources; ++source) {
+            const auto* samples = sources[source] + index;
+            const auto gain = _mm256_set1_ps(gains[source]);
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(gain, _mm256_loadu_ps(samples)));
+            sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(gain, _mm256_loadu_ps(samples + 8)));
+            sum2 = _mm256_add_ps(sum2, _mm256_mul_ps(gain, _mm256_loadu_ps(samples + 16)));
+            sum3 = _mm256_add_ps(sum3, _mm256_mul_ps(gain, _mm256_loadu_ps(samples + 24)));
+        }
+        _mm256_storeu_ps(destination + index, sum0);
+        _mm256_storeu_ps(destination + index + 8, sum1);
+        _mm256_storeu_ps(destination + index + 16, sum2);
+        _mm256_storeu_ps(destination + index + 24, sum3);
+    }
+    sumScalar(destination, sources, gains, numSources, index, numSamples);
+}
+#endif
+
+#if BROADCASTMIX_SIMD_NEON
+void sumNeon(float* destination, const float* const* sources, const float* gains, std::size_t numSources, std::size_t numSamples) noexcept {
+    std::size_t index = 0;
+    for (; index + 16 <= numSamples; index += 16) {
+        auto sum0 = vdupq_n_f32(0.0F);
+        auto sum1 = vdupq_n_f32(0.0F);
+        auto sum2 = vdupq_n_f32(0.0F);
+        auto sum3 = vdupq_n_f32(0.0F);
+        for (std::size_t source = 0; source < numSources; ++source) {
+            const auto* samples = sources[source] + index;
+            const auto gain = gains[source];
+            sum0 = vfmaq_n_f32(sum0, vld1q_f32(samples), gain);
+            sum1 = vfmaq_n_f32(sum1, vld1q_f32(samples + 4), gain);
+            sum2 = vfmaq_n_f32(sum2, vld1q_f32(samples + 8), gain);
+            sum3 = vfmaq_n_f32(sum3, vld1q_f32(samples + 12), gain);
+        }
+        vst1q_f32(destination + index, sum0);
+        vst1q_f32(destination + index + 4, sum1);
+        vst1q_f32(destination + index + 8, sum2);
+        vst1q_f32(destination + index + 12, sum3);
+    }
+    sumScalar(destination, sources, gains, numSources, index, numSamples);
+}
+#endif
+
+void sumPortable(float* destination, const float* const* sources, const float* gains, std::size_t numSources, std::size_t numSamples) noexcept {
+    sumScalar(destination, sources, gains, numSources, 0, numSamples);
+}
+
+struct Kernels {
+    void (*sum)(float*, const float* const*, const float*, std::size_t, std::size_t) noexcept;
+};
+
+const auto kKernels = selectSimdVariant(SimdVariants<Kernels> {
+    .scalar = { &sumPortable },
+#if BROADCASTMIX_SIMD_SSE2
+    .sse2 = Kernels { &sumSse2 },
+#endif
+#if BROADCASTMIX_SIMD_AVX
+    .avx = Kernels { &sumAvx },
+#endif
+#if BROADCASTMIX_SIMD_NEON
+    .neon = Kernels { &sumNeon },
+#endif
+});
+
+} // namespace
+
+void sumInto(float* destination,
+             const float* const* sources,
+             const float* gains,
+             std::size_t numSources,
+             std::size_t numSamples) noexcept {
+    kKernels.kernels.sum(destination, sources, gains, numSources, numSamples);
+}
+
+const char* mixKernelName() noexcept {
+    return kKernels.name;
+}
+
+} // namespace broadcastmix::audio::dsp
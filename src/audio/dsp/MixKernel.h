@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+namespace broadcastmix::audio::dsp {
+
+// destination = sum of gains[i] * sources[i], for any number of sources, in a single pass:
+// each run of samples is accumulated in registers across every source and stored once.
+// A source may be the destination itself. Dispatches to AVX, SSE2 or NEON where available.
+void sumInto(float* destination,
+             const float* const* sources,
+             const float* gains,
+             std::size_t numSources,
+             std::size_t numSamples) noexcept;
+
+[[nodiscard]] const char* mixKernelName() noexcept;
+
+} // namespace broadcastmix::audio::dsp
@@ -0,0 +1,210 @@
+#include "SignalGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace broadcastmix::audio::dsp {
+
+namespace {
+constexpr double kTwoPi = 6.283185307179586476925286766559;
+constexpr std::size_t kSweepSegmentSamples = SignalGenerator::kLanes * 2;
+constexpr float kPinkScale = 0.11F;
+constexpr float kNoiseScale = 1.0F / 2147483648.0F;
+
+double wrapPhase(double phase) noexcept {
+    phase = std::fmod(phase, kTwoPi);
+    return phase < 0.0 ? phase + kTwoPi : phase;
+}
+
+std::size_t roundUpToLanes(std::size_t numSamples) noexcept {
+    return (numSamples + SignalGenerator::kLanes - 1) / SignalGenerator::kLanes * SignalGenerator::kLanes;
+}
+
+template <typename SampleType>
+void addInto(SampleType* destination, const float* source, std::size_t numSamples) noexcept {
+    for (std::size_t index = 0; index < numSamples; ++index) {
+        destination[index] += static_cast<SampleType>(source[index]);
+    }
+}
+} // namespace
+
+SignalGenerator::SignalGenerator() {
+    reset();
+}
+
+void SignalGenerator::prepare(double sampleRate, std::size_t numChannels) {
+    sampleRate_ = sampleRate > 0.0 ? sampleRate : 48000.0;
+    identTones_.assign(numChannels, {});
+    reset();
+    for (std::size_t channel = 0; channel < numChannels; ++channel) {
+        identTones_[channel].setIncrement(kTwoPi * clampFrequency(identFrequency(channel)) / sampleRate_);
+    }
+}
+
+void SignalGenerator::reset() noexcept {
+    tone_.phase = 0.0;
+    for (auto& oscillator : identTones_) {
+        oscillator.phase = 0.0;
+    }
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        noiseState_[lane] = 0x9E3779B9U * static_cast<std::uint32_t>(lane + 1);
+    }
+    pinkState_.fill(0.0F);
+    sweepElapsed_ = 0.0;
+}
+
+void SignalGenerator::add(float* const* channels, std::size_t numChannels, std::size_t numSamples, const Settings& settings) noexcept {
+    addChannels(channels, numChannels, numSamples, settings);
+}
+
+void SignalGenerator::add(double* const* channels, std::size_t numChannels, std::size_t numSamples, const Settings& settings) noexcept {
+    addChannels(channels, numChannels, numSamples, settings);
+}
+
+double SignalGenerator::identFrequency(std::size_t channel) noexcept {
+    return kIdentBaseHz * std::exp2(static_cast<double>(channel % kIdentSemitones) / 12.0);
+}
+
+template <typename SampleType>
+void SignalGenerator::addChannels(SampleType* const* channels,
+                                  std::size_t numChannels,
+                                  std::size_t numSamples,
+                                  const Settings& settings) noexcept {
+    for (std::size_t offset = 0; offset < numSamples; offset += kChunkSamples) {
+        const auto count = std::min(kChunkSamples, numSamples - offset);
+
+        if (settings.signal == GeneratorSignal::ChannelIdent) {
+            const auto identChannels = std::min(numChannels, identTones_.size());
+            for (std::size_t channel = 0; channel < identChannels; ++channel) {
+                renderTone(scratch_.data(), count, identTones_[channel], settings.level);
+                addInto(channels[channel] + offset, scratch_.data(), count);
+            }
+            continue;
+        }
+
+        switch (settings.signal) {
+        case GeneratorSignal::WhiteNoise:
+            renderWhite(count, settings.level);
+            break;
+        case GeneratorSignal::PinkNoise:
+            renderPink(count, settings.level);
+            break;
+        case GeneratorSignal::LogSweep:
+            renderSweep(count, settings.level);
+            break;
+        case GeneratorSignal::Sine:
+        default:
+            tone_.setIncrement(kTwoPi * clampFrequency(settings.frequency) / sampleRate_);
+            renderTone(scratch_.data(), count, tone_, settings.level);
+            break;
+        }
+        for (std::size_t channel = 0; channel < numChannels; ++channel) {
+            addInto(channels[channel] + offset, scratch_.data(), count);
+        }
+    }
+}
+
+void SignalGenerator::Oscillator::setIncrement(double radiansPerSample) noexcept {
+    if (radiansPerSample == increment) {
+        return;
+    }
+    increment = radiansPerSample;
+    stepRe = std::cos(increment);
+    stepIm = std::sin(increment);
+    rotationRe = static_cast<float>(std::cos(increment * kLanes));
+    rotationIm = static_cast<float>(std::sin(increment * kLanes));
+}
+
+void SignalGenerator::renderTone(float* output, std::size_t numSamples, Oscillator& oscillator, float level) noexcept {
+    // Lane k starts at phase + k * increment; every step rotates all lanes by kLanes samples.
+    std::array<float, kLanes> re {};
+    std::array<float, kLanes> im {};
+    double laneRe = std::cos(oscillator.phase);
+    double laneIm = std::sin(oscillator.phase);
+    for (std::size_t lane = 0; lane < kLanes; ++lane) {
+        re[lane] = static_cast<float>(laneRe * level);
+        im[lane] = static_cast<float>(laneIm * level);
+        const auto nextRe = laneRe * oscillator.stepRe - laneIm * oscillator.stepIm;
+        laneIm = laneRe * oscillator.stepIm + laneIm * oscillator.stepRe;
+        laneRe = nextRe;
+    }
+
+    const auto rotationRe = oscillator.rotationRe;
+    const auto rotationIm = oscillator.rotationIm;
+    const auto rendered = roundUpToLanes(numSamples);
+    for (std::size_t index = 0; index < rendered; index += kLanes) {
+        std::copy_n(im.data(), kLanes, output + index);
+        for (std::size_t lane = 0; lane < kLanes; ++lane) {
+            const auto nextRe = re[lane] * rotationRe - im[lane] * rotationIm;
+            im[lane] = re[lane] * rotationIm + im[lane] * rotationRe;
+            re[lane] = nextRe;
+        }
+    }
+
+    oscillator.phase = wrapPhase(oscillator.phase + oscillator.increment * static_cast<double>(numSamples));
+}
+
+void SignalGenerator::renderWhite(std::size_t numSamples, float level) noexcept {
+    const auto scale = level * kNoiseScale;
+    const auto rendered = roundUpToLanes(numSamples);
+    for (std::size_t index = 0; index < rendered; index += kLanes) {
+        for (std::size_t lane = 0; lane < kLanes; ++lane) {
+            auto state = noiseState_[lane];
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            noiseState_[lane] = state;
+            scratch_[index + lane] = static_cast<float>(static_cast<std::int32_t>(state)) * scale;
+        }
+    }
+}
+
+void SignalGenerator::renderPink(std::size_t numSamples, float level) noexcept {
+    // Paul Kellet's refined pink filter over the white source; accurate to within 0.05 dB above 9 Hz.
+    renderWhite(numSamples, 1.0F);
+    auto [b0, b1, b2, b3, b4, b5, b6] = pinkState_;
+    const auto scale = level * kPinkScale;
+    for (std::size_t index = 0; index < numSamples; ++index) {
+        const auto white = scratch_[index];
+        b0 = 0.99886F * b0 + white * 0.0555179F;
+        b1 = 0.99332F * b1 + white * 0.0750759F;
+        b2 = 0.96900F * b2 + white * 0.1538520F;
+        b3 = 0.86650F * b3 + white * 0.3104856F;
+        b4 = 0.55000F * b4 + white * 0.5329522F;
+        b5 = -0.7616F * b5 - white * 0.0168980F;
+        scratch_[index] = (b0 + b1 + b2 + b3 + b4 + b5 + b6 + white * 0.5362F) * scale;
+        b6 = white * 0.115926F;
+    }
+    pinkState_ = { b0, b1, b2, b3, b4, b5, b6 };
+}
+
+void SignalGenerator::renderSweep(std::size_t numSamples, float level) noexcept {
+    // Exponential sweep, phi(n) = w0 * N / ln(K) * (K^(n/N) - 1). Each short segment runs at
+    // its average frequency, so the phase is exact at every segment boundary.
+    const auto endFrequency = clampFrequency(kSweepEndHz);
+    const auto sweepSamples = kSweepSeconds * sampleRate_;
+    const auto logRatio = std::log(endFrequency / kSweepStartHz);
+    const auto startIncrement = kTwoPi * kSweepStartHz / sampleRate_;
+    const auto phaseAt = [&](double elapsed) {
+        return startIncrement * sweepSamples / logRatio * std::expm1(logRatio * elapsed / sweepSamples);
+    };
+
+    for (std::size_t offset = 0; offset < numSamples; offset += kSweepSegmentSamples) {
+        const auto count = std::min(kSweepSegmentSamples, numSamples - offset);
+        if (sweepElapsed_ >= sweepSamples) {
+            sweepElapsed_ = 0.0;
+        }
+        const auto startPhase = phaseAt(sweepElapsed_);
+        const auto endPhase = phaseAt(sweepElapsed_ + static_cast<double>(count));
+        sweep_.phase = wrapPhase(startPhase);
+        sweep_.setIncrement((endPhase - startPhase) / static_cast<double>(count));
+        renderTone(scratch_.data() + offset, count, sweep_, level);
+        sweepElapsed_ += static_cast<double>(count);
+    }
+}
+
+double SignalGenerator::clampFrequency(double frequency) const noexcept {
+    return std::clamp(frequency, 1.0, 0.45 * sampleRate_);
+}
+
+} // namespace broadcastmix::audio::dsp
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../AudioEngine.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace broadcastmix::audio::dsp {
+
+// Test-signal source that adds into existing channel buffers. Tones rotate a phasor across
+// kLanes consecutive samples at a time and are re-seeded from an exact phase every chunk,
+// so they never call std::sin per sample and do not drift; noise comes from kLanes
+// interleaved xorshift streams. Mono signals are rendered once and summed into every
+// channel. ChannelIdent gives each channel its own semitone above kIdentBaseHz, so one
+// spectrum view of a line check tells every channel apart at once.
+class SignalGenerator {
+public:
+    static constexpr std::size_t kLanes = 8;
+    static constexpr std::size_t kChunkSamples = 256;
+    static constexpr std::size_t kIdentSemitones = 72;
+    static constexpr double kIdentBaseHz = 110.0;
+    static constexpr double kSweepStartHz = 20.0;
+    static constexpr double kSweepEndHz = 20000.0;
+    static constexpr double kSweepSeconds = 10.0;
+
+    struct Settings {
+        GeneratorSignal signal { GeneratorSignal::Sine };
+        double frequency { 1000.0 };
+        float level { 1.0F };
+    };
+
+    SignalGenerator();
+
+    void prepare(double sampleRate, std::size_t numChannels);
+    void reset() noexcept;
+
+    void add(float* const* channels, std::size_t numChannels, std::size_t numSamples, const Settings& settings) noexcept;
+    void add(double* const* channels, std::size_t numChannels, std::size_t numSamples, const Settings& settings) noexcept;
+
+    [[nodiscard]] static double identFrequency(std::size_t channel) noexcept;
+
+private:
+    struct Oscillator {
+        void setIncrement(double radiansPerSample) noexcept;
+
+        double phase { 0.0 };
+        double increment { -1.0 };
+        double stepRe { 1.0 };
+        double stepIm { 0.0 };
+        float rotationRe { 1.0F };
+        float rotationIm { 0.0F };
+    };
+
+    template <typename SampleType>
+    void addChannels(SampleType* const* channels, std::size_t numChannels, std::size_t numSamples, const Settings& settings) noexcept;
+    void renderTone(float* output, std::size_t numSamples, Oscillator& oscillator, float level) noexcept;
+    void renderWhite(std::size_t numSamples, float level) noexcept;
+    void renderPink(std::size_t numSamples, float level) noexcept;
+    void renderSweep(std::size_t numSamples, float level) noexcept;
+    [[nodiscard]] double clampFrequency(double frequency) const noexcept;
+
+    double sampleRate_ { 48000.0 };
+    Oscillator tone_;
+    Oscillator sweep_;
+    std::vector<Oscillator> identTones_;
+    std::array<std::uint32_t, kLanes> noiseState_ {};
+    std::array<float, 7> pinkState_ {};
+    double sweepElapsed_ { 0.0 };
+    alignas(64) std::array<float, kChunkSamples> scratch_ {};
+};
+
+} // namespace broadcastmix::audio::dsp
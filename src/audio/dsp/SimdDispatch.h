@@ -0,0 +1,80 @@
+#pragma once
+
+#include <optional>
+
+// Instruction sets the dsp kernels are built for. SSE2 and NEON are the baseline of their
+// architectures, so kernels for them are always safe to call; AVX kernels are compiled with a
+// target attribute next to the SSE2 ones and only picked when the running CPU reports AVX.
+#if defined(__x86_64__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define BROADCASTMIX_SIMD_SSE2 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define BROADCASTMIX_SIMD_AVX 1
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define BROADCASTMIX_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace broadcastmix::audio::dsp {
+
+enum class SimdLevel {
+    Scalar,
+    Sse2,
+    Avx,
+    Neon,
+};
+
+// Widest level both this build and the running CPU support.
+[[nodiscard]] inline SimdLevel detectSimdLevel() noexcept {
+#if BROADCASTMIX_SIMD_AVX
+    // Kernel tables are resolved during static initialisation, which may run before libgcc
+    // has filled in the CPU model.
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) {
+        return SimdLevel::Avx;
+    }
+#endif
+#if BROADCASTMIX_SIMD_SSE2
+    return SimdLevel::Sse2;
+#elif BROADCASTMIX_SIMD_NEON
+    return SimdLevel::Neon;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+// One kernel table per instruction set. Levels a kernel has no implementation for are left
+// empty and fall back to the next narrower one, ending at the scalar table.
+template <typename Kernels>
+struct SimdVariants {
+    Kernels scalar;
+    std::optional<Kernels> sse2 {};
+    std::optional<Kernels> avx {};
+    std::optional<Kernels> neon {};
+};
+
+template <typename Kernels>
+struct SimdSelection {
+    Kernels kernels;
+    const char* name;
+};
+
+// Meant to initialise a file-scope constant, so the audio thread only ever makes an indirect
+// call through the chosen table and never pays for CPU detection.
+template <typename Kernels>
+[[nodiscard]] SimdSelection<Kernels> selectSimdVariant(const SimdVariants<Kernels>& variants) noexcept {
+    const auto level = detectSimdLevel();
+    if (level == SimdLevel::Avx && variants.avx) {
+        return { *variants.avx, "avx" };
+    }
+    if ((level == SimdLevel::Avx || level == SimdLevel::Sse2) && variants.sse2) {
+        return { *variants.sse2, "sse2" };
+    }
+    if (level == SimdLevel::Neon && variants.neon) {
+        return { *variants.neon, "neon" };
+    }
+    return { variants.scalar, "scalar" };
+}
+
+} // namespace broadcastmix::audio::dsp
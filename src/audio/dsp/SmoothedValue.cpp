@@ -0,0 +1,81 @@
+#include "SmoothedValue.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace broadcastmix::audio::dsp {
+
+void SmoothedValue::prepare(double sampleRate, double rampMilliseconds, float initial) noexcept {
+    const auto rate = sampleRate > 0.0 ? sampleRate : 48000.0;
+    rampSamples_ = std::max<std::size_t>(1, static_cast<std::size_t>(std::lround(rampMilliseconds * 0.001 * rate)));
+    current_ = initial;
+    target_ = initial;
+    step_ = 0.0F;
+    remaining_ = 0;
+}
+
+void SmoothedValue::setTarget(float target) noexcept {
+    if (target == target_) {
+        return;
+    }
+
+    target_ = target;
+    remaining_ = rampSamples_;
+    step_ = (target_ - current_) / static_cast<float>(rampSamples_);
+}
+
+void SmoothedValue::snapToTarget() noexcept {
+    current_ = target_;
+    remaining_ = 0;
+}
+
+void SmoothedValue::skip(std::size_t numSamples) noexcept {
+    if (numSamples >= remaining_) {
+        snapToTarget();
+        return;
+    }
+
+    remaining_ -= numSamples;
+    current_ += step_ * static_cast<float>(numSamples);
+}
+
+void SmoothedValue::applyGain(float* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept {
+    applyGainTo(channels, numChannels, numSamples);
+}
+
+void SmoothedValue::applyGain(double* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept {
+    applyGainTo(channels, numChannels, numSamples);
+}
+
+template <typename SampleType>
+void SmoothedValue::applyGainTo(SampleType* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept {
+    const auto rampLength = std::min(remaining_, numSamples);
+    if (rampLength == 0 && current_ == 1.0F) {
+        return;
+    }
+
+    // Each ramp sample is computed from the block start rather than accumulated, so every
+    // channel sees identical gains and the loop vectorises. A ramp that completes in this
+    // block lands exactly on the target.
+    const auto finishes = rampLength == remaining_;
+    const auto rampEnd = finishes && rampLength > 0 ? rampLength - 1 : rampLength;
+    const auto start = static_cast<SampleType>(current_);
+    const auto step = static_cast<SampleType>(step_);
+    const auto settled = finishes ? static_cast<SampleType>(target_) : start + step * static_cast<SampleType>(rampLength);
+    for (std::size_t channel = 0; channel < numChannels; ++channel) {
+        auto* samples = channels[channel];
+        if (samples == nullptr) {
+            continue;
+        }
+        for (std::size_t index = 0; index < rampEnd; ++index) {
+            samples[index] *= start + step * static_cast<SampleType>(index + 1);
+        }
+        for (std::size_t index = rampEnd; index < numSamples; ++index) {
+            samples[index] *= settled;
+        }
+    }
+
+    skip(rampLength);
+}
+
+} // namespace broadcastmix::audio::dsp
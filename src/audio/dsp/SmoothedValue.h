@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+namespace broadcastmix::audio::dsp {
+
+// Linear per-sample ramp towards the last target. A new target restarts the ramp from
+// wherever the value currently is, so targets arriving every block still glide.
+class SmoothedValue {
+public:
+    static constexpr double kDefaultRampMilliseconds = 20.0;
+
+    void prepare(double sampleRate, double rampMilliseconds, float initial) noexcept;
+    void setTarget(float target) noexcept;
+    void snapToTarget() noexcept;
+    void skip(std::size_t numSamples) noexcept;
+
+    [[nodiscard]] float current() const noexcept { return current_; }
+    [[nodiscard]] float target() const noexcept { return target_; }
+    [[nodiscard]] bool isSmoothing() const noexcept { return remaining_ > 0; }
+
+    // Multiplies every channel by the ramp and advances it by numSamples.
+    void applyGain(float* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept;
+    void applyGain(double* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept;
+
+private:
+    template <typename SampleType>
+    void applyGainTo(SampleType* const* channels, std::size_t numChannels, std::size_t numSamples) noexcept;
+
+    float current_ { 1.0F };
+    float target_ { 1.0F };
+    float step_ { 0.0F };
+    std::size_t remaining_ { 0 };
+    std::size_t rampSamples_ { 1 };
+};
+
+} // namespace broadcastmix::audio::dsp
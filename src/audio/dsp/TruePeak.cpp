@@ -0,0 +1,121 @@
+#include "TruePeak.h"
+
+#include "SimdDispatch.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace broadcastmix::audio::dsp {
+
+namespace {
+
+constexpr std::size_t kHistory = TruePeakDetector::kTapsPerPhase - 1;
+constexpr std::size_t kChunk = 256;
+
+// BS.1770-4 Annex 2 coefficients, stored tap-major so one vector holds all four phases.
+alignas(16) constexpr float kTaps[TruePeakDetector::kTapsPerPhase][TruePeakDetector::kOversampling] = {
+    { 0.0017089843750F, -0.0291748046875F, -0.0189208984375F, -0.0083007812500F },
+    { 0.0109863281250F, 0.0292968750000F, 0.0330810546875F, 0.0148925781250F },
+    { -0.0196533203125F, -0.0517578125000F, -0.0582275390625F, -0.0266113281250F },
+    { 0.0332031250000F, 0.0891113281250F, 0.1015625000000F, 0.0476074218750F },
+    { -0.0594482421875F, -0.1665039062500F, -0.2003173828125F, -0.1022949218750F },
+    { 0.1373291015625F, 0.4650878906250F, 0.7797851562500F, 0.9721679687500F },
+    { 0.9721679687500F, 0.7797851562500F, 0.4650878906250F, 0.1373291015625F },
+    { -0.1022949218750F, -0.2003173828125F, -0.1665039062500F, -0.0594482421875F },
+    { 0.0476074218750F, 0.1015625000000F, 0.0891113281250F, 0.0332031250000F },
+    { -0.0266113281250F, -0.0582275390625F, -0.0517578125000F, -0.0196533203125F },
+    { 0.0148925781250F, 0.0330810546875F, 0.0292968750000F, 0.0109863281250F },
+    { -0.0083007812500F, -0.0189208984375F, -0.0291748046875F, 0.0017089843750F },
+};
+
+// window holds kHistory samples of history followed by numSamples new ones; tap k of the
+// output for sample n multiplies x[n - k].
+#if BROADCASTMIX_SIMD_SSE2
+float oversampledPeak(const float* window, std::size_t numSamples) noexcept {
+    const auto signMask = _mm_set1_ps(-0.0F);
+    auto peak = _mm_setzero_ps();
+    for (std::size_t index = 0; index < numSamples; ++index) {
+        const auto* newest = window + index + kHistory;
+        auto sum = _mm_mul_ps(_mm_set1_ps(newest[0]), _mm_load_ps(kTaps[0]));
+        for (std::size_t tap = 1; tap < TruePeakDetector::kTapsPerPhase; ++tap) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(*(newest - tap)), _mm_load_ps(kTaps[tap])));
+        }
+        peak = _mm_max_ps(peak, _mm_andnot_ps(signMask, sum));
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, peak);
+    return std::max({ lanes[0], lanes[1], lanes[2], lanes[3] });
+}
+#elif BROADCASTMIX_SIMD_NEON
+float oversampledPeak(const float* window, std::size_t numSamples) noexcept {
+    auto peak = vdupq_n_f32(0.0F);
+    for (std::size_t index = 0; index < numSamples; ++index) {
+        const auto* newest = window + index + kHistory;
+        auto sum = vmulq_n_f32(vld1q_f32(kTaps[0]), newest[0]);
+        for (std::size_t tap = 1; tap < TruePeakDetector::kTapsPerPhase; ++tap) {
+            sum = vfmaq_n_f32(sum, vld1q_f32(kTaps[tap]), *(newest - tap));
+        }
+        peak = vmaxq_f32(peak, vabsq_f32(sum));
+    }
+    return vmaxvq_f32(peak);
+}
+#else
+float oversampledPeak(const float* window, std::size_t numSamples) noexcept {
+    float peak = 0.0F;
+    for (std::size_t index = 0; index < numSamples; ++index) {
+        const auto* newest = window + index + kHistory;
+        for (std::size_t phase = 0; phase < TruePeakDetector::kOversampling; ++phase) {
+            float sum = 0.0F;
+            for (std::size_t tap = 0; tap < TruePeakDetector::kTapsPerPhase; ++tap) {
+                sum += kTaps[tap][phase] * *(newest - tap);
+            }
+            peak = std::max(peak, std::abs(sum));
+        }
+    }
+    return peak;
+}
+#endif
+
+} // namespace
+
+TruePeakDetector::TruePeakDetector(std::size_t numChannels)
+    : numChannels_(numChannels)
+    , history_(numChannels * kHistory, 0.0F) {}
+
+void TruePeakDetector::reset() noexcept {
+    std::fill(history_.begin(), history_.end(), 0.0F);
+}
+
+float TruePeakDetector::process(std::size_t channel, const float* samples, std::size_t numSamples) noexcept {
+    return processChannel(channel, samples, numSamples);
+}
+
+float TruePeakDetector::process(std::size_t channel, const double* samples, std::size_t numSamples) noexcept {
+    return processChannel(channel, samples, numSamples);
+}
+
+template <typename SampleType>
+float TruePeakDetector::processChannel(std::size_t channel, const SampleType* samples, std::size_t numSamples) noexcept {
+    if (channel >= numChannels_ || samples == nullptr) {
+        return 0.0F;
+    }
+
+    auto* history = history_.data() + channel * kHistory;
+    alignas(16) std::array<float, kHistory + kChunk> window;
+    float peak = 0.0F;
+    for (std::size_t offset = 0; offset < numSamples; offset += kChunk) {
+        const auto count = std::min(kChunk, numSamples - offset);
+        std::copy(history, history + kHistory, window.begin());
+        std::transform(samples + offset, samples + offset + count, window.begin() + kHistory, [](SampleType value) {
+            return static_cast<float>(value);
+        });
+        peak = std::max(peak, oversampledPeak(window.data(), count));
+        std::copy(window.begin() + static_cast<std::ptrdiff_t>(count),
+                  window.begin() + static_cast<std::ptrdiff_t>(count + kHistory),
+                  history);
+    }
+    return peak;
+}
+
+} // namespace broadcastmix::audio::dsp
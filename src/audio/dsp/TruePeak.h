@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace broadcastmix::audio::dsp {
+
+// Inter-sample peak estimate using the 4x polyphase interpolator of ITU-R BS.1770-4
+// Annex 2. Filter history is kept per channel so consecutive blocks join seamlessly.
+class TruePeakDetector {
+public:
+    static constexpr std::size_t kOversampling = 4;
+    static constexpr std::size_t kTapsPerPhase = 12;
+
+    explicit TruePeakDetector(std::size_t numChannels = 0);
+
+    void reset() noexcept;
+    [[nodiscard]] std::size_t numChannels() const noexcept { return numChannels_; }
+
+    float process(std::size_t channel, const float* samples, std::size_t numSamples) noexcept;
+    float process(std::size_t channel, const double* samples, std::size_t numSamples) noexcept;
+
+private:
+    template <typename SampleType>
+    float processChannel(std::size_t channel, const SampleType* samples, std::size_t numSamples) noexcept;
+
+    std::size_t numChannels_;
+    std::vector<float> history_;
+};
+
+} // namespace broadcastmix::audio::dsp
@@ -0,0 +1,146 @@
+#include "ChannelStripProcessor.h"
+
+#if BROADCASTMIX_HAS_JUCE
+
+#include <algorithm>
+
+namespace broadcastmix::audio::processors {
+
+ChannelStripProcessor::ChannelStripProcessor(std::shared_ptr<MeterStore::MeterValue> meter,
+                                             juce::AudioChannelSet channelSet,
+                                             std::shared_ptr<NodeTimingStore::NodeTiming> timing,
+                                             std::shared_ptr<ParameterStore::NodeParameters> parameters)
+    : juce::AudioProcessor(BusesProperties()
+                               .withInput("Input", channelSet, channelSet != juce::AudioChannelSet::disabled())
+                               .withOutput("Output", channelSet, channelSet != juce::AudioChannelSet::disabled()))
+    , channelSet_(std::move(channelSet))
+    , timing_(std::move(timing))
+    , parameters_(std::move(parameters))
+    , levelMeter_(std::move(meter), static_cast<std::size_t>(std::max(1, channelSet_.size()))) {}
+
+const juce::String ChannelStripProcessor::getName() const {
+    return "Channel Processing";
+}
+
+void ChannelStripProcessor::prepareToPlay(double sampleRate, int) {
+    strip_.setSettings(currentSettings());
+    strip_.prepare(sampleRate, static_cast<std::size_t>(std::max(1, channelSet_.size())));
+    levelMeter_.prepare(sampleRate);
+}
+
+void ChannelStripProcessor::releaseResources() {}
+
+void ChannelStripProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+    const ScopedNodeTimer timer(timing_.get());
+    midiMessages.clear();
+    process(buffer);
+}
+
+void ChannelStripProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages) {
+    const ScopedNodeTimer timer(timing_.get());
+    midiMessages.clear();
+    process(buffer);
+}
+
+bool ChannelStripProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const {
+    return layouts.getMainInputChannelSet() == channelSet_
+        && layouts.getMainOutputChannelSet() == channelSet_;
+}
+
+bool ChannelStripProcessor::acceptsMidi() const {
+    return false;
+}
+
+bool ChannelStripProcessor::producesMidi() const {
+    return false;
+}
+
+bool ChannelStripProcessor::isMidiEffect() const {
+    return false;
+}
+
+double ChannelStripProcessor::getTailLengthSeconds() const {
+    return 0.0;
+}
+
+bool ChannelStripProcessor::hasEditor() const {
+    return false;
+}
+
+juce::AudioProcessorEditor* ChannelStripProcessor::createEditor() {
+    return nullptr;
+}
+
+int ChannelStripProcessor::getNumPrograms() {
+    return 1;
+}
+
+int ChannelStripProcessor::getCurrentProgram() {
+    return 0;
+}
+
+void ChannelStripProcessor::setCurrentProgram(int) {}
+
+const juce::String ChannelStripProcessor::getProgramName(int) {
+    return "Default";
+}
+
+void ChannelStripProcessor::changeProgramName(int, const juce::String&) {}
+
+void ChannelStripProcessor::getStateInformation(juce::MemoryBlock&) {}
+
+void ChannelStripProcessor::setStateInformation(const void*, int) {}
+
+template <typename SampleType>
+void ChannelStripProcessor::process(juce::AudioBuffer<SampleType>& buffer) {
+    if (parameters_ && parameters_->isBypassed()) {
+        wasBypassed_ = true;
+        levelMeter_.clear();
+        return;
+    }
+    // Filter history from before a bypass belongs to audio that never reached the output.
+    if (wasBypassed_) {
+        strip_.reset();
+        wasBypassed_ = false;
+    }
+
+    const juce::ScopedNoDenormals noDenormals;
+    const auto numChannels = static_cast<std::size_t>(buffer.getNumChannels());
+    const auto numSamples = static_cast<std::size_t>(buffer.getNumSamples());
+    strip_.setSettings(currentSettings());
+    strip_.process(buffer.getArrayOfWritePointers(), numChannels, numSamples);
+    levelMeter_.process(buffer.getArrayOfReadPointers(), numChannels, numSamples);
+}
+
+dsp::ChannelStrip::Settings ChannelStripProcessor::currentSettings() const noexcept {
+    // Without a parameter slot every stage stays flat and the strip passes audio unchanged.
+    if (!parameters_) {
+        return {};
+    }
+
+    dsp::ChannelStrip::Settings settings;
+    settings.highPassFrequency = parameters_->load(NodeParameter::HighPassFrequency);
+    const auto firstBand = static_cast<std::uint32_t>(NodeParameter::EqLowFrequency);
+    for (std::size_t band = 0; band < dsp::ChannelStrip::kBands; ++band) {
+        const auto base = firstBand + static_cast<std::uint32_t>(band * 3);
+        settings.bands[band] = {
+            .frequency = parameters_->load(static_cast<NodeParameter>(base)),
+            .gainDecibels = parameters_->load(static_cast<NodeParameter>(base + 1)),
+            .q = parameters_->load(static_cast<NodeParameter>(base + 2)),
+        };
+    }
+    settings.gateThresholdDecibels = parameters_->load(NodeParameter::GateThreshold);
+    settings.compressorThresholdDecibels = parameters_->load(NodeParameter::CompressorThreshold);
+    settings.compressorRatio = parameters_->load(NodeParameter::CompressorRatio);
+    settings.compressorAttackMilliseconds = parameters_->load(NodeParameter::CompressorAttack);
+    settings.compressorReleaseMilliseconds = parameters_->load(NodeParameter::CompressorRelease);
+    settings.makeupDecibels = parameters_->load(NodeParameter::CompressorMakeup);
+    return settings;
+}
+
+template void ChannelStripProcessor::process<float>(juce::AudioBuffer<float>&);
+template void ChannelStripProcessor::process<double>(juce::AudioBuffer<double>&);
+
+} // namespace broadcastmix::audio::processors
+
+#endif // BROADCASTMIX_HAS_JUCE
@@ -0,0 +1,62 @@
+#pragma once
+
+#if BROADCASTMIX_HAS_JUCE
+
+#include <memory>
+
+#include "../LevelMeter.h"
+#include "../MeterStore.h"
+#include "../NodeTimingStore.h"
+#include "../ParameterStore.h"
+#include "../dsp/ChannelStrip.h"
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace broadcastmix::audio::processors {
+
+class ChannelStripProcessor : public juce::AudioProcessor {
+public:
+    ChannelStripProcessor(std::shared_ptr<MeterStore::MeterValue> meter,
+                          juce::AudioChannelSet channelSet,
+                          std::shared_ptr<NodeTimingStore::NodeTiming> timing = nullptr,
+                          std::shared_ptr<ParameterStore::NodeParameters> parameters = nullptr);
+
+    const juce::String getName() const override;
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+    bool hasEditor() const override;
+    juce::AudioProcessorEditor* createEditor() override;
+
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram(int index) override;
+    const juce::String getProgramName(int index) override;
+    void changeProgramName(int index, const juce::String& newName) override;
+
+    void getStateInformation(juce::MemoryBlock& destData) override;
+    void setStateInformation(const void* data, int sizeInBytes) override;
+
+private:
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer);
+    [[nodiscard]] dsp::ChannelStrip::Settings currentSettings() const noexcept;
+
+    juce::AudioChannelSet channelSet_;
+    std::shared_ptr<NodeTimingStore::NodeTiming> timing_;
+    std::shared_ptr<ParameterStore::NodeParameters> parameters_;
+    LevelMeter levelMeter_;
+    dsp::ChannelStrip strip_;
+    bool wasBypassed_ { false };
+};
+
+} // namespace broadcastmix::audio::processors
+
+#endif // BROADCASTMIX_HAS_JUCE
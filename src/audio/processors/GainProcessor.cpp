@@ -3,41 +3,46 @@
 #if BROADCASTMIX_HAS_JUCE
 
 #include <algorithm>
-#include <array>
 #include <cmath>
 
-namespace {
-constexpr float kDecayFactor = 0.85F;
-}
-
 namespace broadcastmix::audio::processors {
 
 GainProcessor::GainProcessor(float gainLinear,
+                             std::shared_ptr<ParameterStore::NodeParameters> parameters,
                              juce::String name,
                              std::shared_ptr<MeterStore::MeterValue> meter,
-                             juce::AudioChannelSet channelSet)
+                             juce::AudioChannelSet channelSet,
+                             std::shared_ptr<NodeTimingStore::NodeTiming> timing)
     : juce::AudioProcessor(BusesProperties()
                                .withInput("Input", channelSet, channelSet != juce::AudioChannelSet::disabled())
                                .withOutput("Output", channelSet, channelSet != juce::AudioChannelSet::disabled()))
     , name_(std::move(name))
     , gainLinear_(gainLinear)
-    , meter_(std::move(meter))
-    , channelSet_(std::move(channelSet)) {}
+    , parameters_(std::move(parameters))
+    , channelSet_(std::move(channelSet))
+    , timing_(std::move(timing))
+    , levelMeter_(std::move(meter), static_cast<std::size_t>(std::max(1, channelSet_.size()))) {}
 
 const juce::String GainProcessor::getName() const {
     return name_;
 }
 
-void GainProcessor::prepareToPlay(double, int) {}
+void GainProcessor::prepareToPlay(double sampleRate, int) {
+    // Start at the current value so a rebuilt graph does not ramp in from unity.
+    gain_.prepare(sampleRate, dsp::SmoothedValue::kDefaultRampMilliseconds, targetGain());
+    levelMeter_.prepare(sampleRate);
+}
 
 void GainProcessor::releaseResources() {}
 
 void GainProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+    const ScopedNodeTimer timer(timing_.get());
     midiMessages.clear();
     applyGain(buffer);
 }
 
 void GainProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages) {
+    const ScopedNodeTimer timer(timing_.get());
     midiMessages.clear();
     applyGain(buffer);
 }
@@ -91,45 +96,42 @@ void GainProcessor::getStateInformation(juce::MemoryBlock&) {}
 
 void GainProcessor::setStateInformation(const void*, int) {}
 
-template <typename SampleType>
-void GainProcessor::applyGain(juce::AudioBuffer<SampleType>& buffer) {
-    buffer.applyGain(static_cast<SampleType>(gainLinear_));
-    const auto peaks = computePeaks(buffer);
-    updateMeter(peaks);
-}
-
-template <typename SampleType>
-std::array<float, 2> GainProcessor::computePeaks(const juce::AudioBuffer<SampleType>& buffer) const {
-    std::array<float, 2> peaks { 0.0F, 0.0F };
-    const auto channels = std::min(buffer.getNumChannels(), 2);
-    const auto samples = buffer.getNumSamples();
-    for (int channel = 0; channel < channels; ++channel) {
-        SampleType peak { 0 };
-        const auto* data = buffer.getReadPointer(channel);
-        for (int sample = 0; sample < samples; ++sample) {
-            peak = std::max(peak, static_cast<SampleType>(std::abs(data[sample])));
-        }
-        peaks[static_cast<std::size_t>(channel)] = std::clamp(static_cast<float>(peak), 0.0F, 1.0F);
+float GainProcessor::targetGain() const noexcept {
+    if (!parameters_) {
+        return gainLinear_;
+    }
+    if (parameters_->isBypassed()) {
+        return 1.0F;
     }
-    return peaks;
+    // Muting ramps to silence through the same smoother, so it never clicks.
+    return parameters_->load(NodeParameter::Mute) != 0.0F ? 0.0F : parameters_->load(NodeParameter::Gain);
 }
 
-void GainProcessor::updateMeter(const std::array<float, 2>& peaks) const {
-    if (!meter_) {
+template <typename SampleType>
+void GainProcessor::applyGain(juce::AudioBuffer<SampleType>& buffer) {
+    gain_.setTarget(targetGain());
+    // Bypass glides to unity first; once there the block is left untouched.
+    if (parameters_ && parameters_->isBypassed() && !gain_.isSmoothing()) {
+        levelMeter_.clear();
         return;
     }
+    gain_.applyGain(buffer.getArrayOfWritePointers(),
+                    static_cast<std::size_t>(buffer.getNumChannels()),
+                    static_cast<std::size_t>(buffer.getNumSamples()));
+    updateMeter(buffer);
+}
 
-    for (std::size_t channel = 0; channel < peaks.size(); ++channel) {
-        const auto current = meter_->channels[channel].load(std::memory_order_relaxed);
-        const auto decayed = current * kDecayFactor;
-        meter_->channels[channel].store(std::max(peaks[channel], decayed), std::memory_order_relaxed);
-    }
+template <typename SampleType>
+void GainProcessor::updateMeter(const juce::AudioBuffer<SampleType>& buffer) {
+    levelMeter_.process(buffer.getArrayOfReadPointers(),
+                        static_cast<std::size_t>(buffer.getNumChannels()),
+                        static_cast<std::size_t>(buffer.getNumSamples()));
 }
 
 template void GainProcessor::applyGain<float>(juce::AudioBuffer<float>&);
 template void GainProcessor::applyGain<double>(juce::AudioBuffer<double>&);
-template std::array<float, 2> GainProcessor::computePeaks<float>(const juce::AudioBuffer<float>&) const;
-template std::array<float, 2> GainProcessor::computePeaks<double>(const juce::AudioBuffer<double>&) const;
+template void GainProcessor::updateMeter<float>(const juce::AudioBuffer<float>&);
+template void GainProcessor::updateMeter<double>(const juce::AudioBuffer<double>&);
 
 } // namespace broadcastmix::audio::processors
 
@@ -4,7 +4,11 @@
 
 #include <memory>
 
+#include "../LevelMeter.h"
 #include "../MeterStore.h"
+#include "../NodeTimingStore.h"
+#include "../ParameterStore.h"
+#include "../dsp/SmoothedValue.h"
 #include <juce_audio_processors/juce_audio_processors.h>
 
 namespace broadcastmix::audio::processors {
@@ -12,9 +16,11 @@ namespace broadcastmix::audio::processors {
 class GainProcessor : public juce::AudioProcessor {
 public:
     GainProcessor(float gainLinear,
+                  std::shared_ptr<ParameterStore::NodeParameters> parameters,
                   juce::String name,
                   std::shared_ptr<MeterStore::MeterValue> meter,
-                  juce::AudioChannelSet channelSet);
+                  juce::AudioChannelSet channelSet,
+                  std::shared_ptr<NodeTimingStore::NodeTiming> timing = nullptr);
 
     const juce::String getName() const override;
 
@@ -41,16 +47,19 @@ public:
     void setStateInformation(const void* data, int sizeInBytes) override;
 
 private:
+    [[nodiscard]] float targetGain() const noexcept;
     template <typename SampleType>
     void applyGain(juce::AudioBuffer<SampleType>& buffer);
     template <typename SampleType>
-    std::array<float, 2> computePeaks(const juce::AudioBuffer<SampleType>& buffer) const;
-    void updateMeter(const std::array<float, 2>& peaks) const;
+    void updateMeter(const juce::AudioBuffer<SampleType>& buffer);
 
     juce::String name_;
     float gainLinear_;
-    std::shared_ptr<MeterStore::MeterValue> meter_;
+    std::shared_ptr<ParameterStore::NodeParameters> parameters_;
+    dsp::SmoothedValue gain_;
     juce::AudioChannelSet channelSet_;
+    std::shared_ptr<NodeTimingStore::NodeTiming> timing_;
+    LevelMeter levelMeter_;
 };
 
 } // namespace broadcastmix::audio::processors
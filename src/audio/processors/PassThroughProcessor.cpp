@@ -3,38 +3,41 @@
 #if BROADCASTMIX_HAS_JUCE
 
 #include <algorithm>
-#include <array>
 #include <cmath>
 
-namespace {
-constexpr float kDecayFactor = 0.85F;
-}
-
 namespace broadcastmix::audio::processors {
 
 PassThroughProcessor::PassThroughProcessor(juce::String name,
                                            std::shared_ptr<MeterStore::MeterValue> meter,
-                                           juce::AudioChannelSet channelSet)
+                                           juce::AudioChannelSet channelSet,
+                                           std::shared_ptr<NodeTimingStore::NodeTiming> timing,
+                                           std::shared_ptr<ParameterStore::NodeParameters> parameters)
     : juce::AudioProcessor(BusesProperties()
                                .withInput("Input", channelSet, channelSet != juce::AudioChannelSet::disabled())
                                .withOutput("Output", channelSet, channelSet != juce::AudioChannelSet::disabled()))
     , name_(std::move(name))
-    , meter_(std::move(meter)) {}
+    , timing_(std::move(timing))
+    , parameters_(std::move(parameters))
+    , levelMeter_(std::move(meter), static_cast<std::size_t>(std::max(1, channelSet.size()))) {}
 
 const juce::String PassThroughProcessor::getName() const {
     return name_;
 }
 
-void PassThroughProcessor::prepareToPlay(double, int) {}
+void PassThroughProcessor::prepareToPlay(double sampleRate, int) {
+    levelMeter_.prepare(sampleRate);
+}
 
 void PassThroughProcessor::releaseResources() {}
 
 void PassThroughProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+    const ScopedNodeTimer timer(timing_.get());
     midiMessages.clear();
     updateMeterFromBuffer(buffer);
 }
 
 void PassThroughProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages) {
+    const ScopedNodeTimer timer(timing_.get());
     midiMessages.clear();
     updateMeterFromBuffer(buffer);
 }
@@ -89,27 +92,13 @@ void PassThroughProcessor::setStateInformation(const void*, int) {}
 
 template <typename SampleType>
 void PassThroughProcessor::updateMeterFromBuffer(const juce::AudioBuffer<SampleType>& buffer) {
-    if (!meter_) {
+    if (parameters_ && parameters_->isBypassed()) {
+        levelMeter_.clear();
         return;
     }
-
-    std::array<float, 2> peaks { 0.0F, 0.0F };
-    const auto channels = std::min(buffer.getNumChannels(), 2);
-    const auto samples = buffer.getNumSamples();
-    for (int channel = 0; channel < channels; ++channel) {
-        SampleType peak { 0 };
-        const auto* data = buffer.getReadPointer(channel);
-        for (int sample = 0; sample < samples; ++sample) {
-            peak = std::max(peak, static_cast<SampleType>(std::abs(data[sample])));
-        }
-        peaks[static_cast<std::size_t>(channel)] = std::clamp(static_cast<float>(peak), 0.0F, 1.0F);
-    }
-
-    for (std::size_t channel = 0; channel < peaks.size(); ++channel) {
-        const auto current = meter_->channels[channel].load(std::memory_order_relaxed);
-        const auto decayed = current * kDecayFactor;
-        meter_->channels[channel].store(std::max(peaks[channel], decayed), std::memory_order_relaxed);
-    }
+    levelMeter_.process(buffer.getArrayOfReadPointers(),
+                        static_cast<std::size_t>(buffer.getNumChannels()),
+                        static_cast<std::size_t>(buffer.getNumSamples()));
 }
 
 template void PassThroughProcessor::updateMeterFromBuffer<float>(const juce::AudioBuffer<float>&);
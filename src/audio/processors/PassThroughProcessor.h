@@ -4,7 +4,10 @@
 
 #include <memory>
 
+#include "../LevelMeter.h"
 #include "../MeterStore.h"
+#include "../NodeTimingStore.h"
+#include "../ParameterStore.h"
 #include <juce_audio_processors/juce_audio_processors.h>
 
 namespace broadcastmix::audio::processors {
@@ -13,7 +16,9 @@ class PassThroughProcessor : public juce::AudioProcessor {
 public:
     PassThroughProcessor(juce::String name,
                          std::shared_ptr<MeterStore::MeterValue> meter,
-                         juce::AudioChannelSet channelSet = juce::AudioChannelSet::stereo());
+                         juce::AudioChannelSet channelSet = juce::AudioChannelSet::stereo(),
+                         std::shared_ptr<NodeTimingStore::NodeTiming> timing = nullptr,
+                         std::shared_ptr<ParameterStore::NodeParameters> parameters = nullptr);
 
     const juce::String getName() const override;
 
@@ -44,7 +49,9 @@ private:
     void updateMeterFromBuffer(const juce::AudioBuffer<SampleType>& buffer);
 
     juce::String name_;
-    std::shared_ptr<MeterStore::MeterValue> meter_;
+    std::shared_ptr<NodeTimingStore::NodeTiming> timing_;
+    std::shared_ptr<ParameterStore::NodeParameters> parameters_;
+    LevelMeter levelMeter_;
 };
 
 } // namespace broadcastmix::audio::processors
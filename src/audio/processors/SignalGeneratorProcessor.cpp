@@ -3,44 +3,40 @@
 #if BROADCASTMIX_HAS_JUCE
 
 #include <algorithm>
-#include <array>
-#include <cmath>
-
-namespace {
-constexpr double kTwoPi = 6.283185307179586476925286766559;
-constexpr double kTargetFrequencyHz = 1000.0;
-constexpr float kAmplitude = 1.0F; // 0 dBFS
-constexpr float kDecayFactor = 0.85F;
-} // namespace
 
 namespace broadcastmix::audio::processors {
 
 SignalGeneratorProcessor::SignalGeneratorProcessor(std::shared_ptr<MeterStore::MeterValue> meter,
-                                                   juce::AudioChannelSet channelSet)
+                                                   juce::AudioChannelSet channelSet,
+                                                   std::shared_ptr<NodeTimingStore::NodeTiming> timing,
+                                                   std::shared_ptr<ParameterStore::NodeParameters> parameters)
     : juce::AudioProcessor(BusesProperties()
                                .withInput("Input", channelSet, channelSet != juce::AudioChannelSet::disabled())
                                .withOutput("Output", channelSet, true))
-    , meter_(std::move(meter))
-    , channelSet_(std::move(channelSet)) {}
+    , channelSet_(std::move(channelSet))
+    , timing_(std::move(timing))
+    , parameters_(std::move(parameters))
+    , levelMeter_(std::move(meter), static_cast<std::size_t>(std::max(1, channelSet_.size()))) {}
 
 const juce::String SignalGeneratorProcessor::getName() const {
     return "Signal Generator";
 }
 
 void SignalGeneratorProcessor::prepareToPlay(double sampleRate, int) {
-    sampleRate_ = sampleRate > 0.0 ? sampleRate : 48000.0;
-    phase_ = 0.0;
-    phaseIncrement_ = kTwoPi * kTargetFrequencyHz / sampleRate_;
+    generator_.prepare(sampleRate, static_cast<std::size_t>(std::max(1, channelSet_.size())));
+    levelMeter_.prepare(sampleRate);
 }
 
 void SignalGeneratorProcessor::releaseResources() {}
 
 void SignalGeneratorProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+    const ScopedNodeTimer timer(timing_.get());
     midiMessages.clear();
     process(buffer);
 }
 
 void SignalGeneratorProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages) {
+    const ScopedNodeTimer timer(timing_.get());
     midiMessages.clear();
     process(buffer);
 }
@@ -101,89 +97,48 @@ void SignalGeneratorProcessor::setStateInformation(const void*, int) {}
 
 template <typename SampleType>
 void SignalGeneratorProcessor::process(juce::AudioBuffer<SampleType>& buffer) {
-    auto output = getBusBuffer(buffer, false, 0);
-    const auto numSamples = output.getNumSamples();
-    const auto numOutputChannels = output.getNumChannels();
-
-    juce::AudioBuffer<SampleType> input;
-    bool hasInput = false;
-    if (getBusCount(true) > 0) {
-        const auto layout = getBusesLayout();
-        if (layout.getMainInputChannelSet() != juce::AudioChannelSet::disabled()) {
-            input = getBusBuffer(buffer, true, 0);
-            hasInput = input.getNumChannels() > 0;
-        }
-    }
-
-    if (hasInput) {
-        const bool sharesBuffer =
-            input.getNumChannels() > 0 && output.getNumChannels() > 0 &&
-            input.getWritePointer(0) == output.getWritePointer(0);
-
-        if (!sharesBuffer) {
-            const auto copyChannels = std::min(input.getNumChannels(), numOutputChannels);
-            for (int channel = 0; channel < copyChannels; ++channel) {
-                output.copyFrom(channel, 0, input, channel, 0, numSamples);
-            }
-            for (int channel = copyChannels; channel < numOutputChannels; ++channel) {
-                output.clear(channel, 0, numSamples);
-            }
-        }
-    } else {
-        output.clear();
-    }
-
-    addGeneratedSamples(output);
-
-    std::array<float, 2> peaks { 0.0F, 0.0F };
-    const auto limitedChannels = std::min(output.getNumChannels(), 2);
-    for (int channel = 0; channel < limitedChannels; ++channel) {
-        SampleType peak { 0 };
-        const auto* channelData = output.getReadPointer(channel);
-        for (int sample = 0; sample < numSamples; ++sample) {
-            peak = std::max(peak, static_cast<SampleType>(std::abs(channelData[sample])));
-        }
-        peaks[static_cast<std::size_t>(channel)] = std::clamp(static_cast<float>(peak), 0.0F, 1.0F);
+    // Bypassed: whatever was routed in passes through unchanged and no tone is added.
+    if (parameters_ && parameters_->isBypassed()) {
+        levelMeter_.clear();
+        return;
     }
 
-    updateMeter(peaks);
-}
-
-template <typename SampleType>
-void SignalGeneratorProcessor::addGeneratedSamples(juce::AudioBuffer<SampleType>& buffer) {
-    const auto numChannels = buffer.getNumChannels();
+    // Works on the block's own channel pointers: getBusBuffer views allocate once a bus
+    // has more channels than juce::AudioBuffer keeps inline.
     const auto numSamples = buffer.getNumSamples();
-
-    for (int sample = 0; sample < numSamples; ++sample) {
-        const auto value = static_cast<SampleType>(std::sin(phase_) * kAmplitude);
-        for (int channel = 0; channel < numChannels; ++channel) {
-            buffer.addSample(channel, sample, value);
-        }
-
-        phase_ += phaseIncrement_;
-        if (phase_ >= kTwoPi) {
-            phase_ -= kTwoPi;
-        }
+    const auto firstOutput = getChannelIndexInProcessBlockBuffer(false, 0, 0);
+    const auto numOutputChannels = std::max(0, std::min(getChannelCountOfBus(false, 0), buffer.getNumChannels() - firstOutput));
+    auto* const* outputs = buffer.getArrayOfWritePointers() + firstOutput;
+
+    // The main input shares the block with the main output, so routed signal is already in
+    // place; only channels the input bus does not cover start from silence.
+    const auto numInputChannels = getBusCount(true) > 0 ? getChannelCountOfBus(true, 0) : 0;
+    for (int channel = std::max(0, numInputChannels); channel < numOutputChannels; ++channel) {
+        juce::FloatVectorOperations::clear(outputs[channel], numSamples);
     }
-}
 
-void SignalGeneratorProcessor::updateMeter(const std::array<float, 2>& peaks) {
-    if (!meter_) {
-        return;
-    }
+    generator_.add(outputs,
+                   static_cast<std::size_t>(numOutputChannels),
+                   static_cast<std::size_t>(numSamples),
+                   currentSettings());
+    levelMeter_.process(outputs, static_cast<std::size_t>(numOutputChannels), static_cast<std::size_t>(numSamples));
+}
 
-    for (std::size_t channel = 0; channel < peaks.size(); ++channel) {
-        const auto current = meter_->channels[channel].load(std::memory_order_relaxed);
-        const auto decayed = current * kDecayFactor;
-        const auto next = std::max(peaks[channel], decayed);
-        meter_->channels[channel].store(next, std::memory_order_relaxed);
+dsp::SignalGenerator::Settings SignalGeneratorProcessor::currentSettings() const noexcept {
+    // Without a parameter slot the generator keeps its original 1 kHz tone at 0 dBFS.
+    if (!parameters_) {
+        return {};
     }
+    const auto signal = std::clamp(parameters_->load(NodeParameter::Signal), 0.0F, static_cast<float>(kGeneratorSignalCount - 1));
+    return {
+        .signal = static_cast<GeneratorSignal>(static_cast<std::uint32_t>(signal)),
+        .frequency = static_cast<double>(parameters_->load(NodeParameter::Frequency)),
+        .level = parameters_->load(NodeParameter::Gain),
+    };
 }
 
 template void SignalGeneratorProcessor::process<float>(juce::AudioBuffer<float>&);
 template void SignalGeneratorProcessor::process<double>(juce::AudioBuffer<double>&);
-template void SignalGeneratorProcessor::addGeneratedSamples<float>(juce::AudioBuffer<float>&);
-template void SignalGeneratorProcessor::addGeneratedSamples<double>(juce::AudioBuffer<double>&);
 
 } // namespace broadcastmix::audio::processors
 
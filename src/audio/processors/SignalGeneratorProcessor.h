@@ -4,15 +4,21 @@
 
 #include <memory>
 
+#include "../LevelMeter.h"
 #include "../MeterStore.h"
+#include "../NodeTimingStore.h"
+#include "../ParameterStore.h"
+#include "../dsp/SignalGenerator.h"
 #include <juce_audio_processors/juce_audio_processors.h>
 
 namespace broadcastmix::audio::processors {
 
 class SignalGeneratorProcessor : public juce::AudioProcessor {
 public:
-    explicit SignalGeneratorProcessor(std::shared_ptr<MeterStore::MeterValue> meter,
-                                      juce::AudioChannelSet channelSet);
+    SignalGeneratorProcessor(std::shared_ptr<MeterStore::MeterValue> meter,
+                             juce::AudioChannelSet channelSet,
+                             std::shared_ptr<NodeTimingStore::NodeTiming> timing = nullptr,
+                             std::shared_ptr<ParameterStore::NodeParameters> parameters = nullptr);
 
     const juce::String getName() const override;
 
@@ -41,17 +47,13 @@ public:
 private:
     template <typename SampleType>
     void process(juce::AudioBuffer<SampleType>& buffer);
+    [[nodiscard]] dsp::SignalGenerator::Settings currentSettings() const noexcept;
 
-    template <typename SampleType>
-    void addGeneratedSamples(juce::AudioBuffer<SampleType>& buffer);
-
-    void updateMeter(const std::array<float, 2>& peaks);
-
-    std::shared_ptr<MeterStore::MeterValue> meter_;
     juce::AudioChannelSet channelSet_;
-    double sampleRate_ { 48000.0 };
-    double phase_ { 0.0 };
-    double phaseIncrement_ { 0.0 };
+    std::shared_ptr<NodeTimingStore::NodeTiming> timing_;
+    std::shared_ptr<ParameterStore::NodeParameters> parameters_;
+    LevelMeter levelMeter_;
+    dsp::SignalGenerator generator_;
 };
 
 } // namespace broadcastmix::audio::processors
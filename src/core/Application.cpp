@@ -2,14 +2,19 @@
 
 #include "Logging.h"
 
+#include "../audio/RenderPlan.h"
+
 #include <algorithm>
 #include <array>
 #include <cctype>
+#include <cmath>
+#include <filesystem>
 #include <map>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <iostream>
+#include <limits>
 
 #include <juce_core/juce_core.h>
 
@@ -46,6 +51,19 @@ std::string trimCopy(std::string text) {
     return text;
 }
 
+// Whole-node patches spread a mono end across every channel of the other end (or fold the
+// other end down into it); port-level patches stay on the channels they name.
+bool joinsMonoToMultichannel(const broadcastmix::audio::GraphTopology& topology, const std::string& fromId, const std::string& toId) {
+    const auto fromNode = topology.findNode(fromId);
+    const auto toNode = topology.findNode(toId);
+    if (!fromNode || !toNode) {
+        return false;
+    }
+    const auto fromMono = broadcastmix::audio::RenderPlan::processingChannelCount(*fromNode) == 1;
+    const auto toMono = broadcastmix::audio::RenderPlan::processingChannelCount(*toNode) == 1;
+    return fromMono != toMono;
+}
+
 std::string generateUuid() {
     return juce::Uuid().toString().toStdString();
 }
@@ -85,6 +103,7 @@ void Application::loadProject(const std::string& path) {
         currentProject_ = project;
         currentProjectPath_ = path;
         projectLoaded_ = true;
+        audioEngine_.setDiagnosticsDirectory((std::filesystem::path(path) / "logs").string());
 
         applyMacroLayout();
         applyAudioTopology();
@@ -95,6 +114,7 @@ void Application::loadProject(const std::string& path) {
         currentProject_ = std::move(project);
         currentProjectPath_ = path;
         projectLoaded_ = true;
+        audioEngine_.setDiagnosticsDirectory((std::filesystem::path(path) / "logs").string());
     }
 }
 
@@ -192,19 +212,119 @@ void Application::updateMicroNodePosition(const std::string& viewId, const std::
     }
 }
 
-std::array<float, 2> Application::meterLevelForNode(const std::string& nodeId) const {
+const std::string& Application::audioNodeId(const std::string& nodeId) const {
     if (const auto it = meterAliases_.find(nodeId); it != meterAliases_.end()) {
-        return audioEngine_.meterLevelsForNode(it->second);
+        return it->second;
     }
-    return audioEngine_.meterLevelsForNode(nodeId);
+    return nodeId;
+}
+
+audio::MeterHandle Application::meterHandleForNode(const std::string& nodeId) const {
+    return audioEngine_.meterHandleForNode(audioNodeId(nodeId));
 }
 
-std::array<float, 2> Application::meterLevelForMicroNode(const std::string& viewId, const std::string& nodeId) const {
+audio::MeterHandle Application::meterHandleForMicroNode(const std::string& viewId, const std::string& nodeId) const {
     (void) viewId;
-    if (const auto it = meterAliases_.find(nodeId); it != meterAliases_.end()) {
-        return audioEngine_.meterLevelsForNode(it->second);
+    return audioEngine_.meterHandleForNode(audioNodeId(nodeId));
+}
+
+std::uint64_t Application::meterLayoutVersion() const {
+    // Aliases are rebuilt with the audio topology, so the topology version covers them.
+    return audioEngine_.meterLayoutVersion() + audioEngine_.topologyVersion();
+}
+
+void Application::readMeters(audio::MeterSnapshot& snapshot) const {
+    audioEngine_.readMeters(snapshot);
+}
+
+bool Application::setNodeGain(const std::string& nodeId, float gainDecibels) {
+    // Reaches the node's parameter slot through the engine's command queue; the graph is left untouched.
+    const auto gain = gainDecibels <= -100.0F ? 0.0F : std::pow(10.0F, gainDecibels / 20.0F);
+    return audioEngine_.setNodeParameter(audioNodeId(nodeId), audio::NodeParameter::Gain, gain);
+}
+
+std::optional<float> Application::nodeGain(const std::string& nodeId) const {
+    const auto gain = audioEngine_.nodeParameter(audioNodeId(nodeId), audio::NodeParameter::Gain);
+    if (!gain) {
+        return std::nullopt;
     }
-    return audioEngine_.meterLevelsForNode(nodeId);
+    return *gain > 0.0F ? 20.0F * std::log10(*gain) : -std::numeric_limits<float>::infinity();
+}
+
+bool Application::setNodeMuted(const std::string& nodeId, bool muted) {
+    return audioEngine_.setNodeParameter(audioNodeId(nodeId), audio::NodeParameter::Mute, muted ? 1.0F : 0.0F);
+}
+
+bool Application::setGeneratorSignal(const std::string& nodeId, audio::GeneratorSignal signal) {
+    return audioEngine_.setNodeParameter(audioNodeId(nodeId), audio::NodeParameter::Signal, static_cast<float>(signal));
+}
+
+bool Application::setGeneratorFrequency(const std::string& nodeId, float frequencyHz) {
+    if (!(frequencyHz > 0.0F)) {
+        return false;
+    }
+    return audioEngine_.setNodeParameter(audioNodeId(nodeId), audio::NodeParameter::Frequency, frequencyHz);
+}
+
+bool Application::setChannelStripParameter(const std::string& nodeId, audio::NodeParameter parameter, float value) {
+    if (parameter < audio::NodeParameter::HighPassFrequency) {
+        return false;
+    }
+    return audioEngine_.setNodeParameter(audioNodeId(nodeId), parameter, value);
+}
+
+void Application::resetMeters() {
+    audioEngine_.resetMeters();
+}
+
+bool Application::captureSnapshot(const std::string& name) {
+    const auto trimmed = trimCopy(name);
+    if (trimmed.empty()) {
+        return false;
+    }
+
+    auto snapshot = audioEngine_.captureSnapshot(trimmed);
+    auto& snapshots = currentProject_.snapshots;
+    auto it = std::find_if(snapshots.begin(), snapshots.end(), [&](const auto& existing) {
+        return existing.name == trimmed;
+    });
+    if (it != snapshots.end()) {
+        *it = std::move(snapshot);
+    } else {
+        it = snapshots.insert(snapshots.end(), std::move(snapshot));
+    }
+    if (std::find(currentProject_.snapshotNames.begin(), currentProject_.snapshotNames.end(), trimmed) == currentProject_.snapshotNames.end()) {
+        currentProject_.snapshotNames.push_back(trimmed);
+    }
+    if (projectLoaded_ && currentProjectPath_) {
+        projectSerializer_.saveSnapshot(*it, *currentProjectPath_);
+    }
+    saveProject();
+    return true;
+}
+
+bool Application::recallSnapshot(const std::string& name, audio::SnapshotGlide glide) {
+    const auto it = std::find_if(currentProject_.snapshots.begin(), currentProject_.snapshots.end(), [&](const auto& snapshot) {
+        return snapshot.name == name;
+    });
+    if (it == currentProject_.snapshots.end()) {
+        log(LogCategory::Ui, "recallSnapshot aborted: snapshot {} has no stored parameters", name);
+        return false;
+    }
+    return audioEngine_.recallSnapshot(*it, glide);
+}
+
+bool Application::setNodeRecallSafe(const std::string& nodeId, bool safe) {
+    auto& safeNodes = currentProject_.recallSafeNodes;
+    const auto it = std::find(safeNodes.begin(), safeNodes.end(), nodeId);
+    if (safe && it == safeNodes.end()) {
+        safeNodes.push_back(nodeId);
+    } else if (!safe && it != safeNodes.end()) {
+        safeNodes.erase(it);
+    }
+    const auto applied = audioEngine_.setNodeRecallSafe(audioNodeId(nodeId), safe);
+    saveProject();
+    return applied;
 }
 
 const std::unordered_map<std::string, persistence::LayoutPosition>& Application::macroLayout() const noexcept {
@@ -329,7 +449,9 @@ bool Application::deleteNode(const std::string& nodeId) {
                 .fromNodeId = incoming.fromNodeId,
                 .fromChannel = incoming.fromChannel,
                 .toNodeId = outgoing.toNodeId,
-                .toChannel = outgoing.toChannel
+                .toChannel = outgoing.toChannel,
+                .fanOut = incoming.fanOut || outgoing.fanOut
+                    || joinsMonoToMultichannel(*topology, incoming.fromNodeId, outgoing.toNodeId)
             });
         }
     }
@@ -377,13 +499,15 @@ bool Application::connectNodes(const std::string& fromId, const std::string& toI
     }
 
     bool updated = false;
+    const auto fanOut = joinsMonoToMultichannel(*currentProject_.graphTopology, fromId, toId);
     for (std::uint32_t channel = 0; channel < 2; ++channel) {
         if (!currentProject_.graphTopology->connectionExists(fromId, toId, channel, channel)) {
             currentProject_.graphTopology->connect(audio::GraphConnection {
                 .fromNodeId = fromId,
                 .fromChannel = channel,
                 .toNodeId = toId,
-                .toChannel = channel
+                .toChannel = channel,
+                .fanOut = fanOut
             });
             updated = true;
         }
@@ -1055,22 +1179,26 @@ bool Application::rewireForInsertion(audio::GraphTopology& topology,
     bool upstreamConnected = false;
     bool downstreamConnected = false;
 
+    const auto upstreamFanOut = joinsMonoToMultichannel(topology, fromId, newNodeId);
     for (std::uint32_t channel = 0; channel < upstreamChannels; ++channel) {
         topology.connect(audio::GraphConnection {
             .fromNodeId = fromId,
             .fromChannel = channel,
             .toNodeId = newNodeId,
-            .toChannel = channel
+            .toChannel = channel,
+            .fanOut = upstreamFanOut
         });
         upstreamConnected = true;
     }
 
+    const auto downstreamFanOut = joinsMonoToMultichannel(topology, newNodeId, toId);
     for (std::uint32_t channel = 0; channel < downstreamChannels; ++channel) {
         topology.connect(audio::GraphConnection {
             .fromNodeId = newNodeId,
             .fromChannel = channel,
             .toNodeId = toId,
-            .toChannel = channel
+            .toChannel = channel,
+            .fanOut = downstreamFanOut
         });
         downstreamConnected = true;
     }
@@ -1288,33 +1416,19 @@ std::shared_ptr<audio::GraphTopology> Application::buildAudioTopology() const {
             auto fromId = mapId(connection.fromNodeId);
             auto toId = mapId(connection.toNodeId);
 
-            const auto fromNode = composite->findNode(fromId);
-            const auto toNode = composite->findNode(toId);
-            const auto fromChannels = fromNode ? std::max<std::uint32_t>(1U, fromNode->outputChannelCount()) : 1U;
-            const auto toChannels = toNode ? std::max<std::uint32_t>(1U, toNode->inputChannelCount()) : 1U;
-
-            const auto addConnection = [&](std::uint32_t fromChannel, std::uint32_t toChannel) {
-                if (!composite->connectionExists(fromId, toId, fromChannel, toChannel)) {
-                    composite->connect(audio::GraphConnection {
-                        .fromNodeId = fromId,
-                        .fromChannel = fromChannel,
-                        .toNodeId = toId,
-                        .toChannel = toChannel
-                    });
-                }
+            // The view's input and output take the macro node's width here, so wiring drawn against
+            // them spreads across (or folds down from) however many channels that turns out to be.
+            const auto isBoundary = [&](const std::string& id) {
+                const auto inIt = microInputNodes.find(macroId);
+                const auto outIt = microOutputNodes.find(macroId);
+                return (inIt != microInputNodes.end() && inIt->second == id)
+                    || (outIt != microOutputNodes.end() && outIt->second == id);
             };
-
-            addConnection(connection.fromChannel, connection.toChannel);
-
-            if (fromChannels == 1 && toChannels > 1) {
-                for (std::uint32_t channel = 0; channel < toChannels; ++channel) {
-                    addConnection(connection.fromChannel, channel);
-                }
-            } else if (fromChannels > 1 && toChannels == 1) {
-                for (std::uint32_t channel = 0; channel < fromChannels; ++channel) {
-                    addConnection(channel, connection.toChannel);
-                }
-            }
+            auto mapped = connection;
+            mapped.fanOut = connection.fanOut || isBoundary(fromId) || isBoundary(toId);
+            mapped.fromNodeId = std::move(fromId);
+            mapped.toNodeId = std::move(toId);
+            composite->connect(std::move(mapped));
         }
     }
 
@@ -1329,33 +1443,10 @@ std::shared_ptr<audio::GraphTopology> Application::buildAudioTopology() const {
             toId = inIt->second;
         }
 
-        const auto addConnection = [&](std::uint32_t fromChannel, std::uint32_t toChannel) {
-            if (!composite->connectionExists(fromId, toId, fromChannel, toChannel)) {
-                composite->connect(audio::GraphConnection {
-                    .fromNodeId = fromId,
-                    .fromChannel = fromChannel,
-                    .toNodeId = toId,
-                    .toChannel = toChannel
-                });
-            }
-        };
-
-        addConnection(connection.fromChannel, connection.toChannel);
-
-        const auto fromNode = composite->findNode(fromId);
-        const auto toNode = composite->findNode(toId);
-        const auto fromChannels = fromNode ? std::max<std::uint32_t>(1U, fromNode->outputChannelCount()) : 1U;
-        const auto toChannels = toNode ? std::max<std::uint32_t>(1U, toNode->inputChannelCount()) : 1U;
-
-        if (fromChannels == 1 && toChannels > 1) {
-            for (std::uint32_t channel = 0; channel < toChannels; ++channel) {
-                addConnection(connection.fromChannel, channel);
-            }
-        } else if (fromChannels > 1 && toChannels == 1) {
-            for (std::uint32_t channel = 0; channel < fromChannels; ++channel) {
-                addConnection(channel, connection.toChannel);
-            }
-        }
+        auto mapped = connection;
+        mapped.fromNodeId = std::move(fromId);
+        mapped.toNodeId = std::move(toId);
+        composite->connect(std::move(mapped));
     }
 
     for (const auto& [macroId, microOutputId] : microOutputNodes) {
@@ -1385,6 +1476,9 @@ std::shared_ptr<audio::GraphTopology> Application::buildAudioTopology() const {
 
 void Application::applyAudioTopology() {
     audioEngine_.setTopology(buildAudioTopology());
+    for (const auto& nodeId : currentProject_.recallSafeNodes) {
+        audioEngine_.setNodeRecallSafe(audioNodeId(nodeId), true);
+    }
 }
 
 bool Application::createNode(NodeTemplate type,
@@ -56,8 +56,20 @@ public:
     [[nodiscard]] MicroViewDescriptor microViewDescriptor(const std::string& viewId);
     void updateMacroNodePosition(const std::string& nodeId, float normX, float normY);
     void updateMicroNodePosition(const std::string& viewId, const std::string& nodeId, float normX, float normY);
-    [[nodiscard]] std::array<float, 2> meterLevelForNode(const std::string& nodeId) const;
-    [[nodiscard]] std::array<float, 2> meterLevelForMicroNode(const std::string& viewId, const std::string& nodeId) const;
+    [[nodiscard]] audio::MeterHandle meterHandleForNode(const std::string& nodeId) const;
+    [[nodiscard]] audio::MeterHandle meterHandleForMicroNode(const std::string& viewId, const std::string& nodeId) const;
+    [[nodiscard]] std::uint64_t meterLayoutVersion() const;
+    void readMeters(audio::MeterSnapshot& snapshot) const;
+    bool setNodeGain(const std::string& nodeId, float gainDecibels);
+    [[nodiscard]] std::optional<float> nodeGain(const std::string& nodeId) const;
+    bool setNodeMuted(const std::string& nodeId, bool muted);
+    bool setGeneratorSignal(const std::string& nodeId, audio::GeneratorSignal signal);
+    bool setGeneratorFrequency(const std::string& nodeId, float frequencyHz);
+    bool setChannelStripParameter(const std::string& nodeId, audio::NodeParameter parameter, float value);
+    void resetMeters();
+    bool captureSnapshot(const std::string& name);
+    bool recallSnapshot(const std::string& name, audio::SnapshotGlide glide = audio::SnapshotGlide::Medium);
+    bool setNodeRecallSafe(const std::string& nodeId, bool safe);
     [[nodiscard]] const std::unordered_map<std::string, persistence::LayoutPosition>& macroLayout() const noexcept;
     bool deleteNode(const std::string& nodeId);
     bool toggleNodeEnabled(const std::string& nodeId);
@@ -115,6 +127,7 @@ private:
                                                               const std::optional<std::pair<std::string, std::string>>& insertBetween) const;
     void updateMicroTopologyForNode(const std::string& nodeId);
     [[nodiscard]] audio::GraphNodeType resolveNodeType(const std::string& nodeId) const;
+    [[nodiscard]] const std::string& audioNodeId(const std::string& nodeId) const;
     void setPersonPresetForNode(const std::string& nodeId, const std::string& presetName);
     static bool rewireForInsertion(audio::GraphTopology& topology,
                                    const std::optional<std::pair<std::string, std::string>>& insertBetween,
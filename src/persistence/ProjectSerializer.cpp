@@ -2,7 +2,10 @@
 
 #include "../core/Logging.h"
 
+#include <algorithm>
 #include <array>
+#include <cctype>
+#include <format>
 #include <fstream>
 #include <sstream>
 #include <unordered_map>
@@ -77,6 +80,61 @@ std::optional<audio::GraphNodeType> nodeTypeFromString(const std::string& type)
     return std::nullopt;
 }
 
+// Indexed by audio::NodeParameter; these names are what snapshot files store.
+constexpr std::array<const char*, audio::kNodeParameterCount> kNodeParameterNames {
+    "gain",
+    "mute",
+    "signal",
+    "frequency",
+    "hpf_frequency",
+    "eq_low_frequency",
+    "eq_low_gain",
+    "eq_low_q",
+    "eq_low_mid_frequency",
+    "eq_low_mid_gain",
+    "eq_low_mid_q",
+    "eq_high_mid_frequency",
+    "eq_high_mid_gain",
+    "eq_high_mid_q",
+    "eq_high_frequency",
+    "eq_high_gain",
+    "eq_high_q",
+    "gate_threshold",
+    "compressor_threshold",
+    "compressor_ratio",
+    "compressor_attack",
+    "compressor_release",
+    "compressor_makeup",
+};
+
+std::string nodeParameterToString(audio::NodeParameter parameter) {
+    const auto index = static_cast<std::size_t>(parameter);
+    return index < kNodeParameterNames.size() ? kNodeParameterNames[index] : "unknown";
+}
+
+// Snapshot names are typed by the user, so anything but a plain file stem is mapped to one,
+// suffixed with a hash of the name so two names never share a file.
+std::string snapshotFileStem(const std::string& name) {
+    const auto isPlain = [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == ' ' || c == '-' || c == '_';
+    };
+    if (!name.empty() && std::all_of(name.begin(), name.end(), isPlain) && name + ".json" != kSnapshotIndexFileName) {
+        return name;
+    }
+    std::string stem;
+    stem.reserve(name.size() + 9);
+    std::uint32_t hash = 2166136261U;
+    for (const auto c : name) {
+        stem.push_back(isPlain(c) ? c : '_');
+        hash = (hash ^ static_cast<unsigned char>(c)) * 16777619U;
+    }
+    return std::format("{}-{:08x}", stem, hash);
+}
+
+fs::path snapshotFilePath(const fs::path& snapshotsDir, const std::string& name) {
+    return snapshotsDir / (snapshotFileStem(name) + ".json");
+}
+
 void ensureProjectSkeleton(const fs::path& root) {
     std::error_code ec;
     fs::create_directories(root, ec);
@@ -87,6 +145,15 @@ void ensureProjectSkeleton(const fs::path& root) {
 
 #if BROADCASTMIX_HAS_JUCE
 
+std::optional<audio::NodeParameter> nodeParameterFromString(const std::string& parameter) {
+    for (std::size_t index = 0; index < kNodeParameterNames.size(); ++index) {
+        if (parameter == kNodeParameterNames[index]) {
+            return static_cast<audio::NodeParameter>(index);
+        }
+    }
+    return std::nullopt;
+}
+
 juce::var topologyToVar(const audio::GraphTopology& topology) {
     auto* graphObject = new juce::DynamicObject();
 
@@ -114,6 +181,10 @@ juce::var topologyToVar(const audio::GraphTopology& topology) {
         connObj->setProperty("fromChannel", static_cast<int>(connection.fromChannel));
         connObj->setProperty("to", juce::String(connection.toNodeId));
         connObj->setProperty("toChannel", static_cast<int>(connection.toChannel));
+        if (connection.gain != 1.0F) {
+            connObj->setProperty("gain", connection.gain);
+        }
+        connObj->setProperty("fanOut", connection.fanOut);
         connections.add(juce::var(connObj));
     }
 
@@ -203,6 +274,12 @@ std::shared_ptr<audio::GraphTopology> topologyFromVar(const juce::var& varGraph)
                 .toNodeId = connVar["to"].toString().toStdString(),
                 .toChannel = static_cast<std::uint32_t>(static_cast<int>(connVar["toChannel"]))
             };
+            if (connVar.hasProperty("gain")) {
+                connection.gain = static_cast<float>(static_cast<double>(connVar["gain"]));
+            }
+            // Projects saved before fan-out became explicit spread every mono end, so a
+            // connection without the key keeps doing that.
+            connection.fanOut = static_cast<bool>(connVar.getProperty("fanOut", juce::var(true)));
 
             topology->connect(std::move(connection));
         }
@@ -456,7 +533,12 @@ void writeGraphToFile(const Project& project,
         out << "      {\"from\": \"" << connection.fromNodeId
             << "\", \"fromChannel\": " << connection.fromChannel
             << ", \"to\": \"" << connection.toNodeId
-            << "\", \"toChannel\": " << connection.toChannel << "}";
+            << "\", \"toChannel\": " << connection.toChannel;
+        if (connection.gain != 1.0F) {
+            out << ", \"gain\": " << connection.gain;
+        }
+        out << ", \"fanOut\": " << (connection.fanOut ? "true" : "false");
+        out << "}";
         out << (i + 1 == connections.size() ? "\n" : ",\n");
     }
     out << "    ]\n";
@@ -545,15 +627,83 @@ std::vector<std::string> loadSnapshotIndex(const fs::path& snapshotsDir) {
     return names;
 }
 
-void writeSnapshotIndex(const std::vector<std::string>& names, const fs::path& snapshotsDir) {
+std::vector<std::string> loadRecallSafeNodes(const fs::path& snapshotsDir) {
+    const auto parsed = readJsonFile(snapshotsDir / kSnapshotIndexFileName);
+    std::vector<std::string> nodes;
+    if (parsed.isObject()) {
+        const auto list = parsed["safe"];
+        if (list.isArray()) {
+            for (const auto& item : *list.getArray()) {
+                nodes.push_back(item.toString().toStdString());
+            }
+        }
+    }
+    return nodes;
+}
+
+void writeSnapshotIndex(const std::vector<std::string>& names,
+                        const std::vector<std::string>& safeNodes,
+                        const fs::path& snapshotsDir) {
     auto* root = new juce::DynamicObject();
     juce::Array<juce::var> list;
     for (const auto& name : names) {
         list.add(juce::String(name));
     }
     root->setProperty("snapshots", list);
+    if (!safeNodes.empty()) {
+        juce::Array<juce::var> safe;
+        for (const auto& nodeId : safeNodes) {
+            safe.add(juce::String(nodeId));
+        }
+        root->setProperty("safe", safe);
+    }
     writeJsonToFile(juce::var(root), snapshotsDir / kSnapshotIndexFileName);
 }
+
+std::vector<audio::SnapshotState> loadSnapshotPayloads(const std::vector<std::string>& names, const fs::path& snapshotsDir) {
+    std::vector<audio::SnapshotState> snapshots;
+    for (const auto& name : names) {
+        const auto parsed = readJsonFile(snapshotFilePath(snapshotsDir, name));
+        const auto list = parsed.isObject() ? parsed["parameters"] : juce::var();
+        if (!list.isArray()) {
+            continue;
+        }
+
+        audio::SnapshotState snapshot;
+        snapshot.name = name;
+        for (const auto& item : *list.getArray()) {
+            const auto parameter = nodeParameterFromString(item.getProperty("parameter", "").toString().toStdString());
+            const auto nodeId = item.getProperty("node", "").toString().toStdString();
+            if (!parameter || nodeId.empty()) {
+                continue;
+            }
+            snapshot.parameters.push_back({ nodeId, *parameter, static_cast<float>(item.getProperty("value", 0.0)) });
+        }
+        snapshots.push_back(std::move(snapshot));
+    }
+    return snapshots;
+}
+
+void writeSnapshotPayload(const audio::SnapshotState& snapshot, const fs::path& snapshotsDir) {
+    const auto path = snapshotFilePath(snapshotsDir, snapshot.name);
+    // Keep notes and other fields written by hand alongside the parameters.
+    auto root = fs::exists(path) ? readJsonFile(path) : juce::var();
+    if (!root.isObject()) {
+        root = juce::var(new juce::DynamicObject());
+    }
+
+    juce::Array<juce::var> list;
+    for (const auto& parameter : snapshot.parameters) {
+        auto* item = new juce::DynamicObject();
+        item->setProperty("node", juce::String(parameter.nodeId));
+        item->setProperty("parameter", juce::String(nodeParameterToString(parameter.parameter)));
+        item->setProperty("value", parameter.value);
+        list.add(juce::var(item));
+    }
+    root.getDynamicObject()->setProperty("name", juce::String(snapshot.name));
+    root.getDynamicObject()->setProperty("parameters", list);
+    writeJsonToFile(root, path);
+}
 #else
 std::vector<std::string> loadSnapshotIndex(const fs::path& snapshotsDir) {
     const auto indexPath = snapshotsDir / kSnapshotIndexFileName;
@@ -571,25 +721,61 @@ std::vector<std::string> loadSnapshotIndex(const fs::path& snapshotsDir) {
     return names;
 }
 
-void writeSnapshotIndex(const std::vector<std::string>& names, const fs::path& snapshotsDir) {
+std::vector<std::string> loadRecallSafeNodes(const fs::path&) {
+    return {};
+}
+
+void writeSnapshotIndex(const std::vector<std::string>& names,
+                        const std::vector<std::string>&,
+                        const fs::path& snapshotsDir) {
     const auto indexPath = snapshotsDir / kSnapshotIndexFileName;
     std::ofstream out(indexPath, std::ios::trunc);
     for (const auto& name : names) {
         out << name << "\n";
     }
 }
+
+std::vector<audio::SnapshotState> loadSnapshotPayloads(const std::vector<std::string>&, const fs::path&) {
+    return {};
+}
+
+void writeSnapshotPayload(const audio::SnapshotState& snapshot, const fs::path& snapshotsDir) {
+    std::ofstream out(snapshotFilePath(snapshotsDir, snapshot.name), std::ios::trunc);
+    out << "{\n"
+        << "  \"name\": \"" << snapshot.name << "\",\n"
+        << "  \"parameters\": [\n";
+    for (std::size_t i = 0; i < snapshot.parameters.size(); ++i) {
+        const auto& parameter = snapshot.parameters[i];
+        out << "    {\"node\": \"" << parameter.nodeId
+            << "\", \"parameter\": \"" << nodeParameterToString(parameter.parameter)
+            << "\", \"value\": " << parameter.value << "}";
+        out << (i + 1 == snapshot.parameters.size() ? "\n" : ",\n");
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
 #endif
 
+// Payloads only change when a snapshot is captured, which writes its own file; a project
+// save fills in the ones missing on disk, e.g. when saving to a new location.
+void writeMissingSnapshotPayloads(const std::vector<audio::SnapshotState>& snapshots, const fs::path& snapshotsDir) {
+    for (const auto& snapshot : snapshots) {
+        if (!fs::exists(snapshotFilePath(snapshotsDir, snapshot.name))) {
+            writeSnapshotPayload(snapshot, snapshotsDir);
+        }
+    }
+}
+
 std::vector<std::string> ensureSnapshots(const fs::path& snapshotsDir) {
     if (!fs::exists(snapshotsDir / kSnapshotIndexFileName)) {
         const std::vector<std::string> defaults { "Service Default" };
-        writeSnapshotIndex(defaults, snapshotsDir);
+        writeSnapshotIndex(defaults, {}, snapshotsDir);
         return defaults;
     }
     auto names = loadSnapshotIndex(snapshotsDir);
     if (names.empty()) {
         names = { "Service Default" };
-        writeSnapshotIndex(names, snapshotsDir);
+        writeSnapshotIndex(names, loadRecallSafeNodes(snapshotsDir), snapshotsDir);
     }
     return names;
 }
@@ -632,6 +818,8 @@ Project ProjectSerializer::load(const std::string& path) {
 
     const auto snapshotsDir = projectPath / "snapshots";
     project.snapshotNames = ensureSnapshots(snapshotsDir);
+    project.snapshots = loadSnapshotPayloads(project.snapshotNames, snapshotsDir);
+    project.recallSafeNodes = loadRecallSafeNodes(snapshotsDir);
     project.lastAutosavePath = locateAutosaveGraph(projectPath / "autosave");
     return project;
 }
@@ -651,10 +839,11 @@ void ProjectSerializer::save(const Project& project, const std::string& path) {
 
     const auto snapshotsDir = projectPath / "snapshots";
     if (!project.snapshotNames.empty()) {
-        writeSnapshotIndex(project.snapshotNames, snapshotsDir);
+        writeSnapshotIndex(project.snapshotNames, project.recallSafeNodes, snapshotsDir);
     } else if (!fs::exists(snapshotsDir / kSnapshotIndexFileName)) {
-        writeSnapshotIndex({ "Service Default" }, snapshotsDir);
+        writeSnapshotIndex({ "Service Default" }, project.recallSafeNodes, snapshotsDir);
     }
+    writeMissingSnapshotPayloads(project.snapshots, snapshotsDir);
 
     if (project.lastAutosavePath) {
         const fs::path autosaveGraph = projectPath / "autosave" / kAutosaveGraphFileName;
@@ -667,6 +856,12 @@ void ProjectSerializer::save(const Project& project, const std::string& path) {
     }
 }
 
+void ProjectSerializer::saveSnapshot(const audio::SnapshotState& snapshot, const std::string& path) {
+    const fs::path projectPath { path };
+    ensureProjectSkeleton(projectPath);
+    writeSnapshotPayload(snapshot, projectPath / "snapshots");
+}
+
 std::filesystem::path ProjectSerializer::autosavePath(const std::filesystem::path& projectPath) const {
     return projectPath / "autosave";
 }
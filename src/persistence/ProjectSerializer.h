@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../audio/AudioEngine.h"
 #include "../audio/GraphTopology.h"
 
 #include <filesystem>
@@ -34,6 +35,8 @@ struct Project {
     std::string name;
     std::shared_ptr<audio::GraphTopology> graphTopology;
     std::vector<std::string> snapshotNames;
+    std::vector<audio::SnapshotState> snapshots;
+    std::vector<std::string> recallSafeNodes;
     std::optional<std::string> lastAutosavePath;
     std::unordered_map<std::string, LayoutPosition> macroLayout;
     std::unordered_map<std::string, MicroViewState> microViews;
@@ -46,6 +49,8 @@ public:
 
     [[nodiscard]] Project load(const std::string& path);
     void save(const Project& project, const std::string& path);
+    // Rewrites one snapshot's payload; save() leaves payloads already on disk alone.
+    void saveSnapshot(const audio::SnapshotState& snapshot, const std::string& path);
 
 private:
     std::filesystem::path autosavePath(const std::filesystem::path& projectPath) const;
@@ -1,8 +1,42 @@
+#include "audio/AudioCommandQueue.h"
+#include "audio/AudioWorkerPool.h"
+#include "audio/BufferPool.h"
+#include "audio/CpuLoadMeter.h"
+#include "audio/LevelMeter.h"
+#include "audio/LoudnessMeter.h"
+#include "audio/MeterStore.h"
+#include "audio/NodeTimingStore.h"
+#include "audio/ParameterStore.h"
+#include "audio/RenderPlan.h"
+#include "audio/RoutingMatrix.h"
+#include "audio/SnapshotRecaller.h"
+#include "audio/XrunJournal.h"
+#include "audio/dsp/ChannelStrip.h"
+#include "audio/dsp/DelayLine.h"
+#include "audio/dsp/MeterKernel.h"
+#include "audio/dsp/MixKernel.h"
+#include "audio/dsp/SignalGenerator.h"
+#include "audio/dsp/SmoothedValue.h"
 #include "core/Application.h"
 #include "persistence/ProjectSerializer.h"
 
+#if BROADCASTMIX_HAS_JUCE
+#include "audio/CompiledGraphBuilder.h"
+#include "audio/CompiledGraphProcessor.h"
+#include "audio/JuceGraphBuilder.h"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cmath>
 #include <filesystem>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
 
 int main() {
     broadcastmix::core::Application app({ .appName = "BroadcastMix", .version = "3.0.0" },
@@ -31,7 +65,584 @@ int main() {
     assert(reloaded.graphTopology && reloaded.graphTopology->nodes().size() == sampleProject.graphTopology->nodes().size());
     assert(reloaded.snapshotNames == sampleProject.snapshotNames);
     assert(reloaded.lastAutosavePath.has_value());
+#if BROADCASTMIX_HAS_JUCE
+    // The sample project predates explicit fan-out, so its connections keep spreading mono ends;
+    // a connection saved without fan-out stays that way.
+    const auto& sampleConnections = sampleProject.graphTopology->connections();
+    assert(std::all_of(sampleConnections.begin(), sampleConnections.end(), [](const auto& connection) { return connection.fanOut; }));
+    auto pinnedProject = reloaded;
+    pinnedProject.graphTopology = std::make_shared<broadcastmix::audio::GraphTopology>(*reloaded.graphTopology);
+    auto pinnedConnection = pinnedProject.graphTopology->connections().front();
+    pinnedConnection.fanOut = false;
+    pinnedProject.graphTopology->disconnect(pinnedConnection.fromNodeId, pinnedConnection.toNodeId);
+    pinnedProject.graphTopology->connect(pinnedConnection);
+    serializer.save(pinnedProject, tempRoot.string());
+    const auto pinnedReloaded = serializer.load(tempRoot.string());
+    const auto& pinnedConnections = pinnedReloaded.graphTopology->connections();
+    const auto pinnedIt = std::find_if(pinnedConnections.begin(), pinnedConnections.end(), [&](const auto& connection) {
+        return connection.fromNodeId == pinnedConnection.fromNodeId && connection.toNodeId == pinnedConnection.toNodeId;
+    });
+    assert(pinnedIt != pinnedConnections.end() && !pinnedIt->fanOut);
+#endif
+
+    // A snapshot name cannot escape the snapshots directory, and saving the project leaves
+    // payloads already on disk alone; only saveSnapshot rewrites one.
+    const broadcastmix::audio::SnapshotState escapingSnapshot { .name = "../graph", .parameters = { { "broadcast_bus", broadcastmix::audio::NodeParameter::Gain, 0.5F } } };
+    reloaded.snapshotNames.push_back(escapingSnapshot.name);
+    reloaded.snapshots.push_back(escapingSnapshot);
+    serializer.save(reloaded, tempRoot.string());
+    const auto afterEscape = serializer.load(tempRoot.string());
+    assert(afterEscape.graphTopology && afterEscape.graphTopology->nodes().size() == sampleProject.graphTopology->nodes().size());
+    std::vector<fs::path> escapedPayloads;
+    for (const auto& entry : fs::directory_iterator(tempRoot / "snapshots")) {
+        if (entry.path().filename().string().starts_with("___graph-")) {
+            escapedPayloads.push_back(entry.path());
+        }
+    }
+    assert(escapedPayloads.size() == 1);
+    { std::ofstream(escapedPayloads.front(), std::ios::trunc) << "edited"; }
+    serializer.save(reloaded, tempRoot.string());
+    const auto untouched = fs::file_size(escapedPayloads.front()) == 6;
+    assert(untouched);
+    serializer.saveSnapshot(escapingSnapshot, tempRoot.string());
+    const auto rewritten = fs::file_size(escapedPayloads.front()) > 6;
+    assert(rewritten);
     fs::remove_all(tempRoot);
 
+    const auto defaultLayout = broadcastmix::audio::GraphTopology::createDefaultBroadcastLayout();
+    broadcastmix::audio::RenderPlanOptions planOptions;
+    planOptions.hardwareInputs = 2;
+    planOptions.hardwareOutputs = 2;
+    planOptions.isPassThrough = [](const broadcastmix::audio::GraphNode& node) {
+        return node.type() != broadcastmix::audio::GraphNodeType::Utility;
+    };
+    const auto plan = broadcastmix::audio::RenderPlan::compile(defaultLayout, planOptions);
+    assert(plan.steps.size() == defaultLayout.nodes().size());
+    assert(plan.unorderedNodes == 0);
+    assert(plan.bufferCount < plan.totalChannels);
+    assert(plan.aliasedChannels > 0);
+    assert(plan.silentHardwareOutputs.empty());
+
+    planOptions.concurrentSteps = true;
+    const auto concurrentPlan = broadcastmix::audio::RenderPlan::compile(defaultLayout, planOptions);
+    assert(concurrentPlan.concurrent && concurrentPlan.steps.size() == plan.steps.size());
+    const auto busStep = std::find_if(concurrentPlan.steps.begin(), concurrentPlan.steps.end(), [&](const auto& step) {
+        return defaultLayout.nodes()[step.node].id() == "broadcast_bus";
+    });
+    assert(busStep != concurrentPlan.steps.end() && busStep->dependencies == 4);
+
+    broadcastmix::audio::GraphTopology matrixLayout;
+    for (const auto* id : { "host_mic", "guest_mic" }) {
+        broadcastmix::audio::GraphNode mic(id, broadcastmix::audio::GraphNodeType::Channel);
+        mic.setInputChannelCount(1);
+        mic.setOutputChannelCount(1);
+        matrixLayout.addNode(std::move(mic));
+    }
+    broadcastmix::audio::GraphNode stereoBus("program_bus", broadcastmix::audio::GraphNodeType::MixBus);
+    stereoBus.setInputChannelCount(2);
+    stereoBus.setOutputChannelCount(2);
+    matrixLayout.addNode(std::move(stereoBus));
+    matrixLayout.connect({ .fromNodeId = "host_mic", .toNodeId = "program_bus", .fanOut = true });
+    matrixLayout.connect({ .fromNodeId = "guest_mic", .toNodeId = "program_bus", .gain = 0.5F, .fanOut = true });
+    const auto matrixPlan = broadcastmix::audio::RenderPlan::compile(matrixLayout, {});
+    const auto sums = std::count_if(matrixPlan.mixes.begin(), matrixPlan.mixes.end(), [](const auto& mix) {
+        return mix.kind == broadcastmix::audio::RenderPlan::MixKind::Sum && mix.numInputs == 2;
+    });
+    assert(sums == 2 && matrixPlan.mixInputs.size() == 4);
+    assert(std::count_if(matrixPlan.mixInputs.begin(), matrixPlan.mixInputs.end(), [](const auto& input) { return input.gain == 0.5F; }) == 2);
+    auto sidePatchLayout = matrixLayout;
+    sidePatchLayout.disconnect("guest_mic", "program_bus");
+    sidePatchLayout.connect({ .fromNodeId = "guest_mic", .toNodeId = "program_bus", .toChannel = 1, .gain = 0.5F });
+    const auto sidePatchPlan = broadcastmix::audio::RenderPlan::compile(sidePatchLayout, {});
+    // Only the right channel sums two sources; the left copies the host through its own delay line.
+    assert(sidePatchPlan.mixInputs.size() == 3 && sidePatchPlan.delayLineCount == 3);
+    assert(std::count_if(sidePatchPlan.mixInputs.begin(), sidePatchPlan.mixInputs.end(), [](const auto& input) { return input.gain == 0.5F; }) == 1);
+    assert(std::count_if(sidePatchPlan.mixes.begin(), sidePatchPlan.mixes.end(), [](const auto& mix) {
+        return mix.kind == broadcastmix::audio::RenderPlan::MixKind::Copy && mix.numInputs == 1;
+    }) == 1);
+
+    assert(matrixPlan.delayLineCount == 4);
+    std::vector<std::uint32_t> stepLatencies(matrixPlan.steps.size(), 0);
+    std::vector<std::uint32_t> outputLatencies(matrixPlan.steps.size(), 0);
+    std::vector<std::uint32_t> inputDelays(matrixPlan.mixInputs.size(), 0);
+    const auto hostStep = static_cast<std::uint32_t>(std::find_if(matrixPlan.steps.begin(), matrixPlan.steps.end(), [&](const auto& step) {
+        return matrixLayout.nodes()[step.node].id() == "host_mic";
+    }) - matrixPlan.steps.begin());
+    stepLatencies[hostStep] = 64;
+    matrixPlan.computeCompensation(stepLatencies.data(), outputLatencies.data(), inputDelays.data());
+    for (std::size_t index = 0; index < matrixPlan.mixInputs.size(); ++index) {
+        assert(inputDelays[index] == (matrixPlan.mixInputs[index].producer == hostStep ? 0U : 64U));
+    }
+    assert(*std::max_element(outputLatencies.begin(), outputLatencies.end()) == 64);
+
+    // Host on the left only, guest on the right only: a latent guest must hold the host back too.
+    auto splitLayout = matrixLayout;
+    splitLayout.disconnect("host_mic", "program_bus");
+    splitLayout.disconnect("guest_mic", "program_bus");
+    splitLayout.connect({ .fromNodeId = "host_mic", .toNodeId = "program_bus" });
+    splitLayout.connect({ .fromNodeId = "guest_mic", .toNodeId = "program_bus", .toChannel = 1 });
+    const auto splitPlan = broadcastmix::audio::RenderPlan::compile(splitLayout, {});
+    assert(splitPlan.mixInputs.size() == 2 && splitPlan.delayLineCount == 2);
+    const auto stepOf = [&](const char* id) {
+        return static_cast<std::uint32_t>(std::find_if(splitPlan.steps.begin(), splitPlan.steps.end(), [&](const auto& step) {
+            return splitLayout.nodes()[step.node].id() == id;
+        }) - splitPlan.steps.begin());
+    };
+    std::vector<std::uint32_t> splitLatencies(splitPlan.steps.size(), 0);
+    std::vector<std::uint32_t> splitOutputLatencies(splitPlan.steps.size(), 0);
+    std::vector<std::uint32_t> splitDelays(splitPlan.mixInputs.size(), 0);
+    splitLatencies[stepOf("guest_mic")] = 64;
+    splitPlan.computeCompensation(splitLatencies.data(), splitOutputLatencies.data(), splitDelays.data());
+    for (std::size_t index = 0; index < splitPlan.mixInputs.size(); ++index) {
+        assert(splitDelays[index] == (splitPlan.mixInputs[index].producer == stepOf("host_mic") ? 64U : 0U));
+    }
+    assert(splitOutputLatencies[stepOf("program_bus")] == 64);
+
+    broadcastmix::audio::dsp::DelayLine delayLine;
+    delayLine.prepare(8, 5);
+    std::vector<float> delayInput { 1.0F, 2.0F, 3.0F, 4.0F, 5.0F };
+    std::vector<float> delayOutput(5, -1.0F);
+    delayLine.process(delayInput.data(), delayOutput.data(), delayInput.size(), 3);
+    delayLine.process(delayInput.data(), delayOutput.data(), delayInput.size(), 3);
+    assert((delayOutput == std::vector<float> { 3.0F, 4.0F, 5.0F, 1.0F, 2.0F }));
+
+    std::vector<float> sumTarget(37, 1.0F);
+    std::vector<float> sumOther(37, 0.25F);
+    const std::array<const float*, 2> sumSources { sumTarget.data(), sumOther.data() };
+    const std::array<float, 2> sumGains { 0.5F, 2.0F };
+    broadcastmix::audio::dsp::sumInto(sumTarget.data(), sumSources.data(), sumGains.data(), sumSources.size(), sumTarget.size());
+    assert(std::all_of(sumTarget.begin(), sumTarget.end(), [](float sample) { return sample == 1.0F; }));
+
+    broadcastmix::audio::BufferPool bufferPool;
+    {
+        auto scratch = bufferPool.lease(3, 100);
+        assert(scratch.numChannels() == 3 && scratch.numSamples() == 100);
+        for (std::size_t channel = 0; channel < scratch.numChannels(); ++channel) {
+            assert(reinterpret_cast<std::uintptr_t>(scratch.channel(channel)) % broadcastmix::audio::BufferPool::kAlignment == 0);
+            assert(std::all_of(scratch.channel(channel), scratch.channel(channel) + 100, [](float sample) { return sample == 0.0F; }));
+            std::fill(scratch.channel(channel), scratch.channel(channel) + 100, 1.0F);
+        }
+    }
+    const auto scratchBytes = bufferPool.reservedBytes();
+    assert(scratchBytes > 0 && bufferPool.leasedBytes() == 0);
+    {
+        // A released block is reused, and handed out silent again.
+        auto reused = bufferPool.lease(2, 64);
+        assert(bufferPool.reservedBytes() == scratchBytes && reused.channel(1)[63] == 0.0F);
+    }
+    bufferPool.trim();
+    assert(bufferPool.reservedBytes() == 0);
+    {
+        // Compensation lines can run in leased storage, where the pool accounts for them.
+        const auto historySize = broadcastmix::audio::dsp::DelayLine::storageSize(8, 5);
+        auto history = bufferPool.lease(1, historySize);
+        broadcastmix::audio::dsp::DelayLine leasedLine;
+        leasedLine.prepare(history.channel(0), 8, 5);
+        std::vector<float> leasedOutput(5, -1.0F);
+        leasedLine.process(delayInput.data(), leasedOutput.data(), delayInput.size(), 3);
+        leasedLine.process(delayInput.data(), leasedOutput.data(), delayInput.size(), 3);
+        assert(leasedOutput == delayOutput);
+        assert(bufferPool.leasedBytes() >= historySize * sizeof(float));
+    }
+    bufferPool.trim();
+
+    broadcastmix::audio::RoutingMatrix routingMatrix;
+    std::vector<float> patchLeft(21, 1.0F);
+    std::vector<float> patchRight(21, 0.5F);
+    std::vector<float> patchOut0(21, -1.0F);
+    std::vector<float> patchOut1(21, -1.0F);
+    std::vector<float> patchOut2(21, -1.0F);
+    const std::array<const float*, 2> patchSources { patchLeft.data(), patchRight.data() };
+    std::array<float*, 3> patchDestinations { patchOut0.data(), patchOut1.data(), patchOut2.data() };
+    routingMatrix.update();
+    routingMatrix.apply(broadcastmix::audio::PatchSide::Input, patchSources.data(), 2, patchDestinations.data(), 3, 21);
+    assert(patchOut0 == patchLeft && patchOut1 == patchRight && patchOut2 == std::vector<float>(21, 0.0F));
+    assert(routingMatrix.patches(broadcastmix::audio::PatchSide::Input).size() == broadcastmix::audio::RoutingMatrix::kMaxChannels);
+    assert(!routingMatrix.setPatches(broadcastmix::audio::PatchSide::Input, { { .source = 64, .destination = 0 } }));
+    const auto inputPatched = routingMatrix.setPatches(broadcastmix::audio::PatchSide::Input,
+                                                       { { .source = 1, .destination = 0, .gain = 2.0F },
+                                                         { .source = 0, .destination = 2 },
+                                                         { .source = 1, .destination = 2 } });
+    assert(inputPatched);
+    routingMatrix.update();
+    routingMatrix.apply(broadcastmix::audio::PatchSide::Input, patchSources.data(), 2, patchDestinations.data(), 3, 21);
+    assert(patchOut0 == std::vector<float>(21, 1.0F) && patchOut1 == std::vector<float>(21, 0.0F)
+           && patchOut2 == std::vector<float>(21, 1.5F));
+    routingMatrix.apply(broadcastmix::audio::PatchSide::Output, patchSources.data(), 2, patchDestinations.data(), 3, 21);
+    assert(patchOut1 == patchRight);
+
+    std::vector<std::uint32_t> dependencyCounts { 0, 0, 2 };
+    std::vector<std::uint32_t> dependentOffsets { 0, 1, 2, 2 };
+    std::vector<std::uint32_t> dependents { 2, 2 };
+    std::vector<std::atomic<std::uint32_t>> pending(3);
+    std::array<std::atomic<int>, 3> finished {};
+    std::atomic<int> clock { 0 };
+    struct PoolContext {
+        std::array<std::atomic<int>, 3>& finished;
+        std::atomic<int>& clock;
+    } poolContext { finished, clock };
+    broadcastmix::audio::AudioWorkerPool workerPool(2);
+    for (int run = 0; run < 100; ++run) {
+        workerPool.run({ 3, dependencyCounts.data(), dependentOffsets.data(), dependents.data(), pending.data() },
+                       [](void* context, std::uint32_t task) {
+                           auto& state = *static_cast<PoolContext*>(context);
+                           state.finished[task].store(state.clock.fetch_add(1) + 1);
+                       },
+                       &poolContext);
+        assert(finished[2].load() > finished[0].load() && finished[2].load() > finished[1].load());
+    }
+
+    broadcastmix::audio::CpuLoadMeter loadMeter;
+    loadMeter.record(0.005, 0.01);
+    loadMeter.record(0.02, 0.01);
+    broadcastmix::audio::AudioEngineStatus loadStatus;
+    loadMeter.fill(loadStatus);
+    assert(loadStatus.cpuLoad > 1.9 && loadStatus.cpuLoadPeak > 1.9);
+    assert(loadStatus.cpuLoadHistogram[5] == 1 && loadStatus.cpuLoadHistogram.back() == 1);
+
+    broadcastmix::audio::NodeTimingStore timingStore;
+    timingStore.syncWithTopology(defaultLayout);
+    const auto busTiming = timingStore.timingFor("broadcast_bus");
+    { const broadcastmix::audio::ScopedNodeTimer idle(busTiming.get()); }
+    assert(timingStore.statsFor("broadcast_bus").blocks == 0);
+    timingStore.setEnabled(true);
+    { const broadcastmix::audio::ScopedNodeTimer timed(busTiming.get()); }
+    assert(timingStore.statsFor("broadcast_bus").blocks == 1);
+    assert(timingStore.snapshot().size() == defaultLayout.nodes().size());
+
+    broadcastmix::audio::MeterStore meterStore;
+    meterStore.syncWithTopology(defaultLayout);
+    const auto busNode = defaultLayout.findNode("broadcast_bus");
+    assert(busNode.has_value());
+    const auto busMeter = meterStore.meterFor(*busNode);
+    assert(busMeter->numChannels == broadcastmix::audio::MeterStore::meterChannelCount(*busNode));
+    broadcastmix::audio::LevelMeter busLevelMeter(busMeter, busMeter->numChannels);
+    busLevelMeter.prepare(48000.0);
+    // A quarter-rate sine sampled between its crests reads 0.5 but peaks at 0.707 between samples.
+    std::vector<float> busSamples(480);
+    for (std::size_t index = 0; index < busSamples.size(); ++index) {
+        busSamples[index] = (index % 4 < 2 ? 0.5F : -0.5F);
+    }
+    std::vector<const float*> busChannels(busMeter->numChannels, busSamples.data());
+    busLevelMeter.process(busChannels.data(), busChannels.size(), busSamples.size());
+    assert(meterStore.levelsFor("broadcast_bus").back() == 0.5F);
+    assert(meterStore.levelsFor("broadcast_bus", broadcastmix::audio::MeterMode::TruePeak).back() > 0.69F);
+    assert(meterStore.levelsFor("broadcast_bus", broadcastmix::audio::MeterMode::Rms).back() > 0.0F);
+    broadcastmix::audio::MeterSnapshot meterSnapshot;
+    meterStore.readSnapshot(meterSnapshot);
+    assert(meterSnapshot.ranges.size() == defaultLayout.nodes().size());
+    const auto busRange = meterSnapshot.ranges[meterStore.handleFor("broadcast_bus")];
+    assert(busRange.firstChannel % broadcastmix::audio::MeterStore::kChannelAlignment == 0);
+    assert(meterSnapshot.levels[busRange.firstChannel + busRange.numChannels - 1] == 0.5F);
+    assert(meterStore.handleFor("missing") == broadcastmix::audio::kInvalidMeterHandle);
+    busLevelMeter.clear();
+    assert(meterStore.levelsFor("broadcast_bus").back() == 0.0F);
+    busLevelMeter.process(busChannels.data(), busChannels.size(), busSamples.size());
+    assert(meterStore.levelsFor("broadcast_bus").back() > 0.0F);
+    meterStore.requestReset();
+    std::fill(busSamples.begin(), busSamples.end(), 0.0F);
+    busLevelMeter.process(busChannels.data(), busChannels.size(), busSamples.size());
+    assert(meterStore.levelsFor("broadcast_bus", broadcastmix::audio::MeterMode::PeakHold).back() == 0.0F);
+
+    // A snapshot taken while the layout is being rewritten sees one whole layout, never a mix.
+    constexpr std::array<std::array<std::uint32_t, 2>, 2> meterLayoutChannels { { { 1, 2 }, { 2, 2 } } };
+    std::array<broadcastmix::audio::GraphTopology, 2> meterLayouts;
+    for (std::size_t layout = 0; layout < meterLayouts.size(); ++layout) {
+        for (std::size_t meter = 0; meter < 2; ++meter) {
+            broadcastmix::audio::GraphNode node(meter == 0 ? "meter_a" : "meter_b", broadcastmix::audio::GraphNodeType::Channel);
+            const auto channels = meterLayoutChannels[layout][meter];
+            node.setInputChannelCount(channels);
+            node.setOutputChannelCount(channels);
+            meterLayouts[layout].addNode(std::move(node));
+        }
+    }
+    broadcastmix::audio::MeterStore churningMeterStore;
+    churningMeterStore.syncWithTopology(meterLayouts[0]);
+    std::atomic<bool> churning { true };
+    std::thread layoutWriter([&] {
+        for (int pass = 0; pass < 2000; ++pass) {
+            churningMeterStore.syncWithTopology(meterLayouts[static_cast<std::size_t>(pass % 2)]);
+        }
+        churning.store(false);
+    });
+    std::size_t tornSnapshots = 0;
+    broadcastmix::audio::MeterSnapshot churnSnapshot;
+    while (churning.load()) {
+        churningMeterStore.readSnapshot(churnSnapshot);
+        std::size_t liveMeters = 0;
+        std::uint32_t liveChannels = 0;
+        for (const auto& range : churnSnapshot.ranges) {
+            if (range.numChannels > 0) {
+                ++liveMeters;
+                liveChannels += range.numChannels;
+            }
+        }
+        if (liveMeters != 2 || (liveChannels != 3 && liveChannels != 4)) {
+            ++tornSnapshots;
+        }
+    }
+    layoutWriter.join();
+    assert(tornSnapshots == 0);
+
+    // EBU Tech 3341 case 1: a 1 kHz stereo sine at -23 dBFS reads -23 LUFS.
+    broadcastmix::audio::LoudnessMeter loudnessMeter;
+    std::vector<float> toneBlock(480);
+    double tonePhase = 0.0;
+    for (int block = 0; block < 100; ++block) {
+        for (auto& sample : toneBlock) {
+            sample = static_cast<float>(std::pow(10.0, -23.0 / 20.0) * std::sin(tonePhase));
+            tonePhase += 2.0 * 3.14159265358979323846 * 1000.0 / 48000.0;
+        }
+        const std::array<const float*, 2> toneChannels { toneBlock.data(), toneBlock.data() };
+        const auto tonePushed = loudnessMeter.push(toneChannels.data(), toneChannels.size(), toneBlock.size(), 48000.0);
+        assert(tonePushed);
+        loudnessMeter.analyse();
+    }
+    const auto loudness = loudnessMeter.stats();
+    assert(std::abs(loudness.momentaryLufs + 23.0) < 0.1 && std::abs(loudness.integratedLufs + 23.0) < 0.1);
+
+    broadcastmix::audio::ParameterStore parameterStore;
+    parameterStore.syncWithTopology(defaultLayout);
+    const auto trimNode = std::find_if(defaultLayout.nodes().begin(), defaultLayout.nodes().end(), [](const auto& node) {
+        return node.label() == "Monitor Trim -3 dB";
+    });
+    assert(trimNode != defaultLayout.nodes().end());
+    const auto trimParameters = parameterStore.parametersFor(*trimNode);
+    assert(std::abs(trimParameters->load(broadcastmix::audio::NodeParameter::Gain) - 0.7079F) < 1.0e-3F);
+    const auto trimGainSet = parameterStore.setParameter(trimNode->id(), broadcastmix::audio::NodeParameter::Gain, 0.25F);
+    assert(trimGainSet);
+    assert(trimParameters->load(broadcastmix::audio::NodeParameter::Gain) == 0.25F);
+    assert(!parameterStore.setParameter("missing", broadcastmix::audio::NodeParameter::Gain, 0.25F));
+
+    const auto busParameters = parameterStore.find("broadcast_bus");
+    const auto busRecallSafe = parameterStore.setRecallSafe("broadcast_bus", true);
+    assert(busParameters && busRecallSafe);
+    broadcastmix::audio::SnapshotRecaller recaller;
+    recaller.submit({ { trimParameters, broadcastmix::audio::NodeParameter::Gain, 1.0F },
+                      { busParameters, broadcastmix::audio::NodeParameter::Gain, 0.0F } },
+                    0.01);
+    assert(recaller.isGliding());
+    recaller.advance(240, 48000.0);
+    const auto midGlide = trimParameters->load(broadcastmix::audio::NodeParameter::Gain);
+    assert(midGlide > 0.25F && midGlide < 1.0F);
+    recaller.advance(240, 48000.0);
+    assert(trimParameters->load(broadcastmix::audio::NodeParameter::Gain) == 1.0F && !recaller.isGliding());
+    assert(busParameters->load(broadcastmix::audio::NodeParameter::Gain) == 1.0F);
+
+    broadcastmix::audio::AudioCommandQueue commandQueue;
+    const broadcastmix::audio::AudioCommand muteTrim {
+        .kind = broadcastmix::audio::AudioCommandKind::SetParameter,
+        .parameter = broadcastmix::audio::NodeParameter::Mute,
+        .value = 1.0F,
+        .parameters = trimParameters.get(),
+    };
+    const auto mutePushed = commandQueue.push(muteTrim, trimParameters);
+    assert(mutePushed);
+    assert(trimParameters->load(broadcastmix::audio::NodeParameter::Mute) == 0.0F);
+    const auto muteDrained = commandQueue.drain();
+    assert(muteDrained == 1 && trimParameters->load(broadcastmix::audio::NodeParameter::Mute) == 1.0F);
+    assert(!trimParameters->isBypassed());
+    const auto bypassPushed = commandQueue.push({ .kind = broadcastmix::audio::AudioCommandKind::SetEnabled, .value = 0.0F, .parameters = trimParameters.get() },
+                                                trimParameters);
+    assert(bypassPushed);
+    const auto bypassDrained = commandQueue.drain();
+    assert(bypassDrained == 1 && trimParameters->isBypassed());
+
+    auto toggledLayout = defaultLayout;
+    toggledLayout.setNodeEnabled(trimNode->id(), false);
+    toggledLayout.setNodeLabel("broadcast_bus", "Renamed Bus");
+    assert(toggledLayout.hasSameRouting(defaultLayout));
+    const auto firstConnection = toggledLayout.connections().front();
+    toggledLayout.disconnect(firstConnection.fromNodeId, firstConnection.toNodeId);
+    assert(!toggledLayout.hasSameRouting(defaultLayout));
+
+    broadcastmix::audio::dsp::SmoothedValue smoothedGain;
+    smoothedGain.prepare(48000.0, 1.0, 1.0F);
+    smoothedGain.setTarget(0.0F);
+    std::vector<float> rampSamples(64, 1.0F);
+    std::array<float*, 1> rampChannels { rampSamples.data() };
+    smoothedGain.applyGain(rampChannels.data(), rampChannels.size(), 32);
+    rampChannels[0] += 32;
+    smoothedGain.applyGain(rampChannels.data(), rampChannels.size(), 32);
+    assert(std::is_sorted(rampSamples.rbegin(), rampSamples.rend()));
+    assert(rampSamples.front() < 1.0F && rampSamples.front() > 0.97F);
+    assert(rampSamples[47] == 0.0F && !smoothedGain.isSmoothing());
+
+    broadcastmix::audio::dsp::SignalGenerator generator;
+    generator.prepare(48000.0, 2);
+    std::vector<float> toneLeft(300, 0.0F);
+    std::vector<float> toneRight(300, 0.0F);
+    std::array<float*, 2> toneChannels { toneLeft.data(), toneRight.data() };
+    generator.add(toneChannels.data(), toneChannels.size(), toneLeft.size(), {});
+    for (std::size_t index = 0; index < toneLeft.size(); ++index) {
+        const auto expected = std::sin(6.283185307179586 * 1000.0 * static_cast<double>(index) / 48000.0);
+        assert(std::abs(toneLeft[index] - expected) < 1.0e-4 && toneRight[index] == toneLeft[index]);
+    }
+    std::fill(toneLeft.begin(), toneLeft.end(), 0.0F);
+    std::fill(toneRight.begin(), toneRight.end(), 0.0F);
+    generator.add(toneChannels.data(), toneChannels.size(), toneLeft.size(), { .signal = broadcastmix::audio::GeneratorSignal::ChannelIdent });
+    assert(toneLeft[1] != toneRight[1] && std::abs(toneLeft[1] - std::sin(6.283185307179586 * 110.0 / 48000.0)) < 1.0e-4);
+    generator.add(toneChannels.data(), toneChannels.size(), toneLeft.size(), { .signal = broadcastmix::audio::GeneratorSignal::PinkNoise, .level = 0.5F });
+    assert(std::all_of(toneLeft.begin(), toneLeft.end(), [](float sample) { return std::isfinite(sample) && std::abs(sample) < 2.0F; }));
+
+    broadcastmix::audio::dsp::ChannelStrip strip;
+    strip.prepare(48000.0, 3);
+    std::vector<std::vector<float>> stripSamples(3, std::vector<float>(4803, 1.0F));
+    std::array<float*, 3> stripChannels { stripSamples[0].data(), stripSamples[1].data(), stripSamples[2].data() };
+    strip.process(stripChannels.data(), stripChannels.size(), stripSamples[0].size());
+    assert(std::all_of(stripSamples[2].begin(), stripSamples[2].end(), [](float sample) { return sample == 1.0F; }));
+    strip.setSettings({ .highPassFrequency = 100.0F });
+    strip.process(stripChannels.data(), stripChannels.size(), stripSamples[0].size());
+    assert(std::abs(stripSamples[0].back()) < 1.0e-3F && stripSamples[2].back() == stripSamples[0].back());
+    strip.setSettings({ .compressorThresholdDecibels = -20.0F, .compressorRatio = 4.0F, .compressorAttackMilliseconds = 1.0F });
+    for (auto& samples : stripSamples) {
+        std::fill(samples.begin(), samples.end(), 1.0F);
+    }
+    strip.process(stripChannels.data(), stripChannels.size(), stripSamples[0].size());
+    assert(std::abs(strip.gainReductionDecibels() - 15.0F) < 0.1F);
+    assert(std::abs(stripSamples[1].back() - std::pow(10.0F, -15.0F / 20.0F)) < 1.0e-2F);
+
+    const auto journalRoot = fs::temp_directory_path() / "broadcastmix_xrun_journal_test";
+    fs::remove_all(journalRoot);
+    broadcastmix::audio::XrunJournal journal;
+    journal.setLogDirectory(journalRoot / "logs");
+    broadcastmix::audio::XrunEvent overrun;
+    overrun.timestampMicroseconds = broadcastmix::audio::XrunJournal::nowMicroseconds();
+    overrun.callbackNanoseconds = 12000000;
+    overrun.deadlineNanoseconds = 10666666;
+    overrun.topologyVersion = 7;
+    const auto overrunPushed = journal.push(overrun);
+    assert(overrunPushed);
+    const auto journalDrained = journal.drain();
+    assert(journalDrained == 1);
+    assert(fs::exists(journalRoot / "logs" / broadcastmix::audio::XrunJournal::kLogFileName));
+    fs::remove_all(journalRoot);
+
+    std::vector<float> meterSamples(37, 0.5F);
+    meterSamples[29] = -0.75F;
+    const auto meterLevel = broadcastmix::audio::dsp::measureChannel(meterSamples.data(), meterSamples.size());
+    assert(meterLevel.peak == 0.75F);
+    assert(std::abs(meterLevel.sumOfSquares - (36 * 0.25 + 0.5625)) < 1.0e-6);
+
+#if BROADCASTMIX_HAS_JUCE
+    broadcastmix::audio::AudioEngine offlineEngine({});
+    broadcastmix::audio::OfflineRenderRequest renderRequest;
+    renderRequest.lengthInSamples = 48000;
+    const auto rendered = offlineEngine.renderOffline(renderRequest);
+    assert(rendered.success && rendered.samplesRendered == 48000);
+    assert(rendered.outputBuffers.size() == offlineEngine.settings().outputChannels);
+    assert(rendered.realtimeFactor > 0.0);
+
+    // A cable patch recompiles the plan around the existing processors instead of replacing the graph.
+    broadcastmix::audio::CompiledGraphBuilder compiledBuilder(nullptr);
+    const broadcastmix::audio::PlaybackConfiguration playback {};
+    auto compiledGraph = compiledBuilder.buildFromTopology(defaultLayout, playback);
+    auto* compiled = dynamic_cast<broadcastmix::audio::CompiledGraphProcessor*>(compiledGraph.get());
+    assert(compiled != nullptr);
+    compiled->prepareToPlay(playback.sampleRate, playback.blockSize);
+    const auto* originalPlan = &compiled->plan();
+    auto patchedLayout = defaultLayout;
+    patchedLayout.disconnect(defaultLayout.connections().front().fromNodeId, defaultLayout.connections().front().toNodeId);
+    const auto patched = compiledBuilder.applyTopology(patchedLayout, playback);
+    assert(patched && &compiled->plan() != originalPlan);
+    juce::AudioBuffer<float> patchedBlock(playback.numOutputs, playback.blockSize);
+    juce::MidiBuffer patchedMidi;
+    compiled->processBlock(patchedBlock, patchedMidi);
+    compiled->collectGarbage();
+
+    // Both backends apply crosspoint gains and fan out only where a connection asks to: the spot
+    // mic is patched to the right channel alone, the room mic is spread across both.
+    broadcastmix::audio::GraphTopology crosspointLayout;
+    for (const auto* id : { "spot_mic", "room_mic" }) {
+        broadcastmix::audio::GraphNode mic(id, broadcastmix::audio::GraphNodeType::Input);
+        mic.setOutputChannelCount(1);
+        crosspointLayout.addNode(std::move(mic));
+    }
+    broadcastmix::audio::GraphNode crosspointBus("crosspoint_bus", broadcastmix::audio::GraphNodeType::MixBus);
+    crosspointBus.setInputChannelCount(2);
+    crosspointBus.setOutputChannelCount(2);
+    crosspointLayout.addNode(std::move(crosspointBus));
+    broadcastmix::audio::GraphNode crosspointOutput("crosspoint_output", broadcastmix::audio::GraphNodeType::Output);
+    crosspointOutput.setInputChannelCount(2);
+    crosspointLayout.addNode(std::move(crosspointOutput));
+    crosspointLayout.connect({ .fromNodeId = "spot_mic", .toNodeId = "crosspoint_bus", .toChannel = 1, .gain = 0.5F });
+    crosspointLayout.connect({ .fromNodeId = "room_mic", .toNodeId = "crosspoint_bus", .gain = 0.25F, .fanOut = true });
+    for (std::uint32_t channel = 0; channel < 2; ++channel) {
+        crosspointLayout.connect({ .fromNodeId = "crosspoint_bus", .fromChannel = channel, .toNodeId = "crosspoint_output", .toChannel = channel });
+    }
+    const broadcastmix::audio::PlaybackConfiguration crosspointPlayback { .numInputs = 1, .numOutputs = 2 };
+    broadcastmix::audio::JuceGraphBuilder processorGraphBuilder(nullptr);
+    broadcastmix::audio::CompiledGraphBuilder crosspointCompiledBuilder(nullptr);
+    for (auto* builder : std::array<broadcastmix::audio::GraphBuilder*, 2> { &processorGraphBuilder, &crosspointCompiledBuilder }) {
+        auto graph = builder->buildFromTopology(crosspointLayout, crosspointPlayback);
+        graph->prepareToPlay(crosspointPlayback.sampleRate, crosspointPlayback.blockSize);
+        juce::AudioBuffer<float> block(2, crosspointPlayback.blockSize);
+        block.clear();
+        juce::FloatVectorOperations::fill(block.getWritePointer(0), 1.0F, crosspointPlayback.blockSize);
+        juce::MidiBuffer midi;
+        graph->processBlock(block, midi);
+        const auto last = crosspointPlayback.blockSize - 1;
+        assert(std::abs(block.getSample(0, last) - 0.25F) < 1.0e-5F && std::abs(block.getSample(1, last) - 0.75F) < 1.0e-5F);
+
+        // Moving a send level retunes the existing crosspoint instead of rebuilding its edges.
+        auto* processorGraph = dynamic_cast<juce::AudioProcessorGraph*>(graph.get());
+        const auto graphNodeIds = [processorGraph] {
+            std::vector<juce::uint32> ids;
+            if (processorGraph != nullptr) {
+                for (const auto& node : processorGraph->getNodes()) {
+                    ids.push_back(node->nodeID.uid);
+                }
+            }
+            return ids;
+        };
+        const auto nodesBefore = graphNodeIds();
+        auto retunedLayout = crosspointLayout;
+        retunedLayout.disconnect("room_mic", "crosspoint_bus");
+        retunedLayout.connect({ .fromNodeId = "room_mic", .toNodeId = "crosspoint_bus", .gain = 0.5F, .fanOut = true });
+        const auto retuned = builder->applyTopology(retunedLayout, crosspointPlayback);
+        assert(retuned);
+        assert(graphNodeIds() == nodesBefore);
+        for (int pass = 0; pass < 4; ++pass) {
+            block.clear();
+            juce::FloatVectorOperations::fill(block.getWritePointer(0), 1.0F, crosspointPlayback.blockSize);
+            graph->processBlock(block, midi);
+        }
+        assert(std::abs(block.getSample(0, last) - 0.5F) < 1.0e-5F && std::abs(block.getSample(1, last) - 1.0F) < 1.0e-5F);
+        graph->releaseResources();
+    }
+
+    // A headless engine on the virtual device runs its fixed length unclocked and writes every sample out.
+    const auto headlessRoot = fs::temp_directory_path() / "broadcastmix_virtual_device_test";
+    fs::remove_all(headlessRoot);
+    fs::create_directories(headlessRoot);
+    const auto headlessOutput = headlessRoot / "render.wav";
+    broadcastmix::audio::AudioEngineSettings headlessSettings;
+    headlessSettings.inputChannels = 2;
+    headlessSettings.outputChannels = 2;
+    headlessSettings.virtualDevice = broadcastmix::audio::VirtualDeviceSettings {
+        .inputFile = {},
+        .outputFile = headlessOutput.string(),
+        .realtimeClock = false,
+        .lengthInSamples = 4800,
+    };
+    broadcastmix::audio::AudioEngine headlessEngine(headlessSettings);
+    headlessEngine.start();
+    const auto headlessDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!headlessEngine.status().deviceFinished && std::chrono::steady_clock::now() < headlessDeadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    const auto headlessFinished = headlessEngine.status().deviceFinished;
+    headlessEngine.stop();
+    assert(headlessFinished);
+    {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+        const std::unique_ptr<juce::AudioFormatReader> headlessReader(formats.createReaderFor(juce::File(headlessOutput.string())));
+        assert(headlessReader != nullptr);
+        assert(headlessReader->lengthInSamples == 4800 && headlessReader->numChannels == 2);
+    }
+    fs::remove_all(headlessRoot);
+#endif
+
     return 0;
 }
@@ -0,0 +1,252 @@
+// Realtime-safety check: renders the sample project through the engine with allocation,
+// locking and sleeping interposed, and fails if any of them happens inside a
+// RealtimeScope (the device callback, the device-free render path and the worker pool).
+// Every other block is short, and the project gains a strip wider than the 32 channel
+// pointers juce::AudioBuffer keeps inline, so partial-chunk paths are covered too.
+// Interposition relies on glibc exporting its allocator as __libc_* and on symbols in
+// the executable taking precedence, so this target is Linux-only. Set
+// BROADCASTMIX_REALTIME_ABORT to abort at the first violation and get a backtrace.
+
+#include "audio/AudioEngine.h"
+#include "audio/GraphTopology.h"
+#include "audio/RealtimeScope.h"
+#include "persistence/ProjectSerializer.h"
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <numbers>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+enum class Violation : std::size_t {
+    Allocation,
+    Deallocation,
+    Lock,
+    Wait,
+    Sleep,
+};
+
+constexpr std::array<const char*, 5> kViolationNames { "allocation", "deallocation", "mutex lock", "condition wait", "sleep" };
+
+std::array<std::atomic<std::uint64_t>, kViolationNames.size()> violations {};
+std::atomic<bool> abortOnViolation { false };
+
+// Must not allocate, lock or print: it runs inside the interposed calls themselves.
+void check(Violation violation) noexcept {
+    if (!broadcastmix::audio::inRealtimeScope()) {
+        return;
+    }
+    violations[static_cast<std::size_t>(violation)].fetch_add(1, std::memory_order_relaxed);
+    if (abortOnViolation.load(std::memory_order_relaxed)) {
+        std::abort();
+    }
+}
+
+// Resolved on first use rather than at static initialisation, which other translation
+// units may reach first. dlsym itself may allocate, but never inside a realtime scope
+// that has already called the function once.
+template <typename Function>
+Function next(std::atomic<Function>& cache, const char* name) noexcept {
+    auto function = cache.load(std::memory_order_acquire);
+    if (function == nullptr) {
+        function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+        cache.store(function, std::memory_order_release);
+    }
+    return function;
+}
+
+using MutexLock = int (*)(pthread_mutex_t*);
+using ConditionWait = int (*)(pthread_cond_t*, pthread_mutex_t*);
+using ConditionTimedWait = int (*)(pthread_cond_t*, pthread_mutex_t*, const timespec*);
+using NanoSleep = int (*)(const timespec*, timespec*);
+using ClockNanoSleep = int (*)(clockid_t, int, const timespec*, timespec*);
+
+std::atomic<MutexLock> realMutexLock { nullptr };
+std::atomic<ConditionWait> realConditionWait { nullptr };
+std::atomic<ConditionTimedWait> realConditionTimedWait { nullptr };
+std::atomic<NanoSleep> realNanoSleep { nullptr };
+std::atomic<ClockNanoSleep> realClockNanoSleep { nullptr };
+
+} // namespace
+
+extern "C" {
+
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* pointer, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+void __libc_free(void* pointer);
+
+void* malloc(std::size_t size) {
+    check(Violation::Allocation);
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) {
+    check(Violation::Allocation);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, std::size_t size) {
+    check(Violation::Allocation);
+    return __libc_realloc(pointer, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) {
+    check(Violation::Allocation);
+    return __libc_memalign(alignment, size);
+}
+
+void* memalign(std::size_t alignment, std::size_t size) {
+    check(Violation::Allocation);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pointer, std::size_t alignment, std::size_t size) {
+    check(Violation::Allocation);
+    *pointer = __libc_memalign(alignment, size);
+    return *pointer != nullptr || size == 0 ? 0 : ENOMEM;
+}
+
+void free(void* pointer) {
+    if (pointer != nullptr) {
+        check(Violation::Deallocation);
+    }
+    __libc_free(pointer);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    check(Violation::Lock);
+    return next(realMutexLock, "pthread_mutex_lock")(mutex);
+}
+
+int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex) {
+    check(Violation::Wait);
+    return next(realConditionWait, "pthread_cond_wait")(condition, mutex);
+}
+
+int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const timespec* deadline) {
+    check(Violation::Wait);
+    return next(realConditionTimedWait, "pthread_cond_timedwait")(condition, mutex, deadline);
+}
+
+int nanosleep(const timespec* duration, timespec* remaining) {
+    check(Violation::Sleep);
+    return next(realNanoSleep, "nanosleep")(duration, remaining);
+}
+
+int clock_nanosleep(clockid_t clock, int flags, const timespec* duration, timespec* remaining) {
+    check(Violation::Sleep);
+    return next(realClockNanoSleep, "clock_nanosleep")(clock, flags, duration, remaining);
+}
+
+} // extern "C"
+
+namespace {
+
+using namespace broadcastmix::audio;
+
+constexpr std::uint32_t kBlocks = 400;
+constexpr std::uint32_t kWideChannels = 40;
+
+bool renderClean(const GraphTopology& topology, AudioGraphBackend backend, std::uint32_t workerThreads, const char* label) {
+    AudioEngineSettings settings;
+    settings.graphBackend = backend;
+    settings.workerThreads = workerThreads;
+
+    AudioEngine engine(settings);
+    engine.setTopology(std::make_shared<GraphTopology>(topology));
+
+    const auto numSamples = settings.blockSize;
+    std::vector<std::vector<float>> inputs(settings.inputChannels, std::vector<float>(numSamples));
+    std::vector<std::vector<float>> outputs(settings.outputChannels, std::vector<float>(numSamples));
+    std::vector<const float*> inputPointers;
+    std::vector<float*> outputPointers;
+    for (auto& channel : inputs) {
+        inputPointers.push_back(channel.data());
+    }
+    for (auto& channel : outputs) {
+        outputPointers.push_back(channel.data());
+    }
+
+    auto phase = 0.0;
+    const auto increment = 2.0 * std::numbers::pi * 997.0 / static_cast<double>(settings.sampleRate);
+    for (std::uint32_t block = 0; block < kBlocks; ++block) {
+        for (std::uint32_t index = 0; index < numSamples; ++index) {
+            const auto sample = static_cast<float>(0.5 * std::sin(phase));
+            phase += increment;
+            for (auto& channel : inputs) {
+                channel[index] = sample;
+            }
+        }
+
+        // Control-side edits between blocks must reach the render path without it allocating.
+        if (block % 100 == 50) {
+            const auto gain = block % 200 == 50 ? 0.5F : 1.0F;
+            for (const auto& node : topology.nodes()) {
+                (void) engine.setNodeParameter(node.id(), NodeParameter::Gain, gain);
+            }
+        }
+
+        engine.processBlock(inputPointers.data(),
+                            static_cast<std::uint32_t>(inputPointers.size()),
+                            outputPointers.data(),
+                            static_cast<std::uint32_t>(outputPointers.size()),
+                            block % 2 == 0 ? numSamples : numSamples / 3);
+    }
+
+    auto clean = true;
+    for (std::size_t kind = 0; kind < violations.size(); ++kind) {
+        const auto count = violations[kind].exchange(0, std::memory_order_relaxed);
+        if (count > 0) {
+            std::fprintf(stderr, "%s: %llu realtime %s call(s)\n", label, static_cast<unsigned long long>(count), kViolationNames[kind]);
+            clean = false;
+        }
+    }
+    std::printf("%s: %s\n", label, clean ? "clean" : "FAILED");
+    return clean;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    abortOnViolation.store(std::getenv("BROADCASTMIX_REALTIME_ABORT") != nullptr);
+
+    namespace fs = std::filesystem;
+    const auto projectRoot = fs::current_path().parent_path().parent_path();
+    const auto sampleProjectPath = projectRoot / "projects" / "SampleService.broadcastmix";
+
+    broadcastmix::persistence::ProjectSerializer serializer;
+    const auto project = serializer.load(sampleProjectPath.string());
+    if (!project.graphTopology || project.graphTopology->nodes().empty()) {
+        std::fprintf(stderr, "could not load %s\n", sampleProjectPath.string().c_str());
+        return EXIT_FAILURE;
+    }
+    auto topology = *project.graphTopology;
+    GraphNode wideStrip("realtime_wide_strip", GraphNodeType::Channel);
+    wideStrip.setInputChannelCount(kWideChannels);
+    wideStrip.setOutputChannelCount(kWideChannels);
+    topology.addNode(std::move(wideStrip));
+    topology.connect({ .fromNodeId = topology.nodes().front().id(), .toNodeId = "realtime_wide_strip" });
+
+    auto clean = renderClean(topology, AudioGraphBackend::CompiledPlan, 0, "compiled plan");
+    clean = renderClean(topology, AudioGraphBackend::CompiledPlan, 2, "compiled plan, 2 workers") && clean;
+    // juce::AudioProcessorGraph may still rebuild its render sequence from processBlock, so
+    // that backend is only checked on request.
+    if (argc > 1 && std::string_view(argv[1]) == "--processor-graph") {
+        clean = renderClean(topology, AudioGraphBackend::ProcessorGraph, 0, "processor graph") && clean;
+    }
+    return clean ? EXIT_SUCCESS : EXIT_FAILURE;
+}